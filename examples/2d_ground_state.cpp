@@ -5,6 +5,8 @@ constexpr auto GRID_POINTS_X = 128;
 constexpr auto GRID_POINTS_Y = 128;
 constexpr auto GRID_SPACING_X = 0.5;
 constexpr auto GRID_SPACING_Y = 0.5;
+constexpr auto ATOM_NUMBER = 1000.0;
+constexpr auto SAVE_INTERVAL = 50;
 
 Parameters createParams() {
   Parameters params{};
@@ -22,23 +24,20 @@ int main(int argc, char* argv[]) {
   std::tuple<double, double> gridSpacing{GRID_SPACING_X, GRID_SPACING_Y};
   Grid2D grid{points, gridSpacing};
 
-  // Create wavefunction and gaussian initial state
-  complexVector_t initialState(GRID_POINTS_X * GRID_POINTS_Y);
-  for (int i = 0; i < GRID_POINTS_X; ++i) {
-    for (int j = 0; j < GRID_POINTS_Y; ++j) {
-      auto index = j + i * GRID_POINTS_Y;
-      initialState[index] = exp(
-          (-pow(grid.xMesh()[index], 2) - pow(grid.yMesh()[index], 2)) / 500);
-    }
-  }
-  Wavefunction2D wavefunction{grid};
-  wavefunction.setComponent(initialState);
-
   // Create parameters
   Parameters params = createParams();
 
-  // Create data manager
-  DataManager2D dm{"groundState.h5", params, grid};
+  // Create wavefunction, warm started from the Thomas-Fermi state
+  complexVector_t initialState =
+      thomasFermiState(params.trap, params.intStrength, ATOM_NUMBER,
+                       GRID_SPACING_X * GRID_SPACING_Y);
+  Wavefunction2D wavefunction{grid};
+  wavefunction.setComponent(initialState);
+
+  // Create data manager, preallocating one snapshot every SAVE_INTERVAL steps
+  DataOptions options{};
+  options.saveInterval = SAVE_INTERVAL;
+  DataManager2D dm{"groundState.h5", params, grid, options};
 
   // Evolution loop
   auto start = std::chrono::high_resolution_clock::now();
@@ -53,8 +52,8 @@ int main(int argc, char* argv[]) {
       renormaliseAtomNum(wavefunction);
     }
 
-    // Save wavefunction data every 10 time steps
-    if (i % 50 == 0) {
+    // Save wavefunction data every SAVE_INTERVAL time steps
+    if (i % SAVE_INTERVAL == 0) {
       wavefunction.ifft();
       dm.saveWavefunctionData(wavefunction);
     }
@@ -1,10 +1,30 @@
 #ifndef BECPP_H
 #define BECPP_H
 
+#include "accumulator.h"
+#include "cache.h"
+#include "checkpoint.h"
 #include "data.h"
+#include "ensemble.h"
 #include "evolution.h"
 #include "grid.h"
+#include "kernels.h"
+#include "noise.h"
+#include "potential.h"
+#include "projection.h"
+#include "projector.h"
+#include "reader.h"
+#include "groundstate.h"
+#include "spectral.h"
+#include "stochastic.h"
+#include "stream.h"
+#include "trigger.h"
+#include "vortex.h"
 #include "wavefunction.h"
+#ifdef BECPP_USE_MPI
+#include "distributed.h"
+#include "paralleldata.h"
+#endif
 
 /** \mainpage Welcome to BEC++!
  *
@@ -0,0 +1,132 @@
+#ifndef BECPP_ACCUMULATOR_H
+#define BECPP_ACCUMULATOR_H
+
+#include "grid.h"
+#include "wavefunction.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/** Fields of the wave function that can be time-averaged.
+ */
+enum class AccumulatedField {
+  density,         ///< Density |psi|^2, "density"
+  momentumDensity  ///< Momentum distribution |psi(k)|^2, scaled by dV / N
+                   /// so that it sums to the atom number, "momentumDensity".
+                   /// Each axis is reordered so that zero momentum lies at
+                   /// index points / 2, as for the momentum projections.
+};
+
+/** Returns the name of an accumulated field, as used in saved files.
+ *
+ * @param field The accumulated field.
+ */
+std::string accumulatedFieldName(AccumulatedField field);
+
+/** Running time average of fields of the wave function.
+ *
+ * Keeps the running mean, and optionally the variance, of each field with
+ * Welford's algorithm in preallocated arrays. All fields are updated in a
+ * single parallel pass over the grid, so the accumulator can be called every
+ * step of a time loop in place of saving every frame and averaging offline.
+ * Use DataManager1D::saveAccumulatorData and its 2D and 3D counterparts to
+ * write the accumulated result.
+ */
+class FieldAccumulator {
+ private:
+  std::vector<std::size_t> m_shape{};
+  std::vector<AccumulatedField> m_fields{};
+  bool m_variance{};
+  double m_momentumScale{};
+  std::vector<int> m_centredIndices{};
+  std::size_t m_count{0};
+  std::vector<std::vector<double>> m_means{};
+  std::vector<std::vector<double>> m_squares{};
+
+  [[nodiscard]] std::size_t fieldIndex(AccumulatedField field) const;
+  void accumulate(const complexVector_t& component,
+                  const complexVector_t& fourierComponent);
+
+ public:
+  /** Constructs the accumulator for a 1D grid.
+   *
+   * @param grid The 1D grid object of the system.
+   * @param fields The fields to average.
+   * @param variance If true, the variance of each field is kept as well.
+   */
+  FieldAccumulator(const Grid1D& grid, std::vector<AccumulatedField> fields,
+                   bool variance = true);
+
+  /** Constructs the accumulator for a 2D grid.
+   *
+   * @param grid The 2D grid object of the system.
+   * @param fields The fields to average.
+   * @param variance If true, the variance of each field is kept as well.
+   */
+  FieldAccumulator(const Grid2D& grid, std::vector<AccumulatedField> fields,
+                   bool variance = true);
+
+  /** Constructs the accumulator for a 3D grid.
+   *
+   * @param grid The 3D grid object of the system.
+   * @param fields The fields to average.
+   * @param variance If true, the variance of each field is kept as well.
+   */
+  FieldAccumulator(const Grid3D& grid, std::vector<AccumulatedField> fields,
+                   bool variance = true);
+
+  /** Adds the current state of a 1D wave function to the averages. Both the
+   * position and Fourier space vectors must be up to date for the fields
+   * using them.
+   *
+   * @param wfn The 1D wavefunction object.
+   */
+  void accumulate(Wavefunction1D& wfn);
+
+  /** Adds the current state of a 2D wave function to the averages.
+   *
+   * @param wfn The 2D wavefunction object.
+   */
+  void accumulate(Wavefunction2D& wfn);
+
+  /** Adds the current state of a 3D wave function to the averages.
+   *
+   * @param wfn The 3D wavefunction object.
+   */
+  void accumulate(Wavefunction3D& wfn);
+
+  /** Discards all accumulated samples.
+   */
+  void reset();
+
+  /** Returns the running mean of a field.
+   *
+   * @param field The accumulated field.
+   */
+  [[nodiscard]] const std::vector<double>& mean(AccumulatedField field) const;
+
+  /** Returns the population variance of a field, zero until two samples are
+   * accumulated.
+   *
+   * @param field The accumulated field. Its variance must be kept.
+   */
+  [[nodiscard]] std::vector<double> variance(AccumulatedField field) const;
+
+  /** Returns the number of accumulated samples.
+   */
+  [[nodiscard]] std::size_t count() const;
+
+  /** Returns whether the variance is kept.
+   */
+  [[nodiscard]] bool keepsVariance() const;
+
+  /** Returns the accumulated fields.
+   */
+  [[nodiscard]] const std::vector<AccumulatedField>& fields() const;
+
+  /** Returns the shape of the grid of the accumulated fields.
+   */
+  [[nodiscard]] const std::vector<std::size_t>& shape() const;
+};
+
+#endif  // BECPP_ACCUMULATOR_H
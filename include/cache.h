@@ -0,0 +1,152 @@
+#ifndef BECPP_CACHE_H
+#define BECPP_CACHE_H
+
+#include "data.h"
+#include "groundstate.h"
+#include "grid.h"
+#include "wavefunction.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/** Struct identifying a converged ground state.
+ *
+ * Two keys with equal hashes describe the same system, converged to the same
+ * tolerance, so the stored state can be reused as is.
+ */
+struct GroundStateKey {
+  std::vector<unsigned int> shape{};   ///< Number of grid points per axis
+  std::vector<double> gridSpacing{};   ///< Grid spacing per axis
+  std::uint64_t trapHash{};            ///< Hash of the trapping potential
+  double intStrength{};                ///< Interaction strength
+  double atomNumber{};                 ///< Atom number of the state
+  double tolerance{};                  ///< Convergence tolerance
+
+  /** Returns the hash of the full key.
+   */
+  [[nodiscard]] std::uint64_t hash() const;
+
+  /** Returns true if the other key has the same grid and trap, in which case
+   * its state is a valid warm start for this key.
+   */
+  [[nodiscard]] bool sameSystem(const GroundStateKey& other) const;
+};
+
+/** Creates the ground state key of a 1D system.
+ *
+ * @param grid The 1D grid object of the system.
+ * @param params Struct containing the parameters of the system.
+ * @param atomNumber The atom number of the ground state.
+ * @param tolerance The convergence tolerance of the ground state.
+ */
+GroundStateKey makeGroundStateKey(const Grid1D& grid, const Parameters& params,
+                                  double atomNumber, double tolerance);
+
+/** Creates the ground state key of a 2D system.
+ *
+ * @param grid The 2D grid object of the system.
+ * @param params Struct containing the parameters of the system.
+ * @param atomNumber The atom number of the ground state.
+ * @param tolerance The convergence tolerance of the ground state.
+ */
+GroundStateKey makeGroundStateKey(const Grid2D& grid, const Parameters& params,
+                                  double atomNumber, double tolerance);
+
+/** Creates the ground state key of a 3D system.
+ *
+ * @param grid The 3D grid object of the system.
+ * @param params Struct containing the parameters of the system.
+ * @param atomNumber The atom number of the ground state.
+ * @param tolerance The convergence tolerance of the ground state.
+ */
+GroundStateKey makeGroundStateKey(const Grid3D& grid, const Parameters& params,
+                                  double atomNumber, double tolerance);
+
+/** Computes the Thomas-Fermi state of a trapped condensate.
+ *
+ * The chemical potential is found by bisection such that the state holds the
+ * requested atom number. For non-repulsive interactions the Thomas-Fermi
+ * approximation does not apply, and a normalised exp(-V) profile is returned
+ * instead, which is exact for the harmonic oscillator.
+ *
+ * @param trap The trapping potential.
+ * @param intStrength The interaction strength.
+ * @param atomNumber The atom number of the state.
+ * @param cellVolume The volume of a single grid cell.
+ */
+complexVector_t thomasFermiState(const std::vector<double>& trap,
+                                 double intStrength, double atomNumber,
+                                 double cellVolume);
+
+/** On-disk cache of converged ground states.
+ *
+ * Each state is stored in its own .h5 file inside the cache directory, named
+ * after the hash of its key. Files are written to a temporary name first and
+ * then renamed, so concurrent jobs sharing a cache never read partial files.
+ */
+class GroundStateCache {
+ private:
+  std::string m_directory;
+
+  [[nodiscard]] std::string path(const GroundStateKey& key) const;
+  [[nodiscard]] std::vector<std::pair<GroundStateKey, std::string>> entries()
+      const;
+
+ public:
+  /** Constructs the cache, creating the directory if it does not exist.
+   *
+   * @param directory The directory holding the cached states.
+   */
+  explicit GroundStateCache(std::string directory);
+
+  /** Returns true if a state is stored for the key.
+   */
+  [[nodiscard]] bool contains(const GroundStateKey& key) const;
+
+  /** Loads the state stored for the key, if any.
+   */
+  [[nodiscard]] std::optional<complexVector_t> load(
+      const GroundStateKey& key) const;
+
+  /** Stores a converged state under the key.
+   *
+   * @param key The key of the state.
+   * @param state The position space wave function.
+   */
+  void store(const GroundStateKey& key, const complexVector_t& state) const;
+
+  /** Returns the best available initial state for the key.
+   *
+   * An exact match is returned as is. Otherwise, cached states of the same
+   * grid and trap are used: two states bracketing the interaction energy
+   * scale (intStrength x atomNumber) are linearly interpolated, or else the
+   * nearest one is taken. Without any such state, the Thomas-Fermi state is
+   * returned. The result is normalised to the atom number of the key.
+   *
+   * @param key The key of the wanted state.
+   * @param trap The trapping potential of the system.
+   * @param cellVolume The volume of a single grid cell.
+   */
+  [[nodiscard]] complexVector_t warmStart(const GroundStateKey& key,
+                                          const std::vector<double>& trap,
+                                          double cellVolume) const;
+};
+
+/** Finds the ground state of a 3D system, using the cache where possible.
+ *
+ * A cached state is loaded directly, skipping the imaginary time evolution.
+ * Otherwise the evolution starts from GroundStateCache::warmStart, and the
+ * converged state is stored for later runs.
+ *
+ * @param wfn The 3D wavefunction object. On return it holds the ground state.
+ * @param params Struct containing the parameters of the system.
+ * @param atomNumber The atom number of the ground state.
+ * @param options The convergence options.
+ * @param cache The ground state cache.
+ */
+void cachedGroundState(Wavefunction3D& wfn, const Parameters& params,
+                       double atomNumber, const GroundStateOptions& options,
+                       const GroundStateCache& cache);
+
+#endif  // BECPP_CACHE_H
@@ -0,0 +1,138 @@
+#ifndef BECPP_CHECKPOINT_H
+#define BECPP_CHECKPOINT_H
+
+#include "data.h"
+#include "wavefunction.h"
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/** Struct containing the state of a run besides the wave function and
+ * parameters, needed to resume it from a checkpoint.
+ */
+struct CheckpointState {
+  int step{};                ///< Index of the next time step to perform
+  bool fourierSpace{false};  ///< True if the Fourier space vector is current
+  std::size_t numSnapshots{};  ///< Number of snapshots saved by the
+                               /// DataManager, used to resume appending
+  std::vector<std::uint64_t> rngState{};  ///< State of the random number
+                                          /// generator, if any
+  std::map<std::string, std::size_t> numRecords{};  ///< Number of records
+                                                    /// of each time series,
+                                                    /// region and probe,
+                                                    /// used to resume them
+};
+
+/** Decides when to write a checkpoint.
+ *
+ * A checkpoint is due once the wall-clock interval has elapsed since the last
+ * one, or as soon as SIGTERM or SIGUSR1 is received. The signal handlers only
+ * set a flag, which is checked by due() between time steps, so a checkpoint
+ * is never written from inside a signal handler. After SIGTERM, stopRequested()
+ * stays true so the run can exit cleanly once the checkpoint is written.
+ * Only one trigger should exist at a time; previous handlers are restored on
+ * destruction.
+ */
+class CheckpointTrigger {
+ private:
+  std::chrono::steady_clock::duration m_interval;
+  std::chrono::steady_clock::time_point m_last;
+  void (*m_previousTerm)(int){};
+  void (*m_previousUsr1)(int){};
+
+ public:
+  /** Installs the signal handlers and starts the wall-clock interval.
+   *
+   * @param interval Wall-clock time between checkpoints.
+   */
+  explicit CheckpointTrigger(std::chrono::steady_clock::duration interval);
+
+  /** Restores the previous signal handlers.
+   */
+  ~CheckpointTrigger();
+
+  CheckpointTrigger(const CheckpointTrigger&) = delete;
+  CheckpointTrigger& operator=(const CheckpointTrigger&) = delete;
+
+  /** Returns true if a checkpoint is due, and restarts the interval if so.
+   */
+  [[nodiscard]] bool due();
+
+  /** Returns true if SIGTERM has been received.
+   */
+  [[nodiscard]] bool stopRequested() const;
+};
+
+/** Writes a 1D checkpoint.
+ *
+ * The file is written under a temporary name and renamed once complete, so a
+ * job killed mid-write leaves the previous checkpoint intact. The wave
+ * function is stored unchunked, in a single contiguous write. Call
+ * DataManager1D::flush() first, so the snapshots and records it reports are
+ * on disk.
+ *
+ * @param filename The name of the checkpoint file.
+ * @param wfn The 1D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param state The remaining state of the run.
+ */
+void writeCheckpoint(const std::string& filename, Wavefunction1D& wfn,
+                     const Parameters& params, const CheckpointState& state);
+
+/** Writes a 2D checkpoint.
+ *
+ * @param filename The name of the checkpoint file.
+ * @param wfn The 2D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param state The remaining state of the run.
+ */
+void writeCheckpoint(const std::string& filename, Wavefunction2D& wfn,
+                     const Parameters& params, const CheckpointState& state);
+
+/** Writes a 3D checkpoint.
+ *
+ * @param filename The name of the checkpoint file.
+ * @param wfn The 3D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param state The remaining state of the run.
+ */
+void writeCheckpoint(const std::string& filename, Wavefunction3D& wfn,
+                     const Parameters& params, const CheckpointState& state);
+
+/** Restores a 1D run from a checkpoint.
+ *
+ * The wave function is read into the vector of the space it was saved in, the
+ * other vector is updated with an FFT, and the atom number the run was
+ * normalised to is restored. To keep appending to the output of the run,
+ * construct the DataManager with DataOptions::resumeSnapshots and
+ * DataOptions::resumeRecords set to the returned numSnapshots and numRecords.
+ *
+ * @param filename The name of the checkpoint file.
+ * @param wfn The 1D wavefunction object, on the same grid as the checkpoint.
+ * @param params Struct receiving the parameters of the system.
+ */
+CheckpointState readCheckpoint(const std::string& filename,
+                               Wavefunction1D& wfn, Parameters& params);
+
+/** Restores a 2D run from a checkpoint.
+ *
+ * @param filename The name of the checkpoint file.
+ * @param wfn The 2D wavefunction object, on the same grid as the checkpoint.
+ * @param params Struct receiving the parameters of the system.
+ */
+CheckpointState readCheckpoint(const std::string& filename,
+                               Wavefunction2D& wfn, Parameters& params);
+
+/** Restores a 3D run from a checkpoint.
+ *
+ * @param filename The name of the checkpoint file.
+ * @param wfn The 3D wavefunction object, on the same grid as the checkpoint.
+ * @param params Struct receiving the parameters of the system.
+ */
+CheckpointState readCheckpoint(const std::string& filename,
+                               Wavefunction3D& wfn, Parameters& params);
+
+#endif  // BECPP_CHECKPOINT_H
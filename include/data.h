@@ -1,12 +1,28 @@
 #ifndef BECPP_DATA_H
 #define BECPP_DATA_H
 
+#include "accumulator.h"
 #include "grid.h"
 #include "highfive/H5DataSet.hpp"
 #include "highfive/H5DataSpace.hpp"
 #include "highfive/H5File.hpp"
+#include "highfive/H5PropertyList.hpp"
+#include "projection.h"
+#include "spectral.h"
 #include "wavefunction.h"
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 /** Struct containing all the parameters of the system.
@@ -19,6 +35,530 @@ struct Parameters {
   double currentTime{};             ///< Current time of the simulation
 };
 
+/** Fields of the wave function that can be saved with each snapshot.
+ */
+enum class OutputField {
+  wavefunction,       ///< Complex double wave function, "wavefunction"
+  wavefunctionFloat,  ///< Complex float wave function, "wavefunctionFloat"
+  density,            ///< Float density |psi|^2, "density"
+  phase               ///< Float phase arg(psi), "phase"
+};
+
+/** Struct containing the options of the save system.
+ */
+struct DataOptions {
+  int saveInterval{1};  ///< Number of time steps between saves, used to
+                        /// preallocate the snapshot datasets
+  std::size_t chunkBytes{1 << 20};  ///< Target size of a dataset chunk
+  std::size_t chunkCacheBytes{64 << 20};  ///< Maximum size of the chunk cache
+                                          /// of each dataset
+  int deflateLevel{0};  ///< Deflate level of the snapshot datasets from 1 to
+                        /// 9, or 0 to store them uncompressed
+  int mantissaBits{52};  ///< Mantissa bits of doubles kept when compressing.
+                         /// Fewer bits round the data, which compresses
+                         /// better, and 52 keeps it lossless.
+  std::vector<OutputField> fields{
+      OutputField::wavefunction};  ///< Fields saved with each snapshot
+  std::size_t writeBuffers{0};  ///< Number of staging buffers of the
+                                /// asynchronous writer. The default of 0
+                                /// writes synchronously; with buffers,
+                                /// call flush() before reading the file.
+  std::optional<std::size_t> resumeSnapshots{};  ///< Number of snapshots
+                                                 /// already saved in an
+                                                 /// existing file to resume.
+                                                 /// Left empty, a new file
+                                                 /// is created.
+  std::map<std::string, std::size_t> resumeRecords{};  ///< Number of records
+                                                       /// of each time series,
+                                                       /// region and probe at
+                                                       /// the checkpoint
+                                                       /// resumed, keyed by
+                                                       /// dataset path. Rows
+                                                       /// after them are
+                                                       /// discarded, as are
+                                                       /// outputs not listed.
+  unsigned int downsampling{1};  ///< Factor by which the grid of the saved
+                                 /// snapshots is coarsened, keeping only the
+                                 /// central Fourier modes that fit on it
+  bool fourierOutput{false};  ///< Saves the Fourier space vector of each
+                              /// snapshot, in FFTW ordering, instead of the
+                              /// position space one
+  std::size_t ringBufferSnapshots{0};  ///< Number of recent snapshots kept in
+                                       /// memory by bufferWavefunctionData,
+                                       /// saved when an event is triggered
+  std::size_t postEventSnapshots{0};  ///< Number of snapshots saved directly
+                                      /// by bufferWavefunctionData after an
+                                      /// event is triggered
+  int ringBufferDeflateLevel{0};  ///< Deflate level of the snapshots kept in
+                                  /// memory from 1 to 9, or 0 to keep them
+                                  /// uncompressed
+  std::size_t keyframeInterval{0};  ///< Number of snapshots between full
+                                    /// keyframes of the "wavefunction"
+                                    /// field, with the snapshots in between
+                                    /// stored as deltas. 0 stores every
+                                    /// snapshot in full.
+};
+
+/** Extendible dataset holding one snapshot per saved time.
+ *
+ * Snapshots are stored natively as a (t, x, y, z) dataset, with the spatial
+ * dimensions matching the grid. Chunks hold a single time and a tile of the
+ * grid, found by halving the largest spatial dimension until the chunk fits
+ * in DataOptions::chunkBytes. Saving a snapshot thus writes whole chunks, and
+ * reading a plane or a single time only touches the chunks it intersects. The
+ * time extent is preallocated, grown geometrically if exceeded, and trimmed
+ * to the number of saved snapshots on destruction. Until then, the number of
+ * saved snapshots is kept in the "numSnapshots" attribute of the dataset,
+ * updated on every append, so a file read during a run, or left by a killed
+ * run, does not expose the zero frames of the preallocated extent.
+ *
+ * Compressed datasets use the standard shuffle and deflate filters, so any
+ * HDF5 reader can decode them. Rather than letting HDF5 run the filters
+ * serially inside the write, the chunks of a snapshot are compressed in
+ * parallel by OpenMP threads and written directly with H5Dwrite_chunk.
+ */
+class SnapshotDataSet {
+ private:
+  std::vector<std::size_t> m_shape{};
+  std::vector<std::size_t> m_chunk{};
+  std::size_t m_elementBytes{};
+  int m_deflateLevel{};
+  int m_mantissaBits{};
+  HighFive::DataSet m_dataSet;
+  std::size_t m_size{0};
+  std::size_t m_capacity{};
+
+  void writeCompressed(const void* data, bool isDouble);
+  void writeSize();
+
+ public:
+  /** Creates the dataset in the file.
+   *
+   * @param file The file to create the dataset in.
+   * @param name The name of the dataset.
+   * @param shape The spatial shape of a single snapshot.
+   * @param dataType The HDF5 datatype of the stored values.
+   * @param capacity The number of snapshots to preallocate.
+   * @param options The options of the save system.
+   */
+  SnapshotDataSet(HighFive::File& file, const std::string& name,
+                  const std::vector<std::size_t>& shape,
+                  const HighFive::DataType& dataType, std::size_t capacity,
+                  const DataOptions& options);
+
+  /** Opens an existing dataset to append to, as when resuming a run.
+   *
+   * The shape, chunking and compression are read from the dataset. Snapshots
+   * past the given size, e.g. saved after the last checkpoint, are
+   * overwritten.
+   *
+   * @param file The file containing the dataset.
+   * @param name The name of the dataset.
+   * @param dataType The HDF5 datatype of the stored values.
+   * @param size The number of snapshots to keep.
+   * @param options The options of the save system.
+   */
+  SnapshotDataSet(HighFive::File& file, const std::string& name,
+                  const HighFive::DataType& dataType, std::size_t size,
+                  const DataOptions& options);
+
+  /** Trims the time extent to the number of saved snapshots.
+   */
+  ~SnapshotDataSet();
+
+  SnapshotDataSet(const SnapshotDataSet&) = delete;
+  SnapshotDataSet& operator=(const SnapshotDataSet&) = delete;
+
+  /** Appends a snapshot at the next time index.
+   *
+   * @param data Pointer to a contiguous snapshot of the spatial shape.
+   */
+  template <typename T>
+  void append(const T* data) {
+    reserve(m_size + 1);
+    if (m_deflateLevel > 0) {
+      writeCompressed(data, std::is_same_v<T, double> ||
+                                std::is_same_v<T, std::complex<double>>);
+    } else {
+      m_dataSet.select(offset(m_size), count()).write_raw(data);
+    }
+    m_size += 1;
+    writeSize();
+  }
+
+  /** Grows the time extent to hold at least the given number of snapshots.
+   */
+  void reserve(std::size_t capacity);
+
+  /** Returns the offset of the snapshot at a time index.
+   */
+  [[nodiscard]] std::vector<std::size_t> offset(std::size_t index) const;
+
+  /** Returns the count of a single snapshot, {1, x, y, z}.
+   */
+  [[nodiscard]] std::vector<std::size_t> count() const;
+
+  /** Returns the number of saved snapshots.
+   */
+  [[nodiscard]] std::size_t size() const;
+
+  /** Returns a reference to the underlying HDF5 dataset.
+   */
+  [[nodiscard]] HighFive::DataSet& dataSet();
+};
+
+/** Set of snapshot datasets, one per saved field of the wave function.
+ *
+ * Reduced-precision and derived fields are converted from the wave function
+ * in parallel while saving, so only the converted data is written.
+ *
+ * With DataOptions::keyframeInterval set, the "wavefunction" field is
+ * delta-encoded. Every keyframeInterval-th snapshot is a keyframe stored in
+ * full, and each snapshot in between stores the XOR of its bits with those
+ * of the previous snapshot. Slowly varying snapshots share their sign,
+ * exponent and leading mantissa bits, so the deltas are mostly zero bits,
+ * which the shuffle and deflate filters compress far better than the
+ * snapshots themselves. Values are rounded to DataOptions::mantissaBits
+ * before encoding, which zeroes the noisy low bits in lossy mode. Use
+ * readDeltaSnapshot, or DataReader, to decode them.
+ */
+class SnapshotFields {
+ private:
+  std::vector<OutputField> m_fields{};
+  std::vector<std::unique_ptr<SnapshotDataSet>> m_dataSets{};
+  std::vector<float> m_realBuffer{};
+  std::vector<std::complex<float>> m_complexBuffer{};
+  std::size_t m_keyframeInterval{};
+  int m_mantissaBits{};
+  std::size_t m_index{};
+  complexVector_t m_previous{};
+  complexVector_t m_delta{};
+
+  const complexVector_t& encodeDelta(const complexVector_t& snapshot);
+
+ public:
+  /** Creates a dataset in the file for each field of the options, or opens
+   * the existing ones when DataOptions::resumeSnapshots is set.
+   *
+   * @param file The file to create the datasets in.
+   * @param shape The spatial shape of a single snapshot.
+   * @param capacity The number of snapshots to preallocate.
+   * @param options The options of the save system.
+   */
+  SnapshotFields(HighFive::File& file, const std::vector<std::size_t>& shape,
+                 std::size_t capacity, const DataOptions& options);
+
+  SnapshotFields(const SnapshotFields&) = delete;
+  SnapshotFields& operator=(const SnapshotFields&) = delete;
+
+  /** Converts the wave function to each field and appends it to its dataset.
+   *
+   * @param snapshot The position space wave function.
+   */
+  void append(const complexVector_t& snapshot);
+};
+
+/** Reads a region of a snapshot of a delta-encoded "wavefunction" dataset,
+ * decoding it from the nearest preceding keyframe.
+ *
+ * @param dataSet The delta-encoded dataset.
+ * @param index The index of the snapshot.
+ * @param keyframeInterval The number of snapshots between keyframes.
+ * @param offset The first grid index of the region along each axis.
+ * @param count The size of the region along each axis.
+ */
+complexVector_t readDeltaSnapshot(const HighFive::DataSet& dataSet,
+                                  std::size_t index,
+                                  std::size_t keyframeInterval,
+                                  const std::vector<std::size_t>& offset,
+                                  const std::vector<std::size_t>& count);
+
+/** Asynchronous writer draining snapshots to disk on a dedicated I/O thread.
+ *
+ * Snapshots are copied into one of a fixed pool of staging buffers and
+ * queued, so the compute thread continues as soon as the copy is done. The
+ * I/O thread writes queued buffers in order and returns them to the pool.
+ * When every buffer is in flight, push() blocks until one is written, which
+ * bounds both the memory used and how far compute can run ahead of the disk.
+ *
+ * All HDF5 calls on the file must go through the writer while snapshots are
+ * pending, as the HDF5 library is not thread-safe in general. An exception
+ * thrown by a write is rethrown by the next call to push() or flush().
+ */
+class SnapshotWriter {
+ public:
+  using WriteFunction = std::function<void(const complexVector_t&)>;
+
+ private:
+  WriteFunction m_write;
+  std::vector<complexVector_t> m_free{};
+  std::deque<complexVector_t> m_queue{};
+  bool m_writing{false};
+  bool m_stop{false};
+  std::exception_ptr m_error{};
+  std::mutex m_mutex{};
+  std::condition_variable m_queued{};
+  std::condition_variable m_written{};
+  std::thread m_thread;
+
+  void run();
+  void rethrowError();
+
+ public:
+  /** Constructs the writer and starts its I/O thread.
+   *
+   * @param numBuffers The number of staging buffers, at least 1.
+   * @param write Function writing a single snapshot, called on the I/O thread.
+   */
+  SnapshotWriter(std::size_t numBuffers, WriteFunction write);
+
+  /** Writes all pending snapshots and stops the I/O thread.
+   */
+  ~SnapshotWriter();
+
+  SnapshotWriter(const SnapshotWriter&) = delete;
+  SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+  /** Copies the snapshot into a staging buffer and queues it for writing,
+   * waiting for a free buffer if all of them are in flight.
+   *
+   * @param snapshot The snapshot to write.
+   */
+  void push(const complexVector_t& snapshot);
+
+  /** Waits until every queued snapshot has been written.
+   */
+  void flush();
+};
+
+/** Region-of-interest and point-probe outputs, saved at high cadence.
+ *
+ * Each output gathers a fixed set of grid points from the wave function,
+ * either a hyperslab of the grid or a list of probe points, and stores one
+ * record per call to record() in an extendible (t, ...) dataset. Records are
+ * buffered in memory until a chunk of DataOptions::chunkBytes is filled, and
+ * then written as a single block, so an output saved every step costs only a
+ * gather and an occasional large write.
+ */
+class RegionOutputs {
+ private:
+  struct Output {
+    std::string name{};
+    HighFive::DataSet dataSet;
+    std::vector<std::size_t> shape{};
+    std::vector<std::size_t> indices{};
+    std::size_t blockLength{};
+    complexVector_t buffer{};
+    std::size_t buffered{};
+    std::size_t size{};
+  };
+
+  HighFive::File& m_file;
+  std::vector<std::size_t> m_gridShape{};
+  std::size_t m_chunkBytes{};
+  std::vector<Output> m_outputs{};
+  std::map<std::string, std::size_t> m_resumed{};
+
+  void addOutput(const std::string& name,
+                 const std::vector<std::size_t>& shape,
+                 std::vector<std::size_t> indices);
+
+ public:
+  /** Constructs an empty set of outputs. When resuming, as set by
+   * DataOptions::resumeSnapshots, the existing regions and probes are first
+   * cut back to DataOptions::resumeRecords, so records written after the
+   * checkpoint are not kept twice.
+   *
+   * @param file The file to create the datasets in.
+   * @param gridShape The shape of the grid of the wave function.
+   * @param options The options of the save system.
+   */
+  RegionOutputs(HighFive::File& file, std::vector<std::size_t> gridShape,
+                const DataOptions& options);
+
+  /** Writes the buffered records.
+   */
+  ~RegionOutputs();
+
+  RegionOutputs(const RegionOutputs&) = delete;
+  RegionOutputs& operator=(const RegionOutputs&) = delete;
+
+  /** Adds a hyperslab of the grid, saved to /regions/<name>. If the dataset
+   * already exists, as when resuming a run, records are appended to it.
+   *
+   * @param name The name of the region.
+   * @param offset The first grid index of the region along each axis.
+   * @param count The size of the region along each axis.
+   */
+  void addRegion(const std::string& name,
+                 const std::vector<std::size_t>& offset,
+                 const std::vector<std::size_t>& count);
+
+  /** Adds a list of probe points, saved to /probes/<name>.
+   *
+   * @param name The name of the set of probes.
+   * @param points The grid indices of each point, one per axis.
+   */
+  void addProbes(const std::string& name,
+                 const std::vector<std::vector<std::size_t>>& points);
+
+  /** Gathers a record of every output from the wave function.
+   *
+   * @param component The position space wave function.
+   * @return Whether the buffer of any output is full and should be written.
+   */
+  bool record(const complexVector_t& component);
+
+  /** Writes the buffered records of every output.
+   */
+  void write();
+
+  /** Returns the number of records of each output, keyed by dataset path,
+   * including buffered ones and those of a resumed run.
+   */
+  [[nodiscard]] std::map<std::string, std::size_t> numRecords() const;
+};
+
+/** Named scalar and small-vector observables recorded every step, such as the
+ * atom number or energy.
+ *
+ * Each series is buffered in memory, and appended in blocks filling a chunk
+ * of DataOptions::chunkBytes to an extendible dataset /timeseries/<name>, of
+ * shape (t) for scalars and (t, n) for vectors of n values. Recording is a
+ * copy into the buffer and never calls HDF5, so observables can be recorded
+ * every step at negligible cost.
+ */
+class TimeSeriesOutputs {
+ private:
+  struct Series {
+    std::optional<HighFive::DataSet> dataSet{};
+    std::vector<std::size_t> shape{};
+    std::size_t width{};
+    std::size_t blockLength{};
+    std::vector<double> buffer{};
+    std::size_t buffered{};
+    std::size_t size{};
+  };
+
+  HighFive::File& m_file;
+  std::size_t m_chunkBytes{};
+  std::map<std::string, Series> m_series{};
+  std::map<std::string, std::size_t> m_resumed{};
+
+ public:
+  /** Constructs an empty set of time series. When resuming, as set by
+   * DataOptions::resumeSnapshots, the existing series are first cut back to
+   * DataOptions::resumeRecords, so records written after the checkpoint are
+   * not kept twice.
+   *
+   * @param file The file to create the datasets in.
+   * @param options The options of the save system.
+   */
+  TimeSeriesOutputs(HighFive::File& file, const DataOptions& options);
+
+  /** Writes the buffered records.
+   */
+  ~TimeSeriesOutputs();
+
+  TimeSeriesOutputs(const TimeSeriesOutputs&) = delete;
+  TimeSeriesOutputs& operator=(const TimeSeriesOutputs&) = delete;
+
+  /** Buffers a record of a series, starting the series on its first record.
+   * If its dataset already exists, as when resuming a run, records are
+   * appended to the resumed ones.
+   *
+   * @param name The name of the series.
+   * @param values Pointer to the values of the record.
+   * @param width The number of values, fixed for the series.
+   * @param scalar If true, the series holds single values, stored as (t).
+   * @return Whether the buffer of the series is full and should be written.
+   */
+  bool record(const std::string& name, const double* values,
+              std::size_t width, bool scalar);
+
+  /** Writes the buffered records of every series.
+   */
+  void write();
+
+  /** Returns the number of records of each series, keyed by dataset path,
+   * including buffered ones and those of a resumed run.
+   */
+  [[nodiscard]] std::map<std::string, std::size_t> numRecords() const;
+};
+
+/** Ring buffer keeping the most recent snapshots in memory.
+ *
+ * Once full, each new snapshot overwrites the oldest one, so the buffer
+ * always holds the frames leading up to the present. Frames are optionally
+ * compressed losslessly, with the bytes shuffled as by the HDF5 shuffle
+ * filter and deflated in independent blocks by OpenMP threads.
+ */
+class SnapshotRingBuffer {
+ private:
+  struct Frame {
+    std::vector<std::vector<unsigned char>> blocks{};
+    std::size_t size{};
+    double time{};
+  };
+
+  std::vector<Frame> m_frames{};
+  int m_deflateLevel{};
+  std::size_t m_first{0};
+  std::size_t m_size{0};
+  complexVector_t m_snapshot{};
+
+  void store(const complexVector_t& snapshot, Frame& frame);
+  void load(const Frame& frame);
+
+ public:
+  /** Constructs an empty ring buffer.
+   *
+   * @param capacity The number of snapshots kept.
+   * @param deflateLevel The deflate level from 1 to 9, or 0 to keep the
+   * snapshots uncompressed.
+   */
+  SnapshotRingBuffer(std::size_t capacity, int deflateLevel);
+
+  SnapshotRingBuffer(const SnapshotRingBuffer&) = delete;
+  SnapshotRingBuffer& operator=(const SnapshotRingBuffer&) = delete;
+
+  /** Adds a snapshot, overwriting the oldest one if the buffer is full.
+   *
+   * @param snapshot The snapshot.
+   * @param time The simulation time of the snapshot.
+   */
+  void push(const complexVector_t& snapshot, double time);
+
+  /** Passes every kept snapshot to a function, oldest first, and empties the
+   * buffer.
+   *
+   * @param save Function called with each snapshot and its time.
+   */
+  void drain(
+      const std::function<void(const complexVector_t&, double)>& save);
+
+  /** Returns the number of kept snapshots.
+   */
+  [[nodiscard]] std::size_t size() const;
+};
+
+/** Saves the options needed to read the snapshots back, such as
+ * DataOptions::keyframeInterval, to /parameters.
+ *
+ * @param file The file to save the options to.
+ * @param options The options of the save system.
+ */
+void saveOutputParameters(HighFive::File& file, const DataOptions& options);
+
+/** Returns the number of snapshots expected from a run, used to preallocate
+ * the output. At least one snapshot is always reserved.
+ *
+ * @param params The struct containing the system parameters.
+ * @param options The options of the save system.
+ */
+std::size_t snapshotCapacity(const Parameters& params,
+                             const DataOptions& options);
+
 /** DataManager class that handles all the details of the save system of BEC++.
  * It automatically creates the appropriate datasets upon construction of the
  * object, and saves the initial details of the parameters and numerical grid.
@@ -27,30 +567,149 @@ struct Parameters {
  */
 class DataManager1D {
  private:
-  unsigned int m_saveIndex{0};
-
-  void saveParameters(const Parameters& params, const Grid1D& grid);
-  void generateWavefunctionDatasets(const Grid1D& grid);
+  void saveParameters(const Parameters& params, const Grid1D& grid,
+                      const DataOptions& options);
+  SnapshotFields generateWavefunctionDatasets(const Parameters& params,
+                                              const Grid1D& grid,
+                                              const DataOptions& options);
+  const complexVector_t& snapshotData(Wavefunction1D& wfn);
+  void saveSnapshot(const complexVector_t& snapshot);
+  void saveTimedSnapshot(const complexVector_t& snapshot, double time);
+  void writeBufferedData();
 
  public:
   /** Constructs the DataManager object. It automatically saves and creates the
-   * datasets for the wave function, numerical grid, and parameters.
+   * datasets for the wave function, numerical grid, and parameters. If
+   * DataOptions::resumeSnapshots is set, the existing file is opened instead
+   * and new snapshots are appended after the resumed ones.
    *
    * @param filename The desired name of the file.
    * @param params The struct containing the system parameters.
    * @param grid The 1D grid object of the system.
+   * @param options The options of the save system.
    */
   DataManager1D(const std::string& filename, const Parameters& params,
-                const Grid1D& grid);
+                const Grid1D& grid, const DataOptions& options = {});
 
-  /** Saves the current wave function data to the file.
+  /** Saves the current wave function data to the file. If
+   * DataOptions::writeBuffers is above 0, the data is written asynchronously
+   * and is only guaranteed to be in the file after flush(). If
+   * DataOptions::downsampling is above 1, the snapshot is taken from the
+   * Fourier space vector and only the coarse grid is transformed back.
    *
    * @param wfn The Wavefunction object of the system.
+   * @throws std::logic_error If snapshots are buffered for events instead.
    */
   void saveWavefunctionData(Wavefunction1D& wfn);
 
+  /** Keeps the current wave function data in the in-memory ring buffer of
+   * the last DataOptions::ringBufferSnapshots snapshots, to be saved only if
+   * an event is triggered. Call at the save cadence in place of
+   * saveWavefunctionData. After an event, the next
+   * DataOptions::postEventSnapshots calls save directly instead. The time of
+   * each saved snapshot is recorded in /timeseries/snapshotTime.
+   *
+   * @param wfn The Wavefunction object of the system.
+   * @param time The simulation time of the snapshot.
+   */
+  void bufferWavefunctionData(Wavefunction1D& wfn, double time);
+
+  /** Triggers an event, e.g. when a ThresholdTrigger or ChangeTrigger fires.
+   * The buffered pre-event snapshots are saved, oldest first, and the
+   * following DataOptions::postEventSnapshots buffered calls are saved as
+   * well. The time of the event is recorded in /timeseries/eventTime.
+   *
+   * @param time The simulation time of the event.
+   */
+  void triggerEvent(double time);
+
+  /** Registers a region of interest, a hyperslab of the grid saved to
+   * /regions/<name> by saveRegionData.
+   *
+   * @param name The name of the region.
+   * @param offset The first grid index of the region along each axis.
+   * @param count The size of the region along each axis.
+   */
+  void addRegion(const std::string& name,
+                 const std::vector<std::size_t>& offset,
+                 const std::vector<std::size_t>& count);
+
+  /** Registers a list of probe points, saved to /probes/<name> by
+   * saveRegionData.
+   *
+   * @param name The name of the set of probes.
+   * @param points The grid indices of each point, one per axis.
+   */
+  void addProbes(const std::string& name,
+                 const std::vector<std::vector<std::size_t>>& points);
+
+  /** Saves a record of every registered region and probe list. Records are
+   * buffered and written in blocks, so this is cheap enough to call every
+   * step. The position space vector is used as is, without an inverse FFT.
+   *
+   * @param wfn The Wavefunction object of the system.
+   */
+  void saveRegionData(Wavefunction1D& wfn);
+
+  /** Saves the current result of a field accumulator to
+   * /accumulators/<field>/mean and /accumulators/<field>/variance, with the
+   * number of samples in /accumulators/count. Earlier results are
+   * overwritten, so this can be called at intervals or once at the end of
+   * the run.
+   *
+   * @param accumulator The field accumulator.
+   */
+  void saveAccumulatorData(const FieldAccumulator& accumulator);
+
+  /** Records the value of a scalar observable, e.g. the atom number, saved to
+   * /timeseries/<name>. Values are buffered and written in blocks, so this
+   * is cheap enough to call every step.
+   *
+   * @param name The name of the observable.
+   * @param value The current value.
+   */
+  void recordScalar(const std::string& name, double value);
+
+  /** Records the values of a small vector observable, saved to
+   * /timeseries/<name> as one row per record.
+   *
+   * @param name The name of the observable.
+   * @param values The current values, of the same number every record.
+   */
+  void recordSeries(const std::string& name,
+                    const std::vector<double>& values);
+
+  /** Waits until all saved data has been written, including buffered region
+   * and time series records, and flushes the file to disk. Must be called
+   * before accessing the file directly while saves are pending.
+   */
+  void flush();
+
+  /** Returns the number of snapshots saved to the file, including those of
+   * a resumed run.
+   */
+  [[nodiscard]] std::size_t numSnapshots() const;
+
+  /** Returns the number of records of each time series, region and probe
+   * output, keyed by dataset path and including those of a resumed run, to
+   * be passed back as DataOptions::resumeRecords.
+   */
+  [[nodiscard]] std::map<std::string, std::size_t> numRecords() const;
+
   std::string filename;  ///< Filename of the .hdf5 file
   HighFive::File file;   ///< Reference to the underlying .hdf5 file.
+
+ private:
+  std::unique_ptr<SpectralDownsampler1D> m_downsampler;
+  bool m_fourierOutput;
+  SnapshotFields m_snapshots;
+  RegionOutputs m_regions;
+  TimeSeriesOutputs m_timeSeries;
+  std::unique_ptr<SnapshotRingBuffer> m_ringBuffer;
+  std::size_t m_postEventSnapshots;
+  std::size_t m_remainingEventSnapshots{0};
+  std::unique_ptr<SnapshotWriter> m_writer{};
+  std::size_t m_numSnapshots{};
 };
 
 /** DataManager class that handles all the details of the save system of BEC++.
@@ -61,31 +720,150 @@ class DataManager1D {
  */
 class DataManager2D {
  private:
-  unsigned int m_saveIndex{0};
-
-  void saveParameters(const Parameters& params, const Grid2D& grid);
-  void generateWavefunctionDatasets(const Grid2D& grid);
+  void saveParameters(const Parameters& params, const Grid2D& grid,
+                      const DataOptions& options);
+  SnapshotFields generateWavefunctionDatasets(const Parameters& params,
+                                              const Grid2D& grid,
+                                              const DataOptions& options);
+  const complexVector_t& snapshotData(Wavefunction2D& wfn);
+  void saveSnapshot(const complexVector_t& snapshot);
+  void saveTimedSnapshot(const complexVector_t& snapshot, double time);
+  void writeBufferedData();
 
  public:
   /** Constructs the DataManager object. It automatically saves and creates the
-   * datasets for the wave function, numerical grid, and parameters.
+   * datasets for the wave function, numerical grid, and parameters. If
+   * DataOptions::resumeSnapshots is set, the existing file is opened instead
+   * and new snapshots are appended after the resumed ones.
    *
    * @param filename The desired name of the file.
    * @param params The struct containing the system parameters.
    * @param grid The 2D grid object of the system.
+   * @param options The options of the save system.
    */
   DataManager2D(const std::string& filename, const Parameters& params,
-                const Grid2D& grid);
+                const Grid2D& grid, const DataOptions& options = {});
 
-  /** Saves the current wave function data to the file.
+  /** Saves the current wave function data to the file. If
+   * DataOptions::writeBuffers is above 0, the data is written asynchronously
+   * and is only guaranteed to be in the file after flush(). If
+   * DataOptions::downsampling is above 1, the snapshot is taken from the
+   * Fourier space vector and only the coarse grid is transformed back.
    *
    * @param wfn The Wavefunction object of the system.
+   * @throws std::logic_error If snapshots are buffered for events instead.
    */
   void saveWavefunctionData(Wavefunction2D& wfn);
 
+  /** Keeps the current wave function data in the in-memory ring buffer of
+   * the last DataOptions::ringBufferSnapshots snapshots, to be saved only if
+   * an event is triggered. Call at the save cadence in place of
+   * saveWavefunctionData. After an event, the next
+   * DataOptions::postEventSnapshots calls save directly instead. The time of
+   * each saved snapshot is recorded in /timeseries/snapshotTime.
+   *
+   * @param wfn The Wavefunction object of the system.
+   * @param time The simulation time of the snapshot.
+   */
+  void bufferWavefunctionData(Wavefunction2D& wfn, double time);
+
+  /** Triggers an event, e.g. when a ThresholdTrigger or ChangeTrigger fires.
+   * The buffered pre-event snapshots are saved, oldest first, and the
+   * following DataOptions::postEventSnapshots buffered calls are saved as
+   * well. The time of the event is recorded in /timeseries/eventTime.
+   *
+   * @param time The simulation time of the event.
+   */
+  void triggerEvent(double time);
+
+  /** Registers a region of interest, a hyperslab of the grid saved to
+   * /regions/<name> by saveRegionData.
+   *
+   * @param name The name of the region.
+   * @param offset The first grid index of the region along each axis.
+   * @param count The size of the region along each axis.
+   */
+  void addRegion(const std::string& name,
+                 const std::vector<std::size_t>& offset,
+                 const std::vector<std::size_t>& count);
+
+  /** Registers a list of probe points, saved to /probes/<name> by
+   * saveRegionData.
+   *
+   * @param name The name of the set of probes.
+   * @param points The grid indices of each point, one per axis.
+   */
+  void addProbes(const std::string& name,
+                 const std::vector<std::vector<std::size_t>>& points);
+
+  /** Saves a record of every registered region and probe list. Records are
+   * buffered and written in blocks, so this is cheap enough to call every
+   * step. The position space vector is used as is, without an inverse FFT.
+   *
+   * @param wfn The Wavefunction object of the system.
+   */
+  void saveRegionData(Wavefunction2D& wfn);
+
+  /** Saves the current result of a field accumulator to
+   * /accumulators/<field>/mean and /accumulators/<field>/variance, with the
+   * number of samples in /accumulators/count. Earlier results are
+   * overwritten, so this can be called at intervals or once at the end of
+   * the run.
+   *
+   * @param accumulator The field accumulator.
+   */
+  void saveAccumulatorData(const FieldAccumulator& accumulator);
+
+  /** Records the value of a scalar observable, e.g. the atom number, saved to
+   * /timeseries/<name>. Values are buffered and written in blocks, so this
+   * is cheap enough to call every step.
+   *
+   * @param name The name of the observable.
+   * @param value The current value.
+   */
+  void recordScalar(const std::string& name, double value);
+
+  /** Records the values of a small vector observable, saved to
+   * /timeseries/<name> as one row per record.
+   *
+   * @param name The name of the observable.
+   * @param values The current values, of the same number every record.
+   */
+  void recordSeries(const std::string& name,
+                    const std::vector<double>& values);
+
+  /** Waits until all saved data has been written, including buffered region
+   * and time series records, and flushes the file to disk. Must be called
+   * before accessing the file directly while saves are pending.
+   */
+  void flush();
+
+  /** Returns the number of snapshots saved to the file, including those of
+   * a resumed run.
+   */
+  [[nodiscard]] std::size_t numSnapshots() const;
+
+  /** Returns the number of records of each time series, region and probe
+   * output, keyed by dataset path and including those of a resumed run, to
+   * be passed back as DataOptions::resumeRecords.
+   */
+  [[nodiscard]] std::map<std::string, std::size_t> numRecords() const;
+
   std::string filename;  ///< Filename of the .hdf5 file
 
   HighFive::File file;  ///< Reference to the underlying .hdf5 file.
+
+ private:
+  std::unique_ptr<SpectralDownsampler2D> m_downsampler;
+  bool m_fourierOutput;
+  SnapshotFields m_snapshots;
+  RegionOutputs m_regions;
+  TimeSeriesOutputs m_timeSeries;
+  std::unique_ptr<SnapshotRingBuffer> m_ringBuffer;
+  std::size_t m_postEventSnapshots;
+  std::size_t m_remainingEventSnapshots{0};
+  std::unique_ptr<SnapshotWriter> m_writer{};
+  std::size_t m_numSnapshots{};
 };
 
 /** DataManager class that handles all the details of the save system of BEC++.
@@ -96,31 +874,189 @@ class DataManager2D {
  */
 class DataManager3D {
  private:
-  unsigned int m_saveIndex{0};
+  void saveParameters(const Parameters& params, const Grid3D& grid,
+                      const DataOptions& options);
+  SnapshotFields generateWavefunctionDatasets(const Parameters& params,
+                                              const Grid3D& grid,
+                                              const DataOptions& options);
+  const complexVector_t& snapshotData(Wavefunction3D& wfn);
+  void saveSnapshot(const complexVector_t& snapshot);
+  void saveTimedSnapshot(const complexVector_t& snapshot, double time);
+  void saveProjections(Wavefunction3D& wfn, bool positionSpace);
+  void addProjection(const std::string& name, unsigned int axis,
+                     bool momentum);
+  void writeBufferedData();
 
-  void saveParameters(const Parameters& params, const Grid3D& grid);
-  void generateWavefunctionDatasets(const Grid3D& grid);
+  struct Projection {
+    unsigned int axis{};
+    bool momentum{};
+    std::unique_ptr<SnapshotDataSet> dataSet{};
+  };
 
  public:
   /** Constructs the DataManager object. It automatically saves and creates the
-   * datasets for the wave function, numerical grid, and parameters.
+   * datasets for the wave function, numerical grid, and parameters. If
+   * DataOptions::resumeSnapshots is set, the existing file is opened instead
+   * and new snapshots are appended after the resumed ones.
    *
    * @param filename The desired name of the file.
    * @param params The struct containing the system parameters.
    * @param grid The 3D grid object of the system.
+   * @param options The options of the save system.
    */
   DataManager3D(const std::string& filename, const Parameters& params,
-                const Grid3D& grid);
+                const Grid3D& grid, const DataOptions& options = {});
 
-  /** Saves the current wave function data to the file.
+  /** Saves the current wave function data to the file. If
+   * DataOptions::writeBuffers is above 0, the data is written asynchronously
+   * and is only guaranteed to be in the file after flush(). If
+   * DataOptions::downsampling is above 1, the snapshot is taken from the
+   * Fourier space vector and only the coarse grid is transformed back.
    *
    * @param wfn The Wavefunction object of the system.
+   * @throws std::logic_error If snapshots are buffered for events instead.
    */
   void saveWavefunctionData(Wavefunction3D& wfn);
 
+  /** Keeps the current wave function data in the in-memory ring buffer of
+   * the last DataOptions::ringBufferSnapshots snapshots, to be saved only if
+   * an event is triggered. Call at the save cadence in place of
+   * saveWavefunctionData. After an event, the next
+   * DataOptions::postEventSnapshots calls save directly instead. The time of
+   * each saved snapshot is recorded in /timeseries/snapshotTime.
+   *
+   * @param wfn The Wavefunction object of the system.
+   * @param time The simulation time of the snapshot.
+   */
+  void bufferWavefunctionData(Wavefunction3D& wfn, double time);
+
+  /** Triggers an event, e.g. when a ThresholdTrigger or ChangeTrigger fires.
+   * The buffered pre-event snapshots are saved, oldest first, and the
+   * following DataOptions::postEventSnapshots buffered calls are saved as
+   * well. The time of the event is recorded in /timeseries/eventTime.
+   *
+   * @param time The simulation time of the event.
+   */
+  void triggerEvent(double time);
+
+  /** Registers a region of interest, a hyperslab of the grid saved to
+   * /regions/<name> by saveRegionData.
+   *
+   * @param name The name of the region.
+   * @param offset The first grid index of the region along each axis.
+   * @param count The size of the region along each axis.
+   */
+  void addRegion(const std::string& name,
+                 const std::vector<std::size_t>& offset,
+                 const std::vector<std::size_t>& count);
+
+  /** Registers a list of probe points, saved to /probes/<name> by
+   * saveRegionData.
+   *
+   * @param name The name of the set of probes.
+   * @param points The grid indices of each point, one per axis.
+   */
+  void addProbes(const std::string& name,
+                 const std::vector<std::vector<std::size_t>>& points);
+
+  /** Saves a record of every registered region and probe list. Records are
+   * buffered and written in blocks, so this is cheap enough to call every
+   * step. The position space vector is used as is, without an inverse FFT.
+   *
+   * @param wfn The Wavefunction object of the system.
+   */
+  void saveRegionData(Wavefunction3D& wfn);
+
+  /** Saves the current result of a field accumulator to
+   * /accumulators/<field>/mean and /accumulators/<field>/variance, with the
+   * number of samples in /accumulators/count. Earlier results are
+   * overwritten, so this can be called at intervals or once at the end of
+   * the run.
+   *
+   * @param accumulator The field accumulator.
+   */
+  void saveAccumulatorData(const FieldAccumulator& accumulator);
+
+  /** Records the value of a scalar observable, e.g. the atom number, saved to
+   * /timeseries/<name>. Values are buffered and written in blocks, so this
+   * is cheap enough to call every step.
+   *
+   * @param name The name of the observable.
+   * @param value The current value.
+   */
+  void recordScalar(const std::string& name, double value);
+
+  /** Records the values of a small vector observable, saved to
+   * /timeseries/<name> as one row per record.
+   *
+   * @param name The name of the observable.
+   * @param values The current values, of the same number every record.
+   */
+  void recordSeries(const std::string& name,
+                    const std::vector<double>& values);
+
+  /** Registers an in-situ column density, the density integrated along one
+   * axis, saved to /projections/density<X|Y|Z> with every snapshot. Only the
+   * 2D result is written, so with DataOptions::fields left empty a run
+   * saves a fraction of the full 3D output. Must be called before the first
+   * snapshot is saved.
+   *
+   * @param axis The axis integrated along, 0 for x, 1 for y, 2 for z.
+   */
+  void addColumnDensity(unsigned int axis);
+
+  /** Registers a column momentum distribution, the image of the column
+   * density after a long ballistic time of flight, saved to
+   * /projections/momentum<X|Y|Z> with every snapshot. It is computed from the
+   * Fourier space vector without any FFT, with zero momentum at the centre.
+   * The spacing of the image is saved to
+   * /projections/momentum<X|Y|Z>GridSpacing. Must be called before the first
+   * snapshot is saved.
+   *
+   * @param axis The axis integrated along, 0 for x, 1 for y, 2 for z.
+   * @param timeOfFlight The time of flight t. Momentum k is imaged at position
+   * k t, which sets the saved spacing. If 0, the spacing is that of momentum
+   * space.
+   */
+  void addMomentumDensity(unsigned int axis, double timeOfFlight = 0.0);
+
+  /** Waits until all saved data has been written, including buffered region
+   * and time series records, and flushes the file to disk. Must be called
+   * before accessing the file directly while saves are pending.
+   */
+  void flush();
+
+  /** Returns the number of snapshots saved to the file, including those of
+   * a resumed run.
+   */
+  [[nodiscard]] std::size_t numSnapshots() const;
+
+  /** Returns the number of records of each time series, region and probe
+   * output, keyed by dataset path and including those of a resumed run, to
+   * be passed back as DataOptions::resumeRecords.
+   */
+  [[nodiscard]] std::map<std::string, std::size_t> numRecords() const;
+
   std::string filename;  ///< Filename of the .hdf5 file
 
   HighFive::File file;  ///< Reference to the underlying .hdf5 file.
+
+ private:
+  std::unique_ptr<SpectralDownsampler3D> m_downsampler;
+  bool m_fourierOutput;
+  SnapshotFields m_snapshots;
+  RegionOutputs m_regions;
+  TimeSeriesOutputs m_timeSeries;
+  std::unique_ptr<SnapshotRingBuffer> m_ringBuffer;
+  std::size_t m_postEventSnapshots;
+  std::size_t m_remainingEventSnapshots{0};
+  DataOptions m_options;
+  std::size_t m_capacity;
+  std::vector<std::size_t> m_gridShape;
+  std::vector<double> m_fourierGridSpacing;
+  std::vector<Projection> m_projections{};
+  std::unique_ptr<SnapshotWriter> m_writer{};
+  std::size_t m_numSnapshots{};
 };
 
 #endif  // BECPP_DATA_H
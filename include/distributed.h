@@ -0,0 +1,229 @@
+#ifndef BECPP_DISTRIBUTED_H
+#define BECPP_DISTRIBUTED_H
+
+#include "evolution.h"
+#include "grid.h"
+#include "wavefunction.h"
+#include <mpi.h>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+/** The 3D Grid class of a system distributed over MPI ranks.
+ *
+ * The grid is split into slabs along x in position space, as laid out by
+ * FFTW-MPI. The FFTs keep their output transposed, so that in Fourier space
+ * each rank instead holds a slab along y, with its local modes ordered as
+ * (y, x, z). This saves the all-to-all that would transpose the modes back,
+ * and the pointwise kernels are unaffected, as the wavenumber mesh uses the
+ * same transposed layout. Each rank only stores the meshes of its own slabs,
+ * so the grid is not limited by the memory of a single node. Only available
+ * when built with BECPP_USE_MPI.
+ */
+class DistributedGrid3D : public Grid {
+ private:
+  void constructGridParams() override;
+  void constructMesh() override;
+
+  MPI_Comm m_comm;
+  const std::tuple<unsigned int, unsigned int, unsigned int> m_gridPoints{};
+  const std::tuple<double, double, double> m_gridSpacing{};
+  std::tuple<double, double, double> m_fourierGridSpacing{};
+  std::tuple<double, double, double> m_gridLength{};
+  std::size_t m_localSize{};
+  std::size_t m_localXStart{};
+  std::size_t m_localXPoints{};
+  std::size_t m_localYStart{};
+  std::size_t m_localYPoints{};
+  std::vector<double> m_xMesh{};
+  std::vector<double> m_yMesh{};
+  std::vector<double> m_zMesh{};
+  std::vector<double> m_wavenumber{};
+
+ public:
+  /** Collectively constructs the distributed 3D grid object.
+   *
+   * @param comm The communicator of the ranks sharing the grid.
+   * @param points Tuple containing desired (xPoints, yPoints, zPoints) of the
+   * whole grid
+   * @param gridSpacing Tuple containing desired (xGridSpacing, yGridSpacing,
+   * zGridSpacing)
+   */
+  DistributedGrid3D(MPI_Comm comm,
+                    std::tuple<unsigned int, unsigned int, unsigned int> points,
+                    std::tuple<double, double, double> gridSpacing);
+  ~DistributedGrid3D() override = default;
+
+  /** Returns the communicator of the ranks sharing the grid.
+   */
+  [[nodiscard]] MPI_Comm communicator() const;
+
+  /** Returns the shape of the whole grid as a tuple of (xPoints, yPoints,
+   * zPoints).
+   */
+  [[nodiscard]] std::tuple<unsigned int, unsigned int, unsigned int>
+  shape() const;
+
+  /** Returns the position space grid spacings as a tuple.
+   */
+  [[nodiscard]] std::tuple<double, double, double> gridSpacing() const;
+
+  /** Returns the Fourier space grid spacings as a tuple.
+   */
+  [[nodiscard]] std::tuple<double, double, double> fourierGridSpacing() const;
+
+  /** Returns the lengths of the position space grids as a tuple.
+   */
+  [[nodiscard]] std::tuple<double, double, double> gridLength() const;
+
+  /** Returns the first x index of the position space slab of this rank.
+   */
+  [[nodiscard]] std::size_t localXStart() const;
+
+  /** Returns the number of x points of the position space slab of this rank.
+   */
+  [[nodiscard]] std::size_t localXPoints() const;
+
+  /** Returns the first y index of the Fourier space slab of this rank.
+   */
+  [[nodiscard]] std::size_t localYStart() const;
+
+  /** Returns the number of y points of the Fourier space slab of this rank.
+   */
+  [[nodiscard]] std::size_t localYPoints() const;
+
+  /** Returns the number of grid points of the position space slab of this
+   * rank, localXPoints * yPoints * zPoints.
+   */
+  [[nodiscard]] std::size_t localPoints() const;
+
+  /** Returns the number of complex values each rank allocates for the FFTs,
+   * which may exceed the number of points of either slab.
+   */
+  [[nodiscard]] std::size_t localSize() const;
+
+  /** Returns a reference to the xMesh of the position space slab.
+   */
+  [[nodiscard]] std::vector<double>& xMesh();
+
+  /** Returns a reference to the yMesh of the position space slab.
+   */
+  [[nodiscard]] std::vector<double>& yMesh();
+
+  /** Returns a reference to the zMesh of the position space slab.
+   */
+  [[nodiscard]] std::vector<double>& zMesh();
+
+  /** Returns a reference to the wavenumber mesh of the Fourier space slab, in
+   * the transposed (y, x, z) layout.
+   */
+  [[nodiscard]] std::vector<double>& wavenumber();
+};
+
+/** 3D wave function class of a system distributed over MPI ranks.
+ *
+ * Each rank holds the slab of the position space vector given by its grid,
+ * and the transposed slab of the Fourier space vector. The FFTs are
+ * collective, and must be called by all ranks together. Only available when
+ * built with BECPP_USE_MPI.
+ */
+class DistributedWavefunction3D {
+ private:
+  DistributedGrid3D& m_grid;
+  FFTPlans m_plans{};
+  complexVector_t m_component{};
+  complexVector_t m_fourierComponent{};
+  double m_atomNumber{};
+
+  void createFFTPlans(DistributedGrid3D& grid);
+  void destroyFFTPlans() const;
+  void updateAtomNumber();
+
+ public:
+  /** Collectively constructs the wave function object from the associated
+   * grid object.
+   *
+   * @param grid The distributed 3D grid object of the system.
+   */
+  explicit DistributedWavefunction3D(DistributedGrid3D& grid);
+
+  /** Destructor that automatically cleans up stored FFT plans.
+   */
+  ~DistributedWavefunction3D();
+
+  DistributedWavefunction3D(const DistributedWavefunction3D&) = delete;
+  DistributedWavefunction3D& operator=(const DistributedWavefunction3D&) =
+      delete;
+
+  /** Returns a reference to the grid object of the system.
+   */
+  [[nodiscard]] DistributedGrid3D& grid() const;
+
+  /** Returns a reference to the position space vector of this rank. Its first
+   * localPoints() values are the slab, with z running fastest.
+   */
+  [[nodiscard]] complexVector_t& component();
+
+  /** Returns a reference to the Fourier space vector of this rank, in the
+   * transposed (y, x, z) layout of the wavenumber mesh.
+   */
+  [[nodiscard]] complexVector_t& fourierComponent();
+
+  /** Returns a vector of the density of the position space slab.
+   */
+  [[nodiscard]] std::vector<double> density() const;
+
+  /** Returns the atom number of the whole system, as of the last call to
+   * setComponent.
+   */
+  [[nodiscard]] double atomNumber() const;
+
+  /** Performs a collective forward FFT, updating the Fourier space vector
+   * from the position space vector.
+   */
+  void fft() const;
+
+  /** Performs a collective inverse FFT, updating and normalising the position
+   * space vector.
+   */
+  void ifft();
+
+  /** Collectively sets the position space slab of this rank, and updates the
+   * Fourier space vector and atom number.
+   *
+   * @param component The values of the slab, of size localPoints().
+   */
+  void setComponent(complexVector_t& component);
+};
+
+/** Computes the Fourier step of the evolution of a distributed 3D system.
+ *
+ * Runs the same pointwise kernel as the serial overloads on the local
+ * Fourier space slab.
+ *
+ * @param wfn The distributed 3D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ */
+void fourierStep(DistributedWavefunction3D& wfn, const Parameters& params);
+
+/** Computes the non-linear step of the evolution of a distributed 3D system.
+ *
+ * @param wfn The distributed 3D wavefunction object.
+ * @param params Struct containing the parameters of the system. Its trap
+ * holds the trapping potential of the local position space slab only.
+ */
+void interactionStep(DistributedWavefunction3D& wfn, const Parameters& params);
+
+/** Collectively calculates the atom number of the whole system.
+ *
+ * @param wfn The distributed 3D wavefunction object.
+ */
+double calculateAtomNum(const DistributedWavefunction3D& wfn);
+
+/** Collectively renormalises the atom number of the whole system.
+ *
+ * @param wfn The distributed 3D wavefunction object.
+ */
+void renormaliseAtomNum(DistributedWavefunction3D& wfn);
+
+#endif  // BECPP_DISTRIBUTED_H
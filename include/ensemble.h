@@ -0,0 +1,253 @@
+#ifndef BECPP_ENSEMBLE_H
+#define BECPP_ENSEMBLE_H
+
+#include "evolution.h"
+#include "grid.h"
+#include "projector.h"
+#include "wavefunction.h"
+#include <vector>
+
+/** Ensemble of realisations of a 1D wave function, as sampled in
+ * truncated-Wigner simulations.
+ *
+ * The realisations are stored one after the other in a single vector, and
+ * are all transformed by one batched FFT plan. The evolution steps run their
+ * kernels across the whole batch in one parallel loop, so an ensemble of
+ * small systems keeps every core busy, where evolving separate
+ * Wavefunction1D objects would run many tiny, poorly parallelised FFTs.
+ */
+class EnsembleWavefunction1D {
+ private:
+  Grid1D& m_grid;
+  unsigned int m_numRealisations;
+  FFTPlans m_plans{};
+  complexVector_t m_component{};
+  complexVector_t m_fourierComponent{};
+
+  void createFFTPlans(const Grid1D& grid);
+  void destroyFFTPlans() const;
+
+ public:
+  /** Constructs the ensemble from the associated grid object.
+   *
+   * @param grid The 1D grid object of the system.
+   * @param numRealisations The number of realisations of the ensemble.
+   */
+  EnsembleWavefunction1D(Grid1D& grid, unsigned int numRealisations);
+
+  /** Destructor that automatically cleans up stored FFT plans.
+   */
+  ~EnsembleWavefunction1D();
+
+  EnsembleWavefunction1D(const EnsembleWavefunction1D&) = delete;
+  EnsembleWavefunction1D& operator=(const EnsembleWavefunction1D&) = delete;
+
+  /** Returns a reference to the grid object of the system.
+   */
+  [[nodiscard]] Grid1D& grid() const;
+
+  /** Returns the number of realisations of the ensemble.
+   */
+  [[nodiscard]] unsigned int numRealisations() const;
+
+  /** Returns a reference to the position space vector of the whole ensemble,
+   * with realisation m occupying the points from m * xPoints.
+   */
+  [[nodiscard]] complexVector_t& component();
+
+  /** Returns a reference to the Fourier space vector of the whole ensemble,
+   * laid out as the position space vector.
+   */
+  [[nodiscard]] complexVector_t& fourierComponent();
+
+  /** Returns a copy of the position space vector of a single realisation.
+   *
+   * @param realisation The index of the realisation.
+   */
+  [[nodiscard]] complexVector_t realisation(unsigned int realisation) const;
+
+  /** Sets the position space vector of a single realisation. Call fft() once
+   * all realisations are set, so that the whole batch is transformed at once.
+   *
+   * @param realisation The index of the realisation.
+   * @param component The wave function state of the realisation.
+   */
+  void setRealisation(unsigned int realisation,
+                      const complexVector_t& component);
+
+  /** Returns the density of a single realisation.
+   *
+   * @param realisation The index of the realisation.
+   */
+  [[nodiscard]] std::vector<double> density(unsigned int realisation) const;
+
+  /** Returns the density averaged over the ensemble.
+   */
+  [[nodiscard]] std::vector<double> meanDensity() const;
+
+  /** Returns the atom number of every realisation.
+   */
+  [[nodiscard]] std::vector<double> atomNumbers() const;
+
+  /** Returns the atom number averaged over the ensemble.
+   */
+  [[nodiscard]] double meanAtomNumber() const;
+
+  /** Performs a forward FFT of every realisation with a single batched plan.
+   */
+  void fft() const;
+
+  /** Performs an inverse FFT of every realisation with a single batched plan,
+   * and normalises the result.
+   */
+  void ifft();
+};
+
+/** Ensemble of realisations of a 2D wave function.
+ *
+ * See EnsembleWavefunction1D for details.
+ */
+class EnsembleWavefunction2D {
+ private:
+  Grid2D& m_grid;
+  unsigned int m_numRealisations;
+  FFTPlans m_plans{};
+  complexVector_t m_component{};
+  complexVector_t m_fourierComponent{};
+
+  void createFFTPlans(const Grid2D& grid);
+  void destroyFFTPlans() const;
+
+ public:
+  /** Constructs the ensemble from the associated grid object.
+   *
+   * @param grid The 2D grid object of the system.
+   * @param numRealisations The number of realisations of the ensemble.
+   */
+  EnsembleWavefunction2D(Grid2D& grid, unsigned int numRealisations);
+
+  /** Destructor that automatically cleans up stored FFT plans.
+   */
+  ~EnsembleWavefunction2D();
+
+  EnsembleWavefunction2D(const EnsembleWavefunction2D&) = delete;
+  EnsembleWavefunction2D& operator=(const EnsembleWavefunction2D&) = delete;
+
+  /** Returns a reference to the grid object of the system.
+   */
+  [[nodiscard]] Grid2D& grid() const;
+
+  /** Returns the number of realisations of the ensemble.
+   */
+  [[nodiscard]] unsigned int numRealisations() const;
+
+  /** Returns a reference to the position space vector of the whole ensemble,
+   * with realisation m occupying the points from m * xPoints * yPoints.
+   */
+  [[nodiscard]] complexVector_t& component();
+
+  /** Returns a reference to the Fourier space vector of the whole ensemble,
+   * laid out as the position space vector.
+   */
+  [[nodiscard]] complexVector_t& fourierComponent();
+
+  /** Returns a copy of the position space vector of a single realisation.
+   *
+   * @param realisation The index of the realisation.
+   */
+  [[nodiscard]] complexVector_t realisation(unsigned int realisation) const;
+
+  /** Sets the position space vector of a single realisation. Call fft() once
+   * all realisations are set.
+   *
+   * @param realisation The index of the realisation.
+   * @param component The wave function state of the realisation.
+   */
+  void setRealisation(unsigned int realisation,
+                      const complexVector_t& component);
+
+  /** Returns the density of a single realisation.
+   *
+   * @param realisation The index of the realisation.
+   */
+  [[nodiscard]] std::vector<double> density(unsigned int realisation) const;
+
+  /** Returns the density averaged over the ensemble.
+   */
+  [[nodiscard]] std::vector<double> meanDensity() const;
+
+  /** Returns the atom number of every realisation.
+   */
+  [[nodiscard]] std::vector<double> atomNumbers() const;
+
+  /** Returns the atom number averaged over the ensemble.
+   */
+  [[nodiscard]] double meanAtomNumber() const;
+
+  /** Performs a forward FFT of every realisation with a single batched plan.
+   */
+  void fft() const;
+
+  /** Performs an inverse FFT of every realisation with a single batched plan,
+   * and normalises the result.
+   */
+  void ifft();
+};
+
+/** Computes the Fourier step of the evolution of every realisation of a 1D
+ * ensemble.
+ *
+ * @param wfn The 1D ensemble.
+ * @param params Struct containing the parameters of the system.
+ */
+void fourierStep(EnsembleWavefunction1D& wfn, const Parameters& params);
+
+/** Computes the Fourier step of the evolution of every realisation of a 2D
+ * ensemble.
+ *
+ * @param wfn The 2D ensemble.
+ * @param params Struct containing the parameters of the system.
+ */
+void fourierStep(EnsembleWavefunction2D& wfn, const Parameters& params);
+
+/** Computes the projected Fourier step of the evolution of every realisation
+ * of a 1D ensemble.
+ *
+ * @param wfn The 1D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @param projector The projector of the grid of the ensemble.
+ */
+void fourierStep(EnsembleWavefunction1D& wfn, const Parameters& params,
+                 const Projector& projector);
+
+/** Computes the projected Fourier step of the evolution of every realisation
+ * of a 2D ensemble.
+ *
+ * @param wfn The 2D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @param projector The projector of the grid of the ensemble.
+ */
+void fourierStep(EnsembleWavefunction2D& wfn, const Parameters& params,
+                 const Projector& projector);
+
+/** Computes the non-linear step of the evolution of every realisation of a 1D
+ * ensemble. All realisations share the trap of the parameters.
+ *
+ * @param wfn The 1D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
+ */
+void interactionStep(EnsembleWavefunction1D& wfn, const Parameters& params);
+
+/** Computes the non-linear step of the evolution of every realisation of a 2D
+ * ensemble.
+ *
+ * @param wfn The 2D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
+ */
+void interactionStep(EnsembleWavefunction2D& wfn, const Parameters& params);
+
+#endif  // BECPP_ENSEMBLE_H
@@ -2,6 +2,8 @@
 #define BECPP_EVOLUTION_H
 
 #include "data.h"
+#include "potential.h"
+#include "projector.h"
 #include "wavefunction.h"
 #include <complex>
 
@@ -34,12 +36,51 @@ void fourierStep(Wavefunction2D& wfn, const Parameters& params);
  */
 void fourierStep(Wavefunction3D& wfn, const Parameters& params);
 
+/** Computes the Fourier step of the projected evolution.
+ *
+ * The modes outside the projector are zeroed within the kinetic multiply, so
+ * projected and dealiased runs cost the same as unprojected ones.
+ *
+ * @param wfn The 1D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param projector The projector of the grid of the wave function.
+ * @throws std::invalid_argument If the projector was built for another grid.
+ */
+void fourierStep(Wavefunction1D& wfn, const Parameters& params,
+                 const Projector& projector);
+
+/** Computes the Fourier step of the projected evolution.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param projector The projector of the grid of the wave function.
+ * @throws std::invalid_argument If the projector was built for another grid.
+ */
+void fourierStep(Wavefunction2D& wfn, const Parameters& params,
+                 const Projector& projector);
+
+/** Computes the Fourier step of the projected evolution.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param projector The projector of the grid of the wave function.
+ * @throws std::invalid_argument If the projector was built for another grid.
+ */
+void fourierStep(Wavefunction3D& wfn, const Parameters& params,
+                 const Projector& projector);
+
 /** Computes the non-linear step of the evolution.
  *
  * Computes the non-linear subsystem of the evolution equations for a 1D system.
  *
  * @param wfn The 1D wavefunction object.
  * @param params Struct containing the parameters of the system.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
  */
 void interactionStep(Wavefunction1D& wfn, const Parameters& params);
 
@@ -49,6 +90,8 @@ void interactionStep(Wavefunction1D& wfn, const Parameters& params);
  *
  * @param wfn The 2D wavefunction object.
  * @param params Struct containing the parameters of the system.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
  */
 void interactionStep(Wavefunction2D& wfn, const Parameters& params);
 
@@ -58,9 +101,91 @@ void interactionStep(Wavefunction2D& wfn, const Parameters& params);
  *
  * @param wfn The 3D wavefunction object.
  * @param params Struct containing the parameters of the system.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
  */
 void interactionStep(Wavefunction3D& wfn, const Parameters& params);
 
+/** Computes the non-linear step of the evolution with a time-dependent
+ * potential.
+ *
+ * The amplitudes of the potential are evaluated once at the midpoint of the
+ * step, params.currentTime + timeStep / 2, and combined per grid point inside
+ * the interaction kernel. The trap of the parameters is ignored. The caller
+ * is responsible for advancing params.currentTime after each step.
+ *
+ * @param wfn The 1D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param potential The time-dependent potential.
+ */
+void interactionStep(Wavefunction1D& wfn, const Parameters& params,
+                     const Potential& potential);
+
+/** Computes the non-linear step of the evolution with a time-dependent
+ * potential.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param potential The time-dependent potential.
+ */
+void interactionStep(Wavefunction2D& wfn, const Parameters& params,
+                     const Potential& potential);
+
+/** Computes the non-linear step of the evolution with a time-dependent
+ * potential.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param potential The time-dependent potential.
+ */
+void interactionStep(Wavefunction3D& wfn, const Parameters& params,
+                     const Potential& potential);
+
+/** Computes the non-linear step of the evolution with a separable trap.
+ *
+ * The linear part of the step is taken from the cached propagator, so only
+ * the nonlinear exponential is evaluated per grid point and the full trap
+ * array is never read. The trap of the parameters is ignored.
+ *
+ * @param wfn The 1D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param propagator The propagator of the trap, built with params.timeStep.
+ * @throws std::invalid_argument If the propagator was built with a different
+ * time step or for a different grid.
+ */
+void interactionStep(Wavefunction1D& wfn, const Parameters& params,
+                     const TrapPropagator& propagator);
+
+/** Computes the non-linear step of the evolution with a separable trap.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param propagator The propagator of the trap, built with params.timeStep.
+ * @throws std::invalid_argument If the propagator was built with a different
+ * time step or for a different grid.
+ */
+void interactionStep(Wavefunction2D& wfn, const Parameters& params,
+                     const TrapPropagator& propagator);
+
+/** Computes the non-linear step of the evolution with a separable trap.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param propagator The propagator of the trap, built with params.timeStep.
+ * @throws std::invalid_argument If the propagator was built with a different
+ * time step or for a different grid.
+ */
+void interactionStep(Wavefunction3D& wfn, const Parameters& params,
+                     const TrapPropagator& propagator);
+
 /** Calculates the atom number of the wavefunction.
  *
  * @param wfn The 1D wavefunction object.
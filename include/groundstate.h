@@ -0,0 +1,67 @@
+#ifndef BECPP_GROUNDSTATE_H
+#define BECPP_GROUNDSTATE_H
+
+#include "data.h"
+#include "grid.h"
+#include "wavefunction.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/** Struct containing the options used when converging a ground state.
+ */
+struct GroundStateOptions {
+  double tolerance{1e-8};  ///< Relative change of the chemical potential
+                           /// below which a level is considered converged
+  int maxIterations{10000};  ///< Maximum number of time steps per level
+  int checkInterval{10};     ///< Number of time steps between convergence
+                             /// checks
+  int numLevels{3};  ///< Number of grid levels, including the target grid
+  unsigned int minPoints{16};  ///< Axes are not coarsened below this number
+                               /// of grid points
+  std::string wisdomFile{};    ///< File used to import and export FFTW wisdom.
+                               /// Left empty, wisdom is only kept in memory.
+};
+
+/** Function returning the trapping potential evaluated on a given grid.
+ */
+using TrapFunction3D = std::function<std::vector<double>(Grid3D&)>;
+
+/** Evolves the wave function in imaginary time until the chemical potential
+ * converges.
+ *
+ * The atom number is held fixed at its initial value, and the chemical
+ * potential is estimated each step from the decay of the norm. The timeStep
+ * of the parameters should be purely imaginary.
+ *
+ * @param wfn The 3D wavefunction object, holding the initial state in
+ * position space.
+ * @param params Struct containing the parameters of the system.
+ * @param options The convergence options.
+ * @return The number of time steps taken.
+ */
+int imaginaryTimeEvolution(Wavefunction3D& wfn, const Parameters& params,
+                           const GroundStateOptions& options);
+
+/** Converges a ground state using a ladder of successively finer grids.
+ *
+ * The initial state of the wave function is spectrally downsampled onto the
+ * coarsest grid, where it is evolved in imaginary time until converged. The
+ * result is then spectrally upsampled by zero-padding its Fourier space vector
+ * onto the next finer grid, and the process repeats until the grid of the
+ * wave function is reached. Each axis is halved per level independently,
+ * down to options.minPoints, so anisotropic grids are supported. FFT plans
+ * are created once per level and FFTW wisdom is shared between levels.
+ *
+ * @param wfn The 3D wavefunction object on the target grid, holding the
+ * initial state in position space. On return it holds the ground state.
+ * @param params Struct containing the parameters of the system. The trap is
+ * ignored in favour of the trap function.
+ * @param trap Function generating the trapping potential on a given grid.
+ * @param options The convergence options.
+ */
+void groundStateLadder(Wavefunction3D& wfn, const Parameters& params,
+                       const TrapFunction3D& trap,
+                       const GroundStateOptions& options);
+
+#endif  // BECPP_GROUNDSTATE_H
@@ -0,0 +1,124 @@
+#ifndef BECPP_KERNELS_H
+#define BECPP_KERNELS_H
+
+#include "projector.h"
+#include "wavefunction.h"
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+/** Applies the kinetic half step exp(-i dt k^2 / 4) to each Fourier mode.
+ *
+ * The kernel is pointwise, so it runs unchanged on any layout of the modes,
+ * e.g. the local slab of a distributed transform, as long as the wavenumber
+ * mesh has the same layout. Only the first wavenumber.size() modes of each
+ * realisation are updated. With several realisations stored one after the
+ * other, the exponential of each mode is evaluated once for the whole batch.
+ *
+ * @param fourierComponent The Fourier space vector.
+ * @param wavenumber The squared wavenumber of each mode.
+ * @param timeStep The time step of the evolution.
+ * @param numRealisations The number of realisations stored contiguously.
+ */
+void fourierKernel(complexVector_t& fourierComponent,
+                   const std::vector<double>& wavenumber,
+                   std::complex<double> timeStep,
+                   unsigned int numRealisations = 1);
+
+/** Checks that a trap holds one value per grid point.
+ *
+ * The interaction kernels take the number of points of each realisation from
+ * the trap, so every caller on a full grid checks it first, rather than
+ * silently skipping the points beyond a short trap.
+ *
+ * @param trap The trapping potential at each grid point.
+ * @param numPoints The number of grid points of a single realisation.
+ * @throws std::invalid_argument If the trap does not match the grid.
+ */
+void checkTrap(const std::vector<double>& trap, std::size_t numPoints);
+
+/** Applies the trap and contact interaction step
+ * exp(-i dt (V + g |psi|^2)) to each grid point.
+ *
+ * Like fourierKernel, the kernel is pointwise, and only the first trap.size()
+ * points of each realisation are updated.
+ *
+ * @param component The position space vector.
+ * @param trap The trapping potential at each grid point.
+ * @param intStrength The interaction strength.
+ * @param timeStep The time step of the evolution.
+ * @param numRealisations The number of realisations stored contiguously.
+ */
+void interactionKernel(complexVector_t& component,
+                       const std::vector<double>& trap, double intStrength,
+                       std::complex<double> timeStep,
+                       unsigned int numRealisations = 1);
+
+/** Applies the damped kinetic half step exp(-(i + gamma) dt k^2 / 4) to each
+ * Fourier mode.
+ *
+ * Otherwise behaves as fourierKernel, which it reduces to without damping.
+ *
+ * @param fourierComponent The Fourier space vector.
+ * @param wavenumber The squared wavenumber of each mode.
+ * @param timeStep The time step of the evolution.
+ * @param damping The dimensionless damping rate gamma.
+ * @param numRealisations The number of realisations stored contiguously.
+ */
+void dampedFourierKernel(complexVector_t& fourierComponent,
+                         const std::vector<double>& wavenumber,
+                         std::complex<double> timeStep, double damping,
+                         unsigned int numRealisations = 1);
+
+/** Applies the damped kinetic half step to the modes kept by a projector, and
+ * zeroes the others in the same pass.
+ *
+ * The kept ranges of each row are read from the projector, so there is no
+ * per-mode branch, and the exponential is only evaluated for kept modes.
+ *
+ * @param fourierComponent The Fourier space vector.
+ * @param wavenumber The squared wavenumber of each mode.
+ * @param timeStep The time step of the evolution.
+ * @param damping The dimensionless damping rate gamma, zero for the projected
+ * GPE.
+ * @param projector The projector of the grid.
+ * @param numRealisations The number of realisations stored contiguously.
+ * @throws std::invalid_argument If the projector does not match the
+ * wavenumber mesh.
+ */
+void projectedFourierKernel(complexVector_t& fourierComponent,
+                            const std::vector<double>& wavenumber,
+                            std::complex<double> timeStep, double damping,
+                            const Projector& projector,
+                            unsigned int numRealisations = 1);
+
+/** Applies the damped interaction step
+ * exp(-(i + gamma) dt (V + g |psi|^2 - mu)) to each grid point, and adds the
+ * complex Wiener increment of the reservoir in the same pass.
+ *
+ * The increment of point i of realisation m is noiseAmplitude times
+ * complexGaussian(seed, stream + m, i), generated on the fly, so no noise
+ * array is ever stored. Like interactionKernel, only the first trap.size()
+ * points of each realisation are updated.
+ *
+ * @param component The position space vector.
+ * @param trap The trapping potential at each grid point.
+ * @param intStrength The interaction strength.
+ * @param chemicalPotential The chemical potential of the reservoir.
+ * @param timeStep The time step of the evolution.
+ * @param damping The dimensionless damping rate gamma.
+ * @param noiseAmplitude The standard deviation of the increment at each point,
+ * or zero for the noiseless damped equation.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the first realisation.
+ * @param numRealisations The number of realisations stored contiguously.
+ */
+void stochasticInteractionKernel(complexVector_t& component,
+                                 const std::vector<double>& trap,
+                                 double intStrength, double chemicalPotential,
+                                 std::complex<double> timeStep, double damping,
+                                 double noiseAmplitude, std::uint64_t seed,
+                                 std::uint64_t stream,
+                                 unsigned int numRealisations = 1);
+
+#endif  // BECPP_KERNELS_H
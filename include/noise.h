@@ -0,0 +1,245 @@
+#ifndef BECPP_NOISE_H
+#define BECPP_NOISE_H
+
+#include "ensemble.h"
+#include "wavefunction.h"
+#include <array>
+#include <complex>
+#include <cstdint>
+
+/** Counter of the Philox4x32 generator, which is also the type of its output.
+ */
+using philoxCounter_t = std::array<std::uint32_t, 4>;
+
+/** Key of the Philox4x32 generator.
+ */
+using philoxKey_t = std::array<std::uint32_t, 2>;
+
+/** Returns the Philox4x32-10 bijection of a counter under a key.
+ *
+ * Philox is a counter-based generator: the random numbers are a pure function
+ * of the counter and key, with no state carried from one draw to the next.
+ * Every grid point can therefore draw its own numbers independently of all
+ * others, in any order and on any thread, and the result is reproducible bit
+ * for bit.
+ *
+ * @param counter The counter to encrypt.
+ * @param key The key, set from the seed.
+ */
+philoxCounter_t philox4x32(philoxCounter_t counter, philoxKey_t key);
+
+/** Returns a complex Gaussian random number z with <z> = 0 and <|z|^2> = 1.
+ *
+ * The number is drawn from a single Philox call, whose counter holds the index
+ * and the stream and whose key holds the seed. Distinct streams are
+ * uncorrelated, so the same seed can serve e.g. every realisation of an
+ * ensemble, each with its own stream.
+ *
+ * @param seed The seed of the generator.
+ * @param stream The stream drawn from.
+ * @param index The index of the number within the stream, usually the index
+ * of a grid point or Fourier mode.
+ */
+std::complex<double> complexGaussian(std::uint64_t seed, std::uint64_t stream,
+                                     std::uint64_t index);
+
+/** Returns a phase drawn uniformly from [0, 2 pi).
+ *
+ * See complexGaussian for the meaning of the arguments.
+ *
+ * @param seed The seed of the generator.
+ * @param stream The stream drawn from.
+ * @param index The index of the number within the stream.
+ */
+double uniformPhase(std::uint64_t seed, std::uint64_t stream,
+                    std::uint64_t index);
+
+/** Returns a number drawn uniformly from [0, 1).
+ *
+ * See complexGaussian for the meaning of the arguments.
+ *
+ * @param seed The seed of the generator.
+ * @param stream The stream drawn from.
+ * @param index The index of the number within the stream.
+ */
+double uniformReal(std::uint64_t seed, std::uint64_t stream,
+                   std::uint64_t index);
+
+/** Adds complex Gaussian noise to a field in parallel.
+ *
+ * Element i of realisation m is shifted by amplitude times
+ * complexGaussian(seed, stream + m, i). Since each element depends only on its
+ * own index, the result does not depend on the number of threads, and a
+ * realisation gets the same noise whatever batch it is stored in, as long as
+ * stream is offset by the index of the first realisation of the batch.
+ *
+ * @param field The position or Fourier space vector.
+ * @param amplitude The standard deviation of the noise, sqrt(<|dpsi|^2>).
+ * @param seed The seed of the generator.
+ * @param stream The stream of the first realisation.
+ * @param numRealisations The number of realisations stored contiguously.
+ */
+void addComplexGaussian(complexVector_t& field, double amplitude,
+                        std::uint64_t seed, std::uint64_t stream,
+                        unsigned int numRealisations = 1);
+
+/** Multiplies each element of a field by an independent random phase, in
+ * parallel. The phases are drawn as in addComplexGaussian.
+ *
+ * @param field The position or Fourier space vector.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the first realisation.
+ * @param numRealisations The number of realisations stored contiguously.
+ */
+void applyRandomPhase(complexVector_t& field, std::uint64_t seed,
+                      std::uint64_t stream, unsigned int numRealisations = 1);
+
+/** Adds the vacuum noise of the truncated Wigner method, half a particle per
+ * mode, to a 1D wave function.
+ *
+ * The noise is added to the Fourier space vector, which must be up to date,
+ * and the position space vector is then updated with an inverse FFT.
+ *
+ * @param wfn The 1D wavefunction object.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the noise, e.g. the index of the realisation.
+ */
+void addVacuumNoise(Wavefunction1D& wfn, std::uint64_t seed,
+                    std::uint64_t stream = 0);
+
+/** Adds the vacuum noise of the truncated Wigner method to a 2D wave function.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the noise, e.g. the index of the realisation.
+ */
+void addVacuumNoise(Wavefunction2D& wfn, std::uint64_t seed,
+                    std::uint64_t stream = 0);
+
+/** Adds the vacuum noise of the truncated Wigner method to a 3D wave function.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the noise, e.g. the index of the realisation.
+ */
+void addVacuumNoise(Wavefunction3D& wfn, std::uint64_t seed,
+                    std::uint64_t stream = 0);
+
+/** Adds the vacuum noise of the truncated Wigner method to every realisation
+ * of a 1D ensemble, realisation m drawing from stream + m.
+ *
+ * @param wfn The 1D ensemble.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the first realisation of the ensemble.
+ */
+void addVacuumNoise(EnsembleWavefunction1D& wfn, std::uint64_t seed,
+                    std::uint64_t stream = 0);
+
+/** Adds the vacuum noise of the truncated Wigner method to every realisation
+ * of a 2D ensemble, realisation m drawing from stream + m.
+ *
+ * @param wfn The 2D ensemble.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the first realisation of the ensemble.
+ */
+void addVacuumNoise(EnsembleWavefunction2D& wfn, std::uint64_t seed,
+                    std::uint64_t stream = 0);
+
+/** Adds a classical thermal field to a 1D wave function.
+ *
+ * Each mode receives a complex Gaussian amplitude of mean occupation
+ * T / (k^2 / 2 - mu), the Rayleigh-Jeans distribution of the classical field.
+ * As with addVacuumNoise, the noise is added to the up to date Fourier space
+ * vector, followed by an inverse FFT.
+ *
+ * @param wfn The 1D wavefunction object.
+ * @param temperature The temperature of the field.
+ * @param chemicalPotential The chemical potential, which must be negative.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the noise.
+ */
+void addThermalNoise(Wavefunction1D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream = 0);
+
+/** Adds a classical thermal field to a 2D wave function.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param temperature The temperature of the field.
+ * @param chemicalPotential The chemical potential, which must be negative.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the noise.
+ */
+void addThermalNoise(Wavefunction2D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream = 0);
+
+/** Adds a classical thermal field to a 3D wave function.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param temperature The temperature of the field.
+ * @param chemicalPotential The chemical potential, which must be negative.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the noise.
+ */
+void addThermalNoise(Wavefunction3D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream = 0);
+
+/** Adds a classical thermal field to every realisation of a 1D ensemble,
+ * realisation m drawing from stream + m.
+ *
+ * @param wfn The 1D ensemble.
+ * @param temperature The temperature of the field.
+ * @param chemicalPotential The chemical potential, which must be negative.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the first realisation of the ensemble.
+ */
+void addThermalNoise(EnsembleWavefunction1D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream = 0);
+
+/** Adds a classical thermal field to every realisation of a 2D ensemble,
+ * realisation m drawing from stream + m.
+ *
+ * @param wfn The 2D ensemble.
+ * @param temperature The temperature of the field.
+ * @param chemicalPotential The chemical potential, which must be negative.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the first realisation of the ensemble.
+ */
+void addThermalNoise(EnsembleWavefunction2D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream = 0);
+
+/** Multiplies each point of a 1D wave function by an independent random
+ * phase, and updates the Fourier space vector.
+ *
+ * @param wfn The 1D wavefunction object.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the phases.
+ */
+void applyRandomPhase(Wavefunction1D& wfn, std::uint64_t seed,
+                      std::uint64_t stream = 0);
+
+/** Multiplies each point of a 2D wave function by an independent random
+ * phase, and updates the Fourier space vector.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the phases.
+ */
+void applyRandomPhase(Wavefunction2D& wfn, std::uint64_t seed,
+                      std::uint64_t stream = 0);
+
+/** Multiplies each point of a 3D wave function by an independent random
+ * phase, and updates the Fourier space vector.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param seed The seed of the generator.
+ * @param stream The stream of the phases.
+ */
+void applyRandomPhase(Wavefunction3D& wfn, std::uint64_t seed,
+                      std::uint64_t stream = 0);
+
+#endif  // BECPP_NOISE_H
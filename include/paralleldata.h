@@ -0,0 +1,115 @@
+#ifndef BECPP_PARALLELDATA_H
+#define BECPP_PARALLELDATA_H
+
+#include "data.h"
+#include "distributed.h"
+#include "highfive/H5DataSet.hpp"
+#include "highfive/H5File.hpp"
+#include <mpi.h>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/** Data manager for 3D runs distributed over MPI ranks, where each rank holds
+ * a slab of the grid along x.
+ *
+ * All ranks open the same file through the MPI-IO driver, and every snapshot
+ * is written with a single collective hyperslab write in which each rank
+ * contributes its own slab, so the output bandwidth scales with the number of
+ * ranks instead of funnelling through one. Chunks span whole slabs along x,
+ * and are aligned to the file system blocks, so that no chunk is shared
+ * between ranks.
+ *
+ * The file has the layout of a DataManager3D file with only the
+ * "wavefunction" field, and can be read with DataReader. Parallel HDF5 does
+ * not write compressed chunks independently, so the compression, derived
+ * field and region options of DataOptions are ignored. Only available when
+ * built with BECPP_USE_MPI.
+ *
+ * Every member function is collective, and must be called by all ranks of
+ * the communicator in the same order.
+ */
+class ParallelDataManager3D {
+ private:
+  void saveParameters(const Parameters& params,
+                      const std::tuple<double, double, double>& gridSpacing,
+                      const DataOptions& options);
+  HighFive::DataSet createWavefunctionDataSet(MPI_Comm comm,
+                                              const DataOptions& options);
+  void writeSlab(const std::complex<double>* slab);
+
+ public:
+  /** Collectively creates the file and its datasets, and saves the
+   * parameters and numerical grid.
+   *
+   * @param filename The name of the file.
+   * @param comm The communicator of the ranks sharing the grid.
+   * @param params The parameters of the system.
+   * @param points The number of points of the whole grid along each axis.
+   * @param gridSpacing The grid spacing along each axis.
+   * @param localXStart The first x index of the slab of this rank.
+   * @param localXPoints The number of x points of the slab of this rank.
+   * @param options The options of the save system.
+   * @throws std::invalid_argument On every rank, before the file is opened,
+   * if the slab of any rank lies outside the grid.
+   */
+  ParallelDataManager3D(
+      const std::string& filename, MPI_Comm comm, const Parameters& params,
+      const std::tuple<unsigned int, unsigned int, unsigned int>& points,
+      const std::tuple<double, double, double>& gridSpacing,
+      std::size_t localXStart, std::size_t localXPoints,
+      const DataOptions& options = {});
+
+  /** Collectively creates the file for a distributed grid, with the slab of
+   * each rank taken from the grid.
+   *
+   * @param filename The name of the file.
+   * @param params The parameters of the system.
+   * @param grid The distributed 3D grid object of the system.
+   * @param options The options of the save system.
+   */
+  ParallelDataManager3D(const std::string& filename, const Parameters& params,
+                        const DistributedGrid3D& grid,
+                        const DataOptions& options = {});
+
+  /** Trims the wavefunction dataset to the saved snapshots.
+   */
+  ~ParallelDataManager3D();
+
+  ParallelDataManager3D(const ParallelDataManager3D&) = delete;
+  ParallelDataManager3D& operator=(const ParallelDataManager3D&) = delete;
+
+  /** Collectively saves the slab of this rank as the next snapshot.
+   *
+   * @param slab The position space values of the slab of this rank, of size
+   * localXPoints * yPoints * zPoints with z running fastest.
+   */
+  void saveWavefunctionData(const complexVector_t& slab);
+
+  /** Collectively saves the current distributed wave function as the next
+   * snapshot. As with DataManager3D, the position space slab is first
+   * updated from the Fourier space vector.
+   *
+   * @param wfn The distributed 3D wavefunction object.
+   */
+  void saveWavefunctionData(DistributedWavefunction3D& wfn);
+
+  /** Returns the number of saved snapshots.
+   */
+  [[nodiscard]] std::size_t numSnapshots() const;
+
+  std::string filename;  ///< Filename of the .hdf5 file
+  HighFive::File file;   ///< Reference to the underlying .hdf5 file, open on
+                         /// every rank
+
+ private:
+  std::vector<std::size_t> m_shape;
+  std::size_t m_localXStart;
+  std::size_t m_localXPoints;
+  std::size_t m_capacity;
+  HighFive::DataSet m_dataSet;
+  std::size_t m_numSnapshots{0};
+};
+
+#endif  // BECPP_PARALLELDATA_H
@@ -0,0 +1,245 @@
+#ifndef BECPP_POTENTIAL_H
+#define BECPP_POTENTIAL_H
+
+#include "grid.h"
+#include <array>
+#include <complex>
+#include <functional>
+#include <vector>
+
+/** Function returning a time-dependent amplitude.
+ */
+using Amplitude = std::function<double(double)>;
+
+/** Axes of the numerical grid.
+ */
+enum class Axis { x = 0, y = 1, z = 2 };
+
+/** Struct describing a Gaussian stirring potential.
+ *
+ * The stirrer is V(r, t) = amplitude(t) * exp(-|r - position(t)|^2 /
+ * (2 width^2)), truncated outside a box of cutoff widths around its centre.
+ * Components of the position beyond the dimension of the system are ignored.
+ */
+struct GaussianStirrer {
+  Amplitude amplitude{};  ///< Peak height of the stirrer
+  std::function<std::array<double, 3>(double)> position{};  ///< Centre
+  double width{1.0};                                         ///< Gaussian width
+  double cutoff{4.0};  ///< Half-size of the bounding box, in widths
+};
+
+/** Struct containing a stirrer evaluated at a single time.
+ */
+struct StirrerTerm {
+  std::array<unsigned int, 3> begin{};  ///< First grid index of the box
+  std::array<unsigned int, 3> end{};    ///< One past the last grid index
+  std::array<std::vector<double>, 3> profile{};  ///< Separable Gaussian
+                                                 /// factors inside the box,
+                                                 /// scaled by the amplitude
+
+  /** Returns the value of the stirrer at grid point (i, j, k).
+   */
+  [[nodiscard]] double value(unsigned int i, unsigned int j,
+                             unsigned int k) const {
+    if (i < begin[0] || i >= end[0] || j < begin[1] || j >= end[1] ||
+        k < begin[2] || k >= end[2]) {
+      return 0.0;
+    }
+    return profile[0][i - begin[0]] * profile[1][j - begin[1]] *
+           profile[2][k - begin[2]];
+  }
+};
+
+/** Struct containing a potential evaluated at a single time.
+ *
+ * Everything except the static part is of size O(Nx + Ny + Nz), so
+ * evaluating a potential every time step costs no extra passes over the
+ * full grid.
+ */
+struct PotentialTerms {
+  const std::vector<double>* staticPart{};  ///< Static part, or nullptr
+  std::array<std::vector<double>, 3> axis{};  ///< Summed separable parts
+  std::vector<StirrerTerm> stirrers{};        ///< Stirrers inside their boxes
+};
+
+/** Struct containing a separable trapping potential,
+ * V(x, y, z) = Vx(x) + Vy(y) + Vz(z).
+ *
+ * Only the per-axis profiles are stored, so the trap takes O(Nx + Ny + Nz)
+ * memory instead of O(Nx * Ny * Nz). Axes beyond the dimension of the system
+ * are left empty.
+ */
+struct SeparableTrap {
+  std::array<std::vector<double>, 3> axis{};  ///< Profile along each axis
+};
+
+/** Creates the harmonic trap 0.5 * omega^2 * x^2 of a 1D system.
+ *
+ * @param grid The 1D grid object of the system.
+ * @param omega The trapping frequency.
+ */
+SeparableTrap harmonicTrap(const Grid1D& grid, double omega);
+
+/** Creates the harmonic trap of a 2D system.
+ *
+ * @param grid The 2D grid object of the system.
+ * @param omega Tuple containing the trapping frequencies (omegaX, omegaY).
+ */
+SeparableTrap harmonicTrap(const Grid2D& grid,
+                           std::tuple<double, double> omega);
+
+/** Creates the harmonic trap of a 3D system.
+ *
+ * @param grid The 3D grid object of the system.
+ * @param omega Tuple containing the trapping frequencies (omegaX, omegaY,
+ * omegaZ).
+ */
+SeparableTrap harmonicTrap(const Grid3D& grid,
+                           std::tuple<double, double, double> omega);
+
+/** Creates a box trap of a 3D system.
+ *
+ * The potential is zero inside the box |x| < xHalfWidth etc., and height
+ * outside it along each axis.
+ *
+ * @param grid The 3D grid object of the system.
+ * @param height The height of the walls.
+ * @param halfWidth Tuple containing the half widths of the box along each
+ * axis.
+ */
+SeparableTrap boxTrap(const Grid3D& grid, double height,
+                      std::tuple<double, double, double> halfWidth);
+
+/** Cached linear propagator exp(-i dt V) of a separable trap.
+ *
+ * As the trap is separable, so is its propagator, which is stored as one
+ * complex factor per grid point along each axis. The interaction kernel then
+ * only needs to evaluate the nonlinear exponential per grid point. The
+ * propagator is only valid for the time step it was built with.
+ */
+class TrapPropagator {
+ private:
+  std::complex<double> m_timeStep{};
+  std::array<std::vector<std::complex<double>>, 3> m_axis{};
+
+  TrapPropagator(const SeparableTrap& trap,
+                 const std::array<unsigned int, 3>& shape,
+                 std::complex<double> timeStep);
+
+ public:
+  /** Constructs the propagator of the trap of a 1D system for a fixed time
+   * step.
+   *
+   * An empty x profile is treated as a zero potential.
+   *
+   * @param trap The separable trap.
+   * @param grid The 1D grid object of the system.
+   * @param timeStep The time step of the evolution.
+   * @throws std::invalid_argument If a profile does not have one value per
+   * grid point along its axis.
+   */
+  TrapPropagator(const SeparableTrap& trap, const Grid1D& grid,
+                 std::complex<double> timeStep);
+
+  /** Constructs the propagator of the trap of a 2D system for a fixed time
+   * step.
+   *
+   * @param trap The separable trap.
+   * @param grid The 2D grid object of the system.
+   * @param timeStep The time step of the evolution.
+   * @throws std::invalid_argument If a profile does not have one value per
+   * grid point along its axis.
+   */
+  TrapPropagator(const SeparableTrap& trap, const Grid2D& grid,
+                 std::complex<double> timeStep);
+
+  /** Constructs the propagator of the trap of a 3D system for a fixed time
+   * step.
+   *
+   * @param trap The separable trap.
+   * @param grid The 3D grid object of the system.
+   * @param timeStep The time step of the evolution.
+   * @throws std::invalid_argument If a profile does not have one value per
+   * grid point along its axis.
+   */
+  TrapPropagator(const SeparableTrap& trap, const Grid3D& grid,
+                 std::complex<double> timeStep);
+
+  /** Returns the time step the propagator was built with.
+   */
+  [[nodiscard]] std::complex<double> timeStep() const;
+
+  /** Returns the factors exp(-i dt V) along one axis, one per grid point.
+   * Axes without a profile hold factors of 1, and axes beyond the dimension
+   * of the system hold a single factor of 1.
+   */
+  [[nodiscard]] const std::vector<std::complex<double>>& axis(Axis axis) const;
+};
+
+/** Time-dependent trapping potential.
+ *
+ * The potential is made of an optional static part stored on the full grid,
+ * separable parts along each axis whose amplitudes depend on time, and
+ * localised Gaussian stirrers. It replaces Parameters::trap in the
+ * corresponding interactionStep overloads, where the time-dependent
+ * amplitudes are evaluated once per step and combined per grid point inside
+ * the interaction kernel.
+ */
+class Potential {
+ private:
+  struct SeparablePart {
+    Axis axis;
+    std::vector<double> profile;
+    Amplitude amplitude;
+  };
+
+  std::vector<double> m_static{};
+  std::vector<SeparablePart> m_separable{};
+  std::vector<GaussianStirrer> m_stirrers{};
+
+ public:
+  /** Sets the static part of the potential.
+   *
+   * @param potential The potential on the full grid.
+   */
+  void setStatic(std::vector<double> potential);
+
+  /** Adds a separable part along one axis.
+   *
+   * @param axis The axis the profile varies along.
+   * @param profile The potential along that axis, one value per grid point.
+   * @param amplitude Time-dependent factor multiplying the profile. Left
+   * empty, the part is static.
+   */
+  void addSeparable(Axis axis, std::vector<double> profile,
+                    Amplitude amplitude = {});
+
+  /** Adds every axis of a separable trap as a static separable part.
+   *
+   * @param trap The separable trap.
+   */
+  void addSeparable(const SeparableTrap& trap);
+
+  /** Adds a Gaussian stirrer.
+   *
+   * @param stirrer The stirrer.
+   */
+  void addStirrer(GaussianStirrer stirrer);
+
+  /** Evaluates the potential at the given time.
+   *
+   * Unused axes should have one grid point.
+   *
+   * @param shape Number of grid points along each axis.
+   * @param gridSpacing Grid spacing along each axis.
+   * @param time The time at which to evaluate the amplitudes.
+   * @throws std::invalid_argument If the static part does not have one value
+   * per grid point, or a separable profile one value per grid point along its
+   * axis.
+   */
+  [[nodiscard]] PotentialTerms evaluate(
+      const std::array<unsigned int, 3>& shape,
+      const std::array<double, 3>& gridSpacing, double time) const;
+};
+
+#endif  // BECPP_POTENTIAL_H
@@ -0,0 +1,37 @@
+#ifndef BECPP_PROJECTION_H
+#define BECPP_PROJECTION_H
+
+#include "wavefunction.h"
+#include <vector>
+
+/** Returns the column density of a 3D wave function, the density |psi|^2
+ * integrated along one axis, as imaged in situ by an experiment.
+ *
+ * The result has the shape of the two remaining axes in their original order,
+ * with the last one running fastest. Columns are integrated in parallel.
+ *
+ * @param wfn The 3D wavefunction object, with an up to date position space
+ * vector.
+ * @param axis The axis integrated along, 0 for x, 1 for y, 2 for z.
+ */
+std::vector<double> columnDensity(Wavefunction3D& wfn, unsigned int axis);
+
+/** Returns the momentum distribution of a 3D wave function integrated along
+ * one axis of momentum space.
+ *
+ * This is the column density imaged after a long ballistic time of flight t,
+ * where an atom of momentum k ends up at position k t. It is computed
+ * directly from the Fourier space vector, without any FFT. The modes are
+ * reordered so that zero momentum lies at the centre, matching the layout of
+ * the position space mesh and of AccumulatedField::momentumDensity, and the
+ * distribution is normalised so that it integrates to the atom number over
+ * the remaining two momentum axes.
+ *
+ * @param wfn The 3D wavefunction object, with an up to date Fourier space
+ * vector.
+ * @param axis The axis integrated along, 0 for x, 1 for y, 2 for z.
+ */
+std::vector<double> columnMomentumDensity(Wavefunction3D& wfn,
+                                          unsigned int axis);
+
+#endif  // BECPP_PROJECTION_H
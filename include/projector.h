@@ -0,0 +1,85 @@
+#ifndef BECPP_PROJECTOR_H
+#define BECPP_PROJECTOR_H
+
+#include "grid.h"
+#include "wavefunction.h"
+#include <cstddef>
+#include <vector>
+
+/** Spherical projector |k| < cutoff onto the low-momentum modes of a grid,
+ * as used by projected-GPE runs and for dealiasing.
+ *
+ * The grid is viewed as rows along its last axis. In the FFT ordering of a
+ * row, the wavenumber rises from zero up to the Nyquist mode and then falls
+ * back, so the modes kept in each row are the two ranges [0, rowEnds()[row])
+ * and [rowStarts()[row], rowLength()). Only these two indices are stored per
+ * row, and the projection is applied inside the kinetic kernels without a
+ * per-mode branch, reading no more memory than an unprojected step.
+ */
+class Projector {
+ private:
+  double m_cutoff{};
+  unsigned int m_rowLength{};
+  std::vector<unsigned int> m_rowEnds{};
+  std::vector<unsigned int> m_rowStarts{};
+
+  void buildRows(const std::vector<double>& wavenumber, unsigned int rowLength);
+
+ public:
+  /** Constructs the projector of a 1D grid, which has a single row.
+   *
+   * @param grid The 1D grid object of the system.
+   * @param cutoff The wavenumber cutoff of the projector.
+   */
+  Projector(Grid1D& grid, double cutoff);
+
+  /** Constructs the projector of a 2D grid, with one row per x point.
+   *
+   * @param grid The 2D grid object of the system.
+   * @param cutoff The wavenumber cutoff of the projector.
+   */
+  Projector(Grid2D& grid, double cutoff);
+
+  /** Constructs the projector of a 3D grid, with one row per (x, y) point.
+   *
+   * @param grid The 3D grid object of the system.
+   * @param cutoff The wavenumber cutoff of the projector.
+   */
+  Projector(Grid3D& grid, double cutoff);
+
+  /** Returns the wavenumber cutoff of the projector.
+   */
+  [[nodiscard]] double cutoff() const;
+
+  /** Returns the number of points along the last axis of the grid.
+   */
+  [[nodiscard]] unsigned int rowLength() const;
+
+  /** Returns the number of rows of the grid.
+   */
+  [[nodiscard]] std::size_t numRows() const;
+
+  /** Returns the end of the range of kept non-negative modes of each row.
+   */
+  [[nodiscard]] const std::vector<unsigned int>& rowEnds() const;
+
+  /** Returns the start of the range of kept negative modes of each row.
+   */
+  [[nodiscard]] const std::vector<unsigned int>& rowStarts() const;
+
+  /** Returns the number of modes kept by the projector.
+   */
+  [[nodiscard]] std::size_t numModes() const;
+
+  /** Zeroes the modes of a Fourier space vector outside the projector, e.g.
+   * to project an initial state.
+   *
+   * @param fourierComponent The Fourier space vector.
+   * @param numRealisations The number of realisations stored contiguously.
+   * @throws std::invalid_argument If the vector does not match the grid.
+   */
+  void apply(complexVector_t& fourierComponent,
+             unsigned int numRealisations = 1) const;
+};
+
+#endif  // BECPP_PROJECTOR_H
@@ -0,0 +1,193 @@
+#ifndef BECPP_READER_H
+#define BECPP_READER_H
+
+#include "data.h"
+#include "grid.h"
+#include "highfive/H5DataSet.hpp"
+#include "highfive/H5File.hpp"
+#include "wavefunction.h"
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/** Read-side counterpart of the DataManager classes.
+ *
+ * Opens a file written by DataManager1D, DataManager2D or DataManager3D and
+ * gives access to its parameters, grid and snapshots. Nothing is loaded on
+ * construction: every read selects a hyperslab of the snapshot dataset, so
+ * HDF5 only reads the chunks it intersects. Reading a plane of a single time
+ * from a large run therefore touches a small fraction of the file.
+ *
+ * Fields are named as in OutputField, e.g. "wavefunction" or "density".
+ * Delta-encoded "wavefunction" snapshots, saved with
+ * DataOptions::keyframeInterval, are decoded transparently from their
+ * nearest keyframe.
+ */
+class DataReader {
+ private:
+  HighFive::File m_file;
+
+  [[nodiscard]] std::vector<std::size_t> dimensions(
+      const std::string& field) const;
+  [[nodiscard]] std::string wavefunctionField() const;
+  [[nodiscard]] bool fourierOutput() const;
+  [[nodiscard]] std::size_t keyframeInterval() const;
+
+ public:
+  /** Opens the file for reading.
+   *
+   * @param filename The name of the file.
+   */
+  explicit DataReader(const std::string& filename);
+
+  /** Returns the saved parameters of the system. The trapping potential is
+   * not saved by the DataManager classes, and is left empty.
+   */
+  [[nodiscard]] Parameters parameters() const;
+
+  /** Returns the grid of a 1D file.
+   */
+  [[nodiscard]] Grid1D grid1D() const;
+
+  /** Returns the grid of a 2D file.
+   */
+  [[nodiscard]] Grid2D grid2D() const;
+
+  /** Returns the grid of a 3D file.
+   */
+  [[nodiscard]] Grid3D grid3D() const;
+
+  /** Returns the spatial shape of the snapshots of a field.
+   *
+   * @param field The name of the field.
+   */
+  [[nodiscard]] std::vector<std::size_t> shape(
+      const std::string& field = "wavefunction") const;
+
+  /** Returns the number of saved snapshots of a field.
+   *
+   * The count is read from the "numSnapshots" attribute kept up to date by
+   * the writer, so a file still being written, or left by a killed run,
+   * reports the snapshots actually saved rather than the preallocated time
+   * extent. Files without the attribute report their time extent.
+   *
+   * @param field The name of the field.
+   */
+  [[nodiscard]] std::size_t numSnapshots(
+      const std::string& field = "wavefunction") const;
+
+  /** Returns the time of a snapshot. Event-triggered snapshots are saved
+   * irregularly, so their time is read from /timeseries/snapshotTime.
+   * Otherwise the first snapshot is assumed saved at time zero and one every
+   * saveInterval steps after that.
+   *
+   * @param index The index of the snapshot.
+   * @throws std::out_of_range If the time of the snapshot was not recorded.
+   */
+  [[nodiscard]] double time(std::size_t index) const;
+
+  /** Returns the index of the snapshot nearest to a time, using the recorded
+   * times of event-triggered snapshots if any.
+   *
+   * @param time The time of the wanted snapshot.
+   */
+  [[nodiscard]] std::size_t snapshotIndex(double time) const;
+
+  /** Reads a region of a single snapshot.
+   *
+   * @param field The name of the field.
+   * @param index The index of the snapshot.
+   * @param offset The first grid index of the region along each axis.
+   * @param count The size of the region along each axis.
+   */
+  template <typename T>
+  [[nodiscard]] std::vector<T> readRegion(
+      const std::string& field, std::size_t index,
+      const std::vector<std::size_t>& offset,
+      const std::vector<std::size_t>& count) const {
+    if constexpr (std::is_same_v<T, std::complex<double>>) {
+      if (field == "wavefunction" && keyframeInterval() > 0) {
+        return readDeltaSnapshot(m_file.getDataSet(field), index,
+                                 keyframeInterval(), offset, count);
+      }
+    }
+
+    std::vector<std::size_t> snapshotOffset{index};
+    std::vector<std::size_t> snapshotCount{1};
+    snapshotOffset.insert(snapshotOffset.end(), offset.begin(), offset.end());
+    snapshotCount.insert(snapshotCount.end(), count.begin(), count.end());
+
+    std::size_t size = 1;
+    for (auto points : count) {
+      size *= points;
+    }
+    std::vector<T> values(size);
+    m_file.getDataSet(field)
+        .select(snapshotOffset, snapshotCount)
+        .read(values.data());
+
+    return values;
+  }
+
+  /** Reads a plane of a single snapshot, at a fixed grid index along one
+   * axis.
+   *
+   * @param field The name of the field.
+   * @param index The index of the snapshot.
+   * @param axis The axis normal to the plane, 0 for x, 1 for y, 2 for z.
+   * @param position The grid index of the plane along the axis.
+   */
+  template <typename T>
+  [[nodiscard]] std::vector<T> readPlane(const std::string& field,
+                                         std::size_t index, std::size_t axis,
+                                         std::size_t position) const {
+    std::vector<std::size_t> count = shape(field);
+    std::vector<std::size_t> offset(count.size(), 0);
+    offset.at(axis) = position;
+    count[axis] = 1;
+
+    return readRegion<T>(field, index, offset, count);
+  }
+
+  /** Reads a full snapshot.
+   *
+   * @param field The name of the field.
+   * @param index The index of the snapshot.
+   */
+  template <typename T>
+  [[nodiscard]] std::vector<T> readSnapshot(const std::string& field,
+                                            std::size_t index) const {
+    std::vector<std::size_t> count = shape(field);
+    return readRegion<T>(field, index, std::vector<std::size_t>(count.size()),
+                         count);
+  }
+
+  /** Reads a snapshot straight into the position space vector of a 1D wave
+   * function, and updates its Fourier space vector.
+   *
+   * Reads "wavefunction" if saved, otherwise "wavefunctionFloat". Snapshots
+   * saved with DataOptions::fourierOutput are read into the Fourier space
+   * vector instead, and transformed back to position space.
+   *
+   * @param index The index of the snapshot.
+   * @param wfn The 1D wavefunction object, on the grid of the file.
+   */
+  void readSnapshot(std::size_t index, Wavefunction1D& wfn) const;
+
+  /** Reads a snapshot straight into a 2D wave function.
+   *
+   * @param index The index of the snapshot.
+   * @param wfn The 2D wavefunction object, on the grid of the file.
+   */
+  void readSnapshot(std::size_t index, Wavefunction2D& wfn) const;
+
+  /** Reads a snapshot straight into a 3D wave function.
+   *
+   * @param index The index of the snapshot.
+   * @param wfn The 3D wavefunction object, on the grid of the file.
+   */
+  void readSnapshot(std::size_t index, Wavefunction3D& wfn) const;
+};
+
+#endif  // BECPP_READER_H
@@ -0,0 +1,163 @@
+#ifndef BECPP_SPECTRAL_H
+#define BECPP_SPECTRAL_H
+
+#include "wavefunction.h"
+#include <tuple>
+
+/** Spectrally resamples a 1D Fourier space vector onto a grid with a
+ * different number of points.
+ *
+ * Modes common to both grids are copied across, while modes only present on
+ * the larger grid are zero-padded (upsampling) or discarded (downsampling).
+ * The result is rescaled so that the position space wave function keeps the
+ * same amplitude once transformed on the new grid. Both grids must span the
+ * same length.
+ *
+ * @param source The Fourier space vector on the source grid.
+ * @param sourcePoints Number of grid points of the source grid.
+ * @param target The Fourier space vector on the target grid. It is resized if
+ * needed.
+ * @param targetPoints Number of grid points of the target grid.
+ */
+void resampleFourier(const complexVector_t& source, unsigned int sourcePoints,
+                     complexVector_t& target, unsigned int targetPoints);
+
+/** Spectrally resamples a 2D Fourier space vector onto a grid with a
+ * different number of points.
+ *
+ * @param source The Fourier space vector on the source grid.
+ * @param sourceShape Tuple containing (xPoints, yPoints) of the source grid.
+ * @param target The Fourier space vector on the target grid. It is resized if
+ * needed.
+ * @param targetShape Tuple containing (xPoints, yPoints) of the target grid.
+ */
+void resampleFourier(const complexVector_t& source,
+                     std::tuple<unsigned int, unsigned int> sourceShape,
+                     complexVector_t& target,
+                     std::tuple<unsigned int, unsigned int> targetShape);
+
+/** Spectrally resamples a 3D Fourier space vector onto a grid with a
+ * different number of points.
+ *
+ * The number of points may change independently along each axis, so
+ * anisotropic grids are supported.
+ *
+ * @param source The Fourier space vector on the source grid.
+ * @param sourceShape Tuple containing (xPoints, yPoints, zPoints) of the
+ * source grid.
+ * @param target The Fourier space vector on the target grid. It is resized if
+ * needed.
+ * @param targetShape Tuple containing (xPoints, yPoints, zPoints) of the
+ * target grid.
+ */
+void resampleFourier(
+    const complexVector_t& source,
+    std::tuple<unsigned int, unsigned int, unsigned int> sourceShape,
+    complexVector_t& target,
+    std::tuple<unsigned int, unsigned int, unsigned int> targetShape);
+
+/** Spectral downsampler of 1D snapshots.
+ *
+ * Keeps the central modes of the Fourier space vector of a wave function that
+ * fit on a grid coarser by a fixed factor, spanning the same length. The
+ * retained modes are either returned as they are, or transformed to position
+ * space on the coarse grid, whose FFT is a fraction of the size of the full
+ * one.
+ */
+class SpectralDownsampler1D {
+ private:
+  Grid1D m_grid;
+  Wavefunction1D m_wfn;
+  unsigned int m_sourcePoints;
+
+ public:
+  /** Constructs the downsampler and plans the FFTs of the coarse grid.
+   *
+   * @param grid The 1D grid object of the system.
+   * @param factor The factor by which the number of points is reduced.
+   */
+  SpectralDownsampler1D(const Grid1D& grid, unsigned int factor);
+
+  SpectralDownsampler1D(const SpectralDownsampler1D&) = delete;
+  SpectralDownsampler1D& operator=(const SpectralDownsampler1D&) = delete;
+
+  /** Returns the coarse grid.
+   */
+  [[nodiscard]] const Grid1D& grid() const;
+
+  /** Downsamples the current Fourier space vector of the wave function.
+   *
+   * @param wfn The 1D wavefunction object.
+   * @param fourierSpace If true, returns the retained Fourier modes instead
+   * of the position space wave function on the coarse grid.
+   */
+  const complexVector_t& downsample(Wavefunction1D& wfn, bool fourierSpace);
+};
+
+/** Spectral downsampler of 2D snapshots.
+ */
+class SpectralDownsampler2D {
+ private:
+  Grid2D m_grid;
+  Wavefunction2D m_wfn;
+  std::tuple<unsigned int, unsigned int> m_sourceShape;
+
+ public:
+  /** Constructs the downsampler and plans the FFTs of the coarse grid.
+   *
+   * @param grid The 2D grid object of the system.
+   * @param factor The factor by which the number of points is reduced along
+   * each axis.
+   */
+  SpectralDownsampler2D(const Grid2D& grid, unsigned int factor);
+
+  SpectralDownsampler2D(const SpectralDownsampler2D&) = delete;
+  SpectralDownsampler2D& operator=(const SpectralDownsampler2D&) = delete;
+
+  /** Returns the coarse grid.
+   */
+  [[nodiscard]] const Grid2D& grid() const;
+
+  /** Downsamples the current Fourier space vector of the wave function.
+   *
+   * @param wfn The 2D wavefunction object.
+   * @param fourierSpace If true, returns the retained Fourier modes instead
+   * of the position space wave function on the coarse grid.
+   */
+  const complexVector_t& downsample(Wavefunction2D& wfn, bool fourierSpace);
+};
+
+/** Spectral downsampler of 3D snapshots.
+ */
+class SpectralDownsampler3D {
+ private:
+  Grid3D m_grid;
+  Wavefunction3D m_wfn;
+  std::tuple<unsigned int, unsigned int, unsigned int> m_sourceShape;
+
+ public:
+  /** Constructs the downsampler and plans the FFTs of the coarse grid.
+   *
+   * @param grid The 3D grid object of the system.
+   * @param factor The factor by which the number of points is reduced along
+   * each axis.
+   */
+  SpectralDownsampler3D(const Grid3D& grid, unsigned int factor);
+
+  SpectralDownsampler3D(const SpectralDownsampler3D&) = delete;
+  SpectralDownsampler3D& operator=(const SpectralDownsampler3D&) = delete;
+
+  /** Returns the coarse grid.
+   */
+  [[nodiscard]] const Grid3D& grid() const;
+
+  /** Downsamples the current Fourier space vector of the wave function.
+   *
+   * @param wfn The 3D wavefunction object.
+   * @param fourierSpace If true, returns the retained Fourier modes instead
+   * of the position space wave function on the coarse grid.
+   */
+  const complexVector_t& downsample(Wavefunction3D& wfn, bool fourierSpace);
+};
+
+#endif  // BECPP_SPECTRAL_H
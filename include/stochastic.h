@@ -0,0 +1,213 @@
+#ifndef BECPP_STOCHASTIC_H
+#define BECPP_STOCHASTIC_H
+
+#include "data.h"
+#include "ensemble.h"
+#include "projector.h"
+#include "wavefunction.h"
+#include <cstdint>
+
+/** Struct containing the parameters of the thermal reservoir of the
+ * stochastic projected Gross-Pitaevskii equation (SPGPE),
+ *
+ * dpsi = P{-(i + gamma) (L - mu) psi dt + dW},
+ *
+ * where L is the Gross-Pitaevskii operator, P the projector onto the modes
+ * below a cutoff, see Projector, and dW a complex Wiener increment with
+ * <|dW|^2> = 2 gamma T dt / dV at each grid point. A zero temperature gives
+ * the damped, or dissipative, Gross-Pitaevskii equation.
+ */
+struct Reservoir {
+  double damping{};            ///< Dimensionless damping rate gamma
+  double temperature{};        ///< Temperature T of the reservoir
+  double chemicalPotential{};  ///< Chemical potential mu of the reservoir
+  std::uint64_t seed{};        ///< Seed of the noise generator
+  std::uint64_t stream{};      ///< Stream of the noise, e.g. the index of the
+                               /// realisation. Ensembles use stream + m for
+                               /// realisation m.
+};
+
+/** Computes the damped Fourier step of the SPGPE, without a projector.
+ *
+ * @param wfn The 1D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ */
+void fourierStep(Wavefunction1D& wfn, const Parameters& params,
+                 const Reservoir& reservoir);
+
+/** Computes the damped Fourier step of the SPGPE, without a projector.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ */
+void fourierStep(Wavefunction2D& wfn, const Parameters& params,
+                 const Reservoir& reservoir);
+
+/** Computes the damped Fourier step of the SPGPE, without a projector.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ */
+void fourierStep(Wavefunction3D& wfn, const Parameters& params,
+                 const Reservoir& reservoir);
+
+/** Computes the damped Fourier step of the SPGPE, without a projector, for
+ * every realisation of a 1D ensemble.
+ *
+ * @param wfn The 1D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ */
+void fourierStep(EnsembleWavefunction1D& wfn, const Parameters& params,
+                 const Reservoir& reservoir);
+
+/** Computes the damped Fourier step of the SPGPE, without a projector, for
+ * every realisation of a 2D ensemble.
+ *
+ * @param wfn The 2D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ */
+void fourierStep(EnsembleWavefunction2D& wfn, const Parameters& params,
+                 const Reservoir& reservoir);
+
+/** Computes the damped and projected Fourier step of the SPGPE.
+ *
+ * The projector is applied within the kinetic multiply, so a projected run
+ * makes no more passes over the Fourier space vector than an unprojected one.
+ *
+ * @param wfn The 1D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param projector The projector of the grid of the wave function.
+ */
+void fourierStep(Wavefunction1D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector);
+
+/** Computes the damped and projected Fourier step of the SPGPE.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param projector The projector of the grid of the wave function.
+ */
+void fourierStep(Wavefunction2D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector);
+
+/** Computes the damped and projected Fourier step of the SPGPE.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param projector The projector of the grid of the wave function.
+ */
+void fourierStep(Wavefunction3D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector);
+
+/** Computes the damped and projected Fourier step of the SPGPE for every
+ * realisation of a 1D ensemble.
+ *
+ * @param wfn The 1D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param projector The projector of the grid of the ensemble.
+ */
+void fourierStep(EnsembleWavefunction1D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector);
+
+/** Computes the damped and projected Fourier step of the SPGPE for every
+ * realisation of a 2D ensemble.
+ *
+ * @param wfn The 2D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param projector The projector of the grid of the ensemble.
+ */
+void fourierStep(EnsembleWavefunction2D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector);
+
+/** Computes the damped non-linear step of the SPGPE, including the noise of
+ * the reservoir.
+ *
+ * The noise is generated from the counter-based generator inside the same
+ * parallel pass that applies the step, keyed by the seed, the stream and the
+ * step number, so no noise array is stored and a run is reproducible
+ * regardless of the number of threads. The noise enters the projected space
+ * at the following projected Fourier step. Streams of the first 2^32 values
+ * are offset by the step number, so they do not overlap with the noise of the
+ * initial state drawn from the same seed.
+ *
+ * @param wfn The 1D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param step The index of the time step, which must differ between steps.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
+ */
+void interactionStep(Wavefunction1D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step);
+
+/** Computes the damped non-linear step of the SPGPE, including the noise of
+ * the reservoir.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param step The index of the time step, which must differ between steps.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
+ */
+void interactionStep(Wavefunction2D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step);
+
+/** Computes the damped non-linear step of the SPGPE, including the noise of
+ * the reservoir.
+ *
+ * See the 1D overload for details.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param step The index of the time step, which must differ between steps.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
+ */
+void interactionStep(Wavefunction3D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step);
+
+/** Computes the damped non-linear step of the SPGPE for every realisation of
+ * a 1D ensemble, each with independent noise.
+ *
+ * @param wfn The 1D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param step The index of the time step, which must differ between steps.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
+ */
+void interactionStep(EnsembleWavefunction1D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step);
+
+/** Computes the damped non-linear step of the SPGPE for every realisation of
+ * a 2D ensemble, each with independent noise.
+ *
+ * @param wfn The 2D ensemble.
+ * @param params Struct containing the parameters of the system.
+ * @param reservoir The parameters of the reservoir.
+ * @param step The index of the time step, which must differ between steps.
+ * @throws std::invalid_argument If the trap does not have one value per grid
+ * point.
+ */
+void interactionStep(EnsembleWavefunction2D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step);
+
+#endif  // BECPP_STOCHASTIC_H
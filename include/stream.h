@@ -0,0 +1,205 @@
+#ifndef BECPP_STREAM_H
+#define BECPP_STREAM_H
+
+#include "data.h"
+#include "grid.h"
+#include "wavefunction.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/** Struct containing the metadata of a raw snapshot file, as stored in its
+ * JSON index.
+ */
+struct RawSnapshotIndex {
+  std::vector<std::size_t> shape{};   ///< Spatial shape of a snapshot
+  std::vector<double> gridSpacing{};  ///< Grid spacing per axis
+  double intStrength{};               ///< Interaction strength
+  int numTimeSteps{};                 ///< Number of time steps of the run
+  std::complex<double> timeStep{};    ///< Time step increment
+  std::size_t snapshotBytes{};        ///< Size of a snapshot in bytes
+  std::size_t stride{};  ///< Distance between snapshots in bytes, a multiple
+                         /// of the page size
+  std::vector<double> times{};           ///< Time of each snapshot
+  std::vector<std::size_t> offsets{};  ///< Byte offset of each snapshot
+};
+
+/** Raw file of complex double snapshots, written through a memory mapping.
+ *
+ * Snapshots are stored back to back at page-aligned offsets in a file
+ * preallocated for the expected number of snapshots, and grown geometrically
+ * if exceeded. Appending a snapshot is a parallel copy into the mapping, with
+ * no per-write metadata or chunk bookkeeping, so output is limited by the
+ * disk alone. The layout is described by a small JSON index written next to
+ * the data, at <filename>.json, which also allows the file to be read with
+ * e.g. numpy.memmap.
+ */
+class RawSnapshotFile {
+ private:
+  std::string m_filename;
+  RawSnapshotIndex m_index;
+  int m_file{-1};
+  unsigned char* m_map{};
+  std::size_t m_capacity{};
+
+  void reserve(std::size_t capacity);
+  void unmap();
+
+ public:
+  /** Creates the file, truncating any existing one.
+   *
+   * @param filename The name of the data file.
+   * @param index The metadata of the snapshots. Only the fields describing
+   * the system are used; the layout fields are filled in.
+   * @param capacity The number of snapshots to preallocate.
+   */
+  RawSnapshotFile(std::string filename, RawSnapshotIndex index,
+                  std::size_t capacity);
+
+  /** Writes the index, trims the preallocation and closes the file.
+   */
+  ~RawSnapshotFile();
+
+  RawSnapshotFile(const RawSnapshotFile&) = delete;
+  RawSnapshotFile& operator=(const RawSnapshotFile&) = delete;
+
+  /** Appends a snapshot.
+   *
+   * @param snapshot The snapshot, of the shape of the index.
+   * @param time The simulation time of the snapshot.
+   */
+  void append(const complexVector_t& snapshot, double time);
+
+  /** Writes the mapped data to disk and updates the index.
+   */
+  void flush();
+
+  /** Returns the number of saved snapshots.
+   */
+  [[nodiscard]] std::size_t size() const;
+};
+
+/** Raw streaming counterpart of DataManager1D.
+ *
+ * Saves snapshots to a RawSnapshotFile instead of HDF5, for runs where
+ * output bandwidth matters most. Use convertRawToHDF5 to produce the file
+ * DataManager1D would have written.
+ */
+class RawDataManager1D {
+ private:
+  RawSnapshotFile m_file;
+
+ public:
+  /** Constructs the data manager and creates the raw file.
+   *
+   * @param filename The name of the data file.
+   * @param params The struct containing the system parameters.
+   * @param grid The 1D grid object of the system.
+   * @param options The options of the save system. Only saveInterval is used.
+   */
+  RawDataManager1D(const std::string& filename, const Parameters& params,
+                   const Grid1D& grid, const DataOptions& options = {});
+
+  /** Saves the current wave function data to the file.
+   *
+   * @param wfn The Wavefunction object of the system.
+   * @param time The simulation time of the snapshot, recorded in the index.
+   */
+  void saveWavefunctionData(Wavefunction1D& wfn, double time = 0.0);
+
+  /** Writes all saved data to disk and updates the index.
+   */
+  void flush();
+
+  /** Returns the number of saved snapshots.
+   */
+  [[nodiscard]] std::size_t numSnapshots() const;
+};
+
+/** Raw streaming counterpart of DataManager2D.
+ */
+class RawDataManager2D {
+ private:
+  RawSnapshotFile m_file;
+
+ public:
+  /** Constructs the data manager and creates the raw file.
+   *
+   * @param filename The name of the data file.
+   * @param params The struct containing the system parameters.
+   * @param grid The 2D grid object of the system.
+   * @param options The options of the save system. Only saveInterval is used.
+   */
+  RawDataManager2D(const std::string& filename, const Parameters& params,
+                   const Grid2D& grid, const DataOptions& options = {});
+
+  /** Saves the current wave function data to the file.
+   *
+   * @param wfn The Wavefunction object of the system.
+   * @param time The simulation time of the snapshot, recorded in the index.
+   */
+  void saveWavefunctionData(Wavefunction2D& wfn, double time = 0.0);
+
+  /** Writes all saved data to disk and updates the index.
+   */
+  void flush();
+
+  /** Returns the number of saved snapshots.
+   */
+  [[nodiscard]] std::size_t numSnapshots() const;
+};
+
+/** Raw streaming counterpart of DataManager3D.
+ */
+class RawDataManager3D {
+ private:
+  RawSnapshotFile m_file;
+
+ public:
+  /** Constructs the data manager and creates the raw file.
+   *
+   * @param filename The name of the data file.
+   * @param params The struct containing the system parameters.
+   * @param grid The 3D grid object of the system.
+   * @param options The options of the save system. Only saveInterval is used.
+   */
+  RawDataManager3D(const std::string& filename, const Parameters& params,
+                   const Grid3D& grid, const DataOptions& options = {});
+
+  /** Saves the current wave function data to the file.
+   *
+   * @param wfn The Wavefunction object of the system.
+   * @param time The simulation time of the snapshot, recorded in the index.
+   */
+  void saveWavefunctionData(Wavefunction3D& wfn, double time = 0.0);
+
+  /** Writes all saved data to disk and updates the index.
+   */
+  void flush();
+
+  /** Returns the number of saved snapshots.
+   */
+  [[nodiscard]] std::size_t numSnapshots() const;
+};
+
+/** Reads the JSON index of a raw snapshot file.
+ *
+ * @param filename The name of the data file.
+ */
+RawSnapshotIndex readRawSnapshotIndex(const std::string& filename);
+
+/** Converts a raw snapshot file to the HDF5 layout of the DataManager
+ * classes. The time of each snapshot is saved to /timeseries/snapshotTime,
+ * from which DataReader takes the snapshot times.
+ *
+ * @param rawFilename The name of the raw data file.
+ * @param filename The name of the HDF5 file to create.
+ * @param options The options of the HDF5 save system, e.g. the chunking,
+ * compression and fields of the converted snapshots. The downsampling and
+ * Fourier output options are ignored, as raw snapshots hold the full grid.
+ */
+void convertRawToHDF5(const std::string& rawFilename,
+                      const std::string& filename,
+                      const DataOptions& options = {});
+
+#endif  // BECPP_STREAM_H
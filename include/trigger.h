@@ -0,0 +1,59 @@
+#ifndef BECPP_TRIGGER_H
+#define BECPP_TRIGGER_H
+
+#include <optional>
+
+/** Directions in which an observable can cross a threshold.
+ */
+enum class Crossing {
+  rising,   ///< From below to at or above the threshold
+  falling,  ///< From at or above to below the threshold
+  either    ///< In either direction
+};
+
+/** Fires when an observable crosses a threshold, e.g. the kinetic energy
+ * rising past a level during a soliton decay.
+ *
+ * Used with DataManager1D::triggerEvent and its 2D and 3D counterparts to save
+ * the snapshots around the event.
+ */
+class ThresholdTrigger {
+ private:
+  double m_threshold;
+  Crossing m_direction;
+  std::optional<bool> m_above{};
+
+ public:
+  /** Constructs the trigger.
+   *
+   * @param threshold The threshold of the observable.
+   * @param direction The direction of the crossings that fire the trigger.
+   */
+  explicit ThresholdTrigger(double threshold,
+                            Crossing direction = Crossing::either);
+
+  /** Returns true if the observable crossed the threshold since the last
+   * update. The first update never fires.
+   *
+   * @param value The current value of the observable.
+   */
+  [[nodiscard]] bool update(double value);
+};
+
+/** Fires when an integer observable changes, e.g. the number of vortices
+ * after a reconnection.
+ */
+class ChangeTrigger {
+ private:
+  std::optional<long> m_last{};
+
+ public:
+  /** Returns true if the observable changed since the last update. The first
+   * update never fires.
+   *
+   * @param value The current value of the observable.
+   */
+  [[nodiscard]] bool update(long value);
+};
+
+#endif  // BECPP_TRIGGER_H
@@ -0,0 +1,113 @@
+#ifndef BECPP_VORTEX_H
+#define BECPP_VORTEX_H
+
+#include "grid.h"
+#include "wavefunction.h"
+#include <cstdint>
+#include <vector>
+
+/** Point vortex in the (x, y) plane, or a straight vortex line along z.
+ */
+struct Vortex {
+  double x{};     ///< x position of the core
+  double y{};     ///< y position of the core
+  int charge{1};  ///< Winding number, positive for anticlockwise circulation
+};
+
+/** Vortex ring in a 3D system, lying in an (x, y) plane with its axis along z.
+ */
+struct VortexRing {
+  double x{};       ///< x position of the centre of the ring
+  double y{};       ///< y position of the centre of the ring
+  double z{};       ///< z position of the centre of the ring
+  double radius{};  ///< Radius of the ring
+  int charge{1};    ///< Winding number of the core in the (rho, z) half
+                    /// plane. A positive ring propagates towards -z.
+};
+
+/** Samples random vortex positions on a 2D grid, with alternating charges +1
+ * and -1.
+ *
+ * Positions are drawn uniformly with the counter-based generator, and a
+ * candidate is rejected if it lies closer than minSeparation to any accepted
+ * vortex, measured across the periodic boundaries. Accepted vortices are
+ * stored in a spatial hash of cells at least minSeparation wide, so each
+ * candidate is only compared with the vortices of its 3x3 neighbouring cells.
+ *
+ * @param grid The 2D grid object of the system.
+ * @param numVortices The number of vortices, which must be even so that the
+ * total charge vanishes.
+ * @param minSeparation The minimum distance between two vortices.
+ * @param seed The seed of the generator.
+ * @param maxAttempts The maximum number of candidate positions drawn.
+ * @throws std::invalid_argument If the number of vortices is odd.
+ * @throws std::runtime_error If the vortices could not all be placed within
+ * the maximum number of attempts.
+ */
+std::vector<Vortex> randomVortices(Grid2D& grid, unsigned int numVortices,
+                                   double minSeparation, std::uint64_t seed,
+                                   unsigned int maxAttempts = 1000000);
+
+/** Samples random positions of straight vortex lines along z on a 3D grid.
+ *
+ * See the 2D overload for details, the positions being drawn in the (x, y)
+ * plane.
+ *
+ * @param grid The 3D grid object of the system.
+ * @param numVortices The number of vortex lines, which must be even.
+ * @param minSeparation The minimum distance between two lines.
+ * @param seed The seed of the generator.
+ * @param maxAttempts The maximum number of candidate positions drawn.
+ * @throws std::invalid_argument If the number of vortices is odd.
+ * @throws std::runtime_error If the vortices could not all be placed within
+ * the maximum number of attempts.
+ */
+std::vector<Vortex> randomVortices(Grid3D& grid, unsigned int numVortices,
+                                   double minSeparation, std::uint64_t seed,
+                                   unsigned int maxAttempts = 1000000);
+
+/** Imprints the phase of a set of vortices onto a 2D wave function.
+ *
+ * The phase is the doubly periodic phase of point vortices in the box, built
+ * from a sum over images, so it is continuous across the boundaries. This
+ * requires the total charge to vanish. The phase is evaluated row by row in
+ * parallel, with the terms that only depend on the row and the vortex
+ * computed once per row, and is multiplied directly into the position space
+ * vector, without storing the phase of each vortex. The Fourier space vector
+ * is updated afterwards.
+ *
+ * @param wfn The 2D wavefunction object.
+ * @param vortices The vortices to imprint.
+ * @throws std::invalid_argument If the total charge of the vortices is not
+ * zero.
+ */
+void imprintVortices(Wavefunction2D& wfn, const std::vector<Vortex>& vortices);
+
+/** Imprints the phase of a set of straight vortex lines along z onto a 3D
+ * wave function.
+ *
+ * Each (x, y) plane receives the phase imprinted by the 2D overload, which is
+ * evaluated once per (x, y) point.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param vortices The positions of the vortex lines in the (x, y) plane.
+ * @throws std::invalid_argument If the total charge of the vortices is not
+ * zero.
+ */
+void imprintVortices(Wavefunction3D& wfn, const std::vector<Vortex>& vortices);
+
+/** Imprints the phase of a set of vortex rings onto a 3D wave function.
+ *
+ * The phase of each ring is the solid-angle-like phase
+ * atan2(z - z0, rho - R) - atan2(z - z0, rho + R) of a ring of radius R, where
+ * rho is the distance from its axis. Unlike the phase of vortex lines, it is
+ * not periodic, so rings should lie well inside the box. The distance from
+ * the axis of each ring is computed once per (x, y) point.
+ *
+ * @param wfn The 3D wavefunction object.
+ * @param rings The vortex rings to imprint.
+ */
+void imprintVortexRings(Wavefunction3D& wfn,
+                        const std::vector<VortexRing>& rings);
+
+#endif  // BECPP_VORTEX_H
@@ -101,6 +101,15 @@ class Wavefunction1D {
    * @param component A complexVector_t containing the wave function state.
    */
   void setComponent(complexVector_t& component);
+
+  /** Sets the atom number the system is normalised to.
+   *
+   * Used to restore the atom number of a run resumed from saved data, whose
+   * state was not set through setComponent.
+   *
+   * @param atomNumber The atom number of the system.
+   */
+  void setAtomNumber(double atomNumber);
 };
 
 /** 2D wave function class.
@@ -187,6 +196,15 @@ class Wavefunction2D {
    * @param component A complexVector_t containing the wave function state.
    */
   void setComponent(complexVector_t& component);
+
+  /** Sets the atom number the system is normalised to.
+   *
+   * Used to restore the atom number of a run resumed from saved data, whose
+   * state was not set through setComponent.
+   *
+   * @param atomNumber The atom number of the system.
+   */
+  void setAtomNumber(double atomNumber);
 };
 
 /** 3D wave function class.
@@ -272,6 +290,15 @@ class Wavefunction3D {
    * @param component A complexVector_t containing the wave function state.
    */
   void setComponent(complexVector_t& component);
+
+  /** Sets the atom number the system is normalised to.
+   *
+   * Used to restore the atom number of a run resumed from saved data, whose
+   * state was not set through setComponent.
+   *
+   * @param atomNumber The atom number of the system.
+   */
+  void setAtomNumber(double atomNumber);
 };
 
 #endif  // BECPP_WAVEFUNCTION_H
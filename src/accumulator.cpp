@@ -0,0 +1,176 @@
+#include "accumulator.h"
+#include <algorithm>
+#include <stdexcept>
+
+std::string accumulatedFieldName(AccumulatedField field) {
+  switch (field) {
+    case AccumulatedField::momentumDensity:
+      return "momentumDensity";
+    default:
+      return "density";
+  }
+}
+
+// Index of each FFTW-ordered mode once every axis is shifted by half its
+// length, moving zero momentum to the centre
+std::vector<int> centredIndices(const std::vector<std::size_t>& shape) {
+  std::size_t size = 1;
+  for (auto points : shape) {
+    size *= points;
+  }
+
+  std::vector<int> indices(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    std::size_t remainder = i;
+    std::size_t stride = 1;
+    std::size_t index = 0;
+    for (std::size_t axis = shape.size(); axis-- > 0;) {
+      std::size_t points = shape[axis];
+      index += (remainder % points + points / 2) % points * stride;
+      remainder /= points;
+      stride *= points;
+    }
+    indices[i] = static_cast<int>(index);
+  }
+
+  return indices;
+}
+
+FieldAccumulator::FieldAccumulator(const Grid1D& grid,
+                                   std::vector<AccumulatedField> fields,
+                                   bool variance)
+    : m_shape{grid.shape()},
+      m_fields{std::move(fields)},
+      m_variance{variance},
+      m_momentumScale{grid.gridSpacing() / grid.shape()},
+      m_centredIndices{centredIndices(m_shape)} {
+  reset();
+}
+
+FieldAccumulator::FieldAccumulator(const Grid2D& grid,
+                                   std::vector<AccumulatedField> fields,
+                                   bool variance)
+    : m_fields{std::move(fields)}, m_variance{variance} {
+  auto [xPoints, yPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing] = grid.gridSpacing();
+  m_shape = {xPoints, yPoints};
+  m_momentumScale = xGridSpacing * yGridSpacing / (xPoints * yPoints);
+  m_centredIndices = centredIndices(m_shape);
+  reset();
+}
+
+FieldAccumulator::FieldAccumulator(const Grid3D& grid,
+                                   std::vector<AccumulatedField> fields,
+                                   bool variance)
+    : m_fields{std::move(fields)}, m_variance{variance} {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = grid.gridSpacing();
+  m_shape = {xPoints, yPoints, zPoints};
+  m_momentumScale = xGridSpacing * yGridSpacing * zGridSpacing /
+                    (static_cast<double>(xPoints) * yPoints * zPoints);
+  m_centredIndices = centredIndices(m_shape);
+  reset();
+}
+
+void FieldAccumulator::reset() {
+  std::size_t size = 1;
+  for (auto points : m_shape) {
+    size *= points;
+  }
+
+  m_count = 0;
+  m_means.assign(m_fields.size(), std::vector<double>(size, 0.0));
+  if (m_variance) {
+    m_squares.assign(m_fields.size(), std::vector<double>(size, 0.0));
+  }
+}
+
+void FieldAccumulator::accumulate(const complexVector_t& component,
+                                  const complexVector_t& fourierComponent) {
+  m_count += 1;
+
+  // Copy members to locals, as required by default(none)
+  double weight = 1.0 / static_cast<double>(m_count);
+  double momentumScale = m_momentumScale;
+  bool variance = m_variance;
+  int size = static_cast<int>(component.size());
+  int numFields = static_cast<int>(m_fields.size());
+  auto& fields = m_fields;
+  auto& centredIndices = m_centredIndices;
+  auto& means = m_means;
+  auto& squares = m_squares;
+
+  // Welford's update of every field in a single pass over the grid. Each mode
+  // is stored at its centred index, which is distinct for every i.
+#pragma omp parallel for                                                     \
+    shared(size, numFields, fields, component, fourierComponent,              \
+               centredIndices, momentumScale, weight, variance, means,        \
+               squares) default(none)
+  for (int i = 0; i < size; ++i) {
+    for (int field = 0; field < numFields; ++field) {
+      bool momentum = fields[field] == AccumulatedField::momentumDensity;
+      double value = momentum ? momentumScale * std::norm(fourierComponent[i])
+                              : std::norm(component[i]);
+      int index = momentum ? centredIndices[i] : i;
+      double delta = value - means[field][index];
+      means[field][index] += weight * delta;
+      if (variance) {
+        squares[field][index] += delta * (value - means[field][index]);
+      }
+    }
+  }
+}
+
+void FieldAccumulator::accumulate(Wavefunction1D& wfn) {
+  accumulate(wfn.component(), wfn.fourierComponent());
+}
+
+void FieldAccumulator::accumulate(Wavefunction2D& wfn) {
+  accumulate(wfn.component(), wfn.fourierComponent());
+}
+
+void FieldAccumulator::accumulate(Wavefunction3D& wfn) {
+  accumulate(wfn.component(), wfn.fourierComponent());
+}
+
+std::size_t FieldAccumulator::fieldIndex(AccumulatedField field) const {
+  auto position = std::find(m_fields.begin(), m_fields.end(), field);
+  if (position == m_fields.end()) {
+    throw std::invalid_argument("Field " + accumulatedFieldName(field) +
+                                " is not accumulated");
+  }
+
+  return position - m_fields.begin();
+}
+
+const std::vector<double>& FieldAccumulator::mean(
+    AccumulatedField field) const {
+  return m_means[fieldIndex(field)];
+}
+
+std::vector<double> FieldAccumulator::variance(AccumulatedField field) const {
+  if (!m_variance) {
+    throw std::logic_error("The variance is not kept by this accumulator");
+  }
+
+  const std::vector<double>& squares = m_squares[fieldIndex(field)];
+  std::vector<double> variance(squares.size(), 0.0);
+  if (m_count > 1) {
+    std::transform(squares.begin(), squares.end(), variance.begin(),
+                   [this](double square) { return square / m_count; });
+  }
+
+  return variance;
+}
+
+std::size_t FieldAccumulator::count() const { return m_count; }
+
+bool FieldAccumulator::keepsVariance() const { return m_variance; }
+
+const std::vector<AccumulatedField>& FieldAccumulator::fields() const {
+  return m_fields;
+}
+
+const std::vector<std::size_t>& FieldAccumulator::shape() const {
+  return m_shape;
+}
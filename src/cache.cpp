@@ -0,0 +1,288 @@
+#include "cache.h"
+#include "highfive/H5Exception.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <random>
+
+// 64-bit FNV-1a hash, chained through the seed
+std::uint64_t fnv1aHash(const void* data, std::size_t bytes,
+                        std::uint64_t seed = 14695981039346656037ULL) {
+  const auto* byte = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < bytes; ++i) {
+    seed ^= byte[i];
+    seed *= 1099511628211ULL;
+  }
+
+  return seed;
+}
+
+std::uint64_t GroundStateKey::hash() const {
+  std::uint64_t hash =
+      fnv1aHash(shape.data(), shape.size() * sizeof(unsigned int));
+  hash = fnv1aHash(gridSpacing.data(), gridSpacing.size() * sizeof(double),
+                   hash);
+  hash = fnv1aHash(&trapHash, sizeof(trapHash), hash);
+  hash = fnv1aHash(&intStrength, sizeof(intStrength), hash);
+  hash = fnv1aHash(&atomNumber, sizeof(atomNumber), hash);
+  hash = fnv1aHash(&tolerance, sizeof(tolerance), hash);
+
+  return hash;
+}
+
+bool GroundStateKey::sameSystem(const GroundStateKey& other) const {
+  return shape == other.shape && gridSpacing == other.gridSpacing &&
+         trapHash == other.trapHash;
+}
+
+GroundStateKey makeKey(const std::vector<unsigned int>& shape,
+                       const std::vector<double>& gridSpacing,
+                       const Parameters& params, double atomNumber,
+                       double tolerance) {
+  GroundStateKey key{};
+  key.shape = shape;
+  key.gridSpacing = gridSpacing;
+  key.trapHash =
+      fnv1aHash(params.trap.data(), params.trap.size() * sizeof(double));
+  key.intStrength = params.intStrength;
+  key.atomNumber = atomNumber;
+  key.tolerance = tolerance;
+
+  return key;
+}
+
+GroundStateKey makeGroundStateKey(const Grid1D& grid, const Parameters& params,
+                                  double atomNumber, double tolerance) {
+  return makeKey({grid.shape()}, {grid.gridSpacing()}, params, atomNumber,
+                 tolerance);
+}
+
+GroundStateKey makeGroundStateKey(const Grid2D& grid, const Parameters& params,
+                                  double atomNumber, double tolerance) {
+  auto [xPoints, yPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing] = grid.gridSpacing();
+  return makeKey({xPoints, yPoints}, {xGridSpacing, yGridSpacing}, params,
+                 atomNumber, tolerance);
+}
+
+GroundStateKey makeGroundStateKey(const Grid3D& grid, const Parameters& params,
+                                  double atomNumber, double tolerance) {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = grid.gridSpacing();
+  return makeKey({xPoints, yPoints, zPoints},
+                 {xGridSpacing, yGridSpacing, zGridSpacing}, params, atomNumber,
+                 tolerance);
+}
+
+void normaliseState(complexVector_t& state, double atomNumber,
+                    double cellVolume) {
+  double currentAtomNumber{};
+  for (const auto& value : state) {
+    currentAtomNumber += std::norm(value) * cellVolume;
+  }
+
+  double factor = std::sqrt(atomNumber / currentAtomNumber);
+  for (auto& value : state) {
+    value *= factor;
+  }
+}
+
+complexVector_t thomasFermiState(const std::vector<double>& trap,
+                                 double intStrength, double atomNumber,
+                                 double cellVolume) {
+  complexVector_t state(trap.size());
+  double minTrap = *std::min_element(trap.begin(), trap.end());
+
+  if (intStrength <= 0) {
+    for (int i = 0; i < trap.size(); ++i) {
+      state[i] = std::exp(-(trap[i] - minTrap));
+    }
+    normaliseState(state, atomNumber, cellVolume);
+    return state;
+  }
+
+  auto thomasFermiAtomNumber = [&](double chemicalPotential) {
+    double sum{};
+    for (const auto& potential : trap) {
+      sum += std::max(chemicalPotential - potential, 0.0);
+    }
+    return sum * cellVolume / intStrength;
+  };
+
+  // Bracket the chemical potential, then bisect
+  double lower = minTrap;
+  double upper = minTrap + 1.0;
+  while (thomasFermiAtomNumber(upper) < atomNumber) {
+    upper = minTrap + 2 * (upper - minTrap);
+  }
+  for (int i = 0; i < 100; ++i) {
+    double middle = 0.5 * (lower + upper);
+    if (thomasFermiAtomNumber(middle) < atomNumber) {
+      lower = middle;
+    } else {
+      upper = middle;
+    }
+  }
+
+  for (int i = 0; i < trap.size(); ++i) {
+    state[i] = std::sqrt(std::max(upper - trap[i], 0.0) / intStrength);
+  }
+  normaliseState(state, atomNumber, cellVolume);
+
+  return state;
+}
+
+GroundStateKey readGroundStateKey(const HighFive::File& file) {
+  GroundStateKey key{};
+  file.getDataSet("/key/shape").read(key.shape);
+  file.getDataSet("/key/gridSpacing").read(key.gridSpacing);
+  file.getDataSet("/key/trapHash").read(key.trapHash);
+  file.getDataSet("/key/intStrength").read(key.intStrength);
+  file.getDataSet("/key/atomNumber").read(key.atomNumber);
+  file.getDataSet("/key/tolerance").read(key.tolerance);
+
+  return key;
+}
+
+GroundStateCache::GroundStateCache(std::string directory)
+    : m_directory{std::move(directory)} {
+  std::filesystem::create_directories(m_directory);
+}
+
+std::string GroundStateCache::path(const GroundStateKey& key) const {
+  char name[21];
+  std::snprintf(name, sizeof(name), "%016llx.h5",
+                static_cast<unsigned long long>(key.hash()));
+
+  return (std::filesystem::path(m_directory) / name).string();
+}
+
+std::vector<std::pair<GroundStateKey, std::string>> GroundStateCache::entries()
+    const {
+  std::vector<std::pair<GroundStateKey, std::string>> entries{};
+  for (const auto& entry : std::filesystem::directory_iterator(m_directory)) {
+    if (entry.path().extension() != ".h5") {
+      continue;
+    }
+    try {
+      HighFive::File file{entry.path().string(), HighFive::File::ReadOnly};
+      entries.emplace_back(readGroundStateKey(file), entry.path().string());
+    } catch (const HighFive::Exception&) {
+      // Skip files that are not cached ground states
+    }
+  }
+
+  return entries;
+}
+
+bool GroundStateCache::contains(const GroundStateKey& key) const {
+  return std::filesystem::exists(path(key));
+}
+
+std::optional<complexVector_t> GroundStateCache::load(
+    const GroundStateKey& key) const {
+  if (!contains(key)) {
+    return std::nullopt;
+  }
+
+  HighFive::File file{path(key), HighFive::File::ReadOnly};
+  complexVector_t state{};
+  file.getDataSet("wavefunction").read(state);
+
+  return state;
+}
+
+void GroundStateCache::store(const GroundStateKey& key,
+                             const complexVector_t& state) const {
+  // Write under a unique temporary name so readers never see partial files
+  std::string temporary =
+      path(key) + "." + std::to_string(std::random_device{}()) + ".tmp";
+  {
+    HighFive::File file{temporary, HighFive::File::ReadWrite |
+                                       HighFive::File::Create |
+                                       HighFive::File::Truncate};
+    file.createDataSet("/key/shape", key.shape);
+    file.createDataSet("/key/gridSpacing", key.gridSpacing);
+    file.createDataSet("/key/trapHash", key.trapHash);
+    file.createDataSet("/key/intStrength", key.intStrength);
+    file.createDataSet("/key/atomNumber", key.atomNumber);
+    file.createDataSet("/key/tolerance", key.tolerance);
+    file.createDataSet("wavefunction", state);
+  }
+  std::filesystem::rename(temporary, path(key));
+}
+
+complexVector_t GroundStateCache::warmStart(const GroundStateKey& key,
+                                            const std::vector<double>& trap,
+                                            double cellVolume) const {
+  if (auto state = load(key)) {
+    return *state;
+  }
+
+  // Find the cached states of the same system either side of the interaction
+  // energy scale, which sets the Thomas-Fermi profile
+  double scale = key.intStrength * key.atomNumber;
+  double belowScale = -std::numeric_limits<double>::infinity();
+  double aboveScale = std::numeric_limits<double>::infinity();
+  std::string below{};
+  std::string above{};
+  for (const auto& [entryKey, entryPath] : entries()) {
+    if (!key.sameSystem(entryKey)) {
+      continue;
+    }
+    double entryScale = entryKey.intStrength * entryKey.atomNumber;
+    if (entryScale <= scale && entryScale > belowScale) {
+      belowScale = entryScale;
+      below = entryPath;
+    }
+    if (entryScale >= scale && entryScale < aboveScale) {
+      aboveScale = entryScale;
+      above = entryPath;
+    }
+  }
+
+  auto readState = [](const std::string& filename) {
+    HighFive::File file{filename, HighFive::File::ReadOnly};
+    complexVector_t state{};
+    file.getDataSet("wavefunction").read(state);
+    return state;
+  };
+
+  complexVector_t state{};
+  if (!below.empty() && !above.empty() && below != above) {
+    complexVector_t belowState = readState(below);
+    complexVector_t aboveState = readState(above);
+    double weight = (scale - belowScale) / (aboveScale - belowScale);
+    state.resize(belowState.size());
+    for (int i = 0; i < state.size(); ++i) {
+      state[i] = (1 - weight) * belowState[i] + weight * aboveState[i];
+    }
+  } else if (!below.empty() || !above.empty()) {
+    state = readState(below.empty() ? above : below);
+  } else {
+    return thomasFermiState(trap, key.intStrength, key.atomNumber, cellVolume);
+  }
+  normaliseState(state, key.atomNumber, cellVolume);
+
+  return state;
+}
+
+void cachedGroundState(Wavefunction3D& wfn, const Parameters& params,
+                       double atomNumber, const GroundStateOptions& options,
+                       const GroundStateCache& cache) {
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  GroundStateKey key =
+      makeGroundStateKey(wfn.grid(), params, atomNumber, options.tolerance);
+
+  if (auto cached = cache.load(key)) {
+    wfn.setComponent(*cached);
+    return;
+  }
+
+  complexVector_t initialState = cache.warmStart(
+      key, params.trap, xGridSpacing * yGridSpacing * zGridSpacing);
+  wfn.setComponent(initialState);
+  imaginaryTimeEvolution(wfn, params, options);
+  cache.store(key, wfn.component());
+}
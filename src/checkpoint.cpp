@@ -0,0 +1,208 @@
+#include "checkpoint.h"
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+
+// Set by the signal handler, and only ever read or cleared outside of it
+volatile std::sig_atomic_t checkpointSignalReceived = 0;
+volatile std::sig_atomic_t terminateSignalReceived = 0;
+
+extern "C" void handleCheckpointSignal(int signal) {
+  checkpointSignalReceived = 1;
+  if (signal == SIGTERM) {
+    terminateSignalReceived = 1;
+  }
+}
+
+CheckpointTrigger::CheckpointTrigger(
+    std::chrono::steady_clock::duration interval)
+    : m_interval{interval}, m_last{std::chrono::steady_clock::now()} {
+  checkpointSignalReceived = 0;
+  terminateSignalReceived = 0;
+  m_previousTerm = std::signal(SIGTERM, handleCheckpointSignal);
+  m_previousUsr1 = std::signal(SIGUSR1, handleCheckpointSignal);
+}
+
+CheckpointTrigger::~CheckpointTrigger() {
+  if (m_previousTerm != SIG_ERR) {
+    std::signal(SIGTERM, m_previousTerm);
+  }
+  if (m_previousUsr1 != SIG_ERR) {
+    std::signal(SIGUSR1, m_previousUsr1);
+  }
+}
+
+bool CheckpointTrigger::due() {
+  auto now = std::chrono::steady_clock::now();
+  if (checkpointSignalReceived != 0 || now - m_last >= m_interval) {
+    checkpointSignalReceived = 0;
+    m_last = now;
+    return true;
+  }
+
+  return false;
+}
+
+bool CheckpointTrigger::stopRequested() const {
+  return terminateSignalReceived != 0;
+}
+
+void writeCheckpointFile(const std::string& filename,
+                         const std::vector<std::size_t>& shape,
+                         const complexVector_t& wavefunction,
+                         double atomNumber, const Parameters& params,
+                         const CheckpointState& state) {
+  // Write under a unique temporary name so a killed job never leaves a
+  // partial checkpoint in place of the previous one
+  std::string temporary =
+      filename + "." + std::to_string(std::random_device{}()) + ".tmp";
+  {
+    HighFive::File file{temporary, HighFive::File::ReadWrite |
+                                       HighFive::File::Create |
+                                       HighFive::File::Truncate};
+
+    // Contiguous layout, so the state is written in a single call
+    file.createDataSet<std::complex<double>>("wavefunction",
+                                             HighFive::DataSpace(shape))
+        .write_raw(wavefunction.data());
+
+    file.createDataSet("/parameters/intStrength", params.intStrength);
+    file.createDataSet("/parameters/trap", params.trap);
+    file.createDataSet("/parameters/numTimeSteps", params.numTimeSteps);
+    file.createDataSet("/parameters/dt", params.timeStep);
+    file.createDataSet("/parameters/currentTime", params.currentTime);
+
+    file.createDataSet("/state/step", state.step);
+    file.createDataSet("/state/fourierSpace",
+                       static_cast<int>(state.fourierSpace));
+    file.createDataSet("/state/numSnapshots", state.numSnapshots);
+    file.createDataSet("/state/rngState", state.rngState);
+    file.createDataSet("/state/atomNumber", atomNumber);
+    // Stored as two lists, as the dataset paths hold slashes
+    if (!state.numRecords.empty()) {
+      std::vector<std::string> paths;
+      std::vector<std::size_t> numRecords;
+      for (const auto& [path, count] : state.numRecords) {
+        paths.push_back(path);
+        numRecords.push_back(count);
+      }
+      file.createDataSet("/state/recordPaths", paths);
+      file.createDataSet("/state/numRecords", numRecords);
+    }
+  }
+  std::filesystem::rename(temporary, filename);
+}
+
+CheckpointState readCheckpointFile(const std::string& filename,
+                                   const std::vector<std::size_t>& shape,
+                                   complexVector_t& component,
+                                   complexVector_t& fourierComponent,
+                                   double& atomNumber, Parameters& params) {
+  HighFive::File file{filename, HighFive::File::ReadOnly};
+
+  CheckpointState state{};
+  int fourierSpace{};
+  file.getDataSet("/state/step").read(state.step);
+  file.getDataSet("/state/fourierSpace").read(fourierSpace);
+  file.getDataSet("/state/numSnapshots").read(state.numSnapshots);
+  file.getDataSet("/state/rngState").read(state.rngState);
+  file.getDataSet("/state/atomNumber").read(atomNumber);
+  state.fourierSpace = fourierSpace != 0;
+  if (file.exist("/state/numRecords")) {
+    std::vector<std::string> paths;
+    std::vector<std::size_t> numRecords;
+    file.getDataSet("/state/recordPaths").read(paths);
+    file.getDataSet("/state/numRecords").read(numRecords);
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+      state.numRecords[paths[i]] = numRecords.at(i);
+    }
+  }
+
+  file.getDataSet("/parameters/intStrength").read(params.intStrength);
+  file.getDataSet("/parameters/trap").read(params.trap);
+  file.getDataSet("/parameters/numTimeSteps").read(params.numTimeSteps);
+  file.getDataSet("/parameters/dt").read(params.timeStep);
+  file.getDataSet("/parameters/currentTime").read(params.currentTime);
+
+  HighFive::DataSet wavefunction = file.getDataSet("wavefunction");
+  if (wavefunction.getDimensions() != shape) {
+    throw std::invalid_argument(
+        "Grid of the checkpoint does not match the wave function");
+  }
+  wavefunction.read(state.fourierSpace ? fourierComponent.data()
+                                       : component.data());
+
+  return state;
+}
+
+void writeCheckpoint(const std::string& filename, Wavefunction1D& wfn,
+                     const Parameters& params, const CheckpointState& state) {
+  writeCheckpointFile(
+      filename, {wfn.grid().shape()},
+      state.fourierSpace ? wfn.fourierComponent() : wfn.component(),
+      wfn.atomNumber(), params, state);
+}
+
+void writeCheckpoint(const std::string& filename, Wavefunction2D& wfn,
+                     const Parameters& params, const CheckpointState& state) {
+  auto [xPoints, yPoints] = wfn.grid().shape();
+  writeCheckpointFile(
+      filename, {xPoints, yPoints},
+      state.fourierSpace ? wfn.fourierComponent() : wfn.component(),
+      wfn.atomNumber(), params, state);
+}
+
+void writeCheckpoint(const std::string& filename, Wavefunction3D& wfn,
+                     const Parameters& params, const CheckpointState& state) {
+  auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
+  writeCheckpointFile(
+      filename, {xPoints, yPoints, zPoints},
+      state.fourierSpace ? wfn.fourierComponent() : wfn.component(),
+      wfn.atomNumber(), params, state);
+}
+
+// Brings the vector of the space that was not saved up to date, and restores
+// the atom number the run is normalised to
+template <typename Wavefunction>
+void restoreWavefunction(Wavefunction& wfn, const CheckpointState& state,
+                         double atomNumber) {
+  if (state.fourierSpace) {
+    wfn.ifft();
+  } else {
+    wfn.fft();
+  }
+  wfn.setAtomNumber(atomNumber);
+}
+
+CheckpointState readCheckpoint(const std::string& filename,
+                               Wavefunction1D& wfn, Parameters& params) {
+  double atomNumber{};
+  CheckpointState state =
+      readCheckpointFile(filename, {wfn.grid().shape()}, wfn.component(),
+                         wfn.fourierComponent(), atomNumber, params);
+  restoreWavefunction(wfn, state, atomNumber);
+  return state;
+}
+
+CheckpointState readCheckpoint(const std::string& filename,
+                               Wavefunction2D& wfn, Parameters& params) {
+  auto [xPoints, yPoints] = wfn.grid().shape();
+  double atomNumber{};
+  CheckpointState state =
+      readCheckpointFile(filename, {xPoints, yPoints}, wfn.component(),
+                         wfn.fourierComponent(), atomNumber, params);
+  restoreWavefunction(wfn, state, atomNumber);
+  return state;
+}
+
+CheckpointState readCheckpoint(const std::string& filename,
+                               Wavefunction3D& wfn, Parameters& params) {
+  auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
+  double atomNumber{};
+  CheckpointState state =
+      readCheckpointFile(filename, {xPoints, yPoints, zPoints},
+                         wfn.component(), wfn.fourierComponent(), atomNumber,
+                         params);
+  restoreWavefunction(wfn, state, atomNumber);
+  return state;
+}
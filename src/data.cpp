@@ -1,72 +1,1350 @@
 #include "data.h"
+#include <H5Dpublic.h>
+#include <H5Ppublic.h>
+#include <H5Zpublic.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <zlib.h>
+
+std::size_t product(const std::vector<std::size_t>& values) {
+  return std::accumulate(values.begin(), values.end(), std::size_t{1},
+                         std::multiplies<>());
+}
+
+std::size_t nextPrime(std::size_t number) {
+  auto isPrime = [](std::size_t candidate) {
+    if (candidate < 2) {
+      return false;
+    }
+    for (std::size_t divisor = 2; divisor * divisor <= candidate; ++divisor) {
+      if (candidate % divisor == 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  while (!isPrime(number)) {
+    number += 1;
+  }
+  return number;
+}
+
+// Chunks hold one time and a tile of the grid, found by halving the largest
+// spatial dimension until the chunk fits in the target size
+std::vector<std::size_t> snapshotChunkShape(
+    const std::vector<std::size_t>& shape, std::size_t elementBytes,
+    std::size_t chunkBytes) {
+  std::vector<std::size_t> chunk{1};
+  chunk.insert(chunk.end(), shape.begin(), shape.end());
+
+  while (product(chunk) * elementBytes > chunkBytes) {
+    auto largest = std::max_element(chunk.begin() + 1, chunk.end());
+    if (*largest == 1) {
+      break;
+    }
+    *largest = (*largest + 1) / 2;
+  }
+
+  return chunk;
+}
+
+// Size the chunk cache to hold a whole snapshot where possible, with a prime
+// number of slots as recommended by HDF5. Chunks are written once, so fully
+// written chunks are evicted first.
+HighFive::DataSetAccessProps snapshotAccessProps(
+    const std::vector<std::size_t>& shape,
+    const std::vector<std::size_t>& chunk, std::size_t elementBytes,
+    const DataOptions& options) {
+  std::size_t chunkBytes = product(chunk) * elementBytes;
+  std::size_t cacheBytes = std::max(
+      std::min(product(shape) * elementBytes, options.chunkCacheBytes),
+      chunkBytes);
+  std::size_t chunksInCache = cacheBytes / chunkBytes + 1;
+  HighFive::DataSetAccessProps accessProps;
+  accessProps.add(
+      HighFive::Caching(nextPrime(100 * chunksInCache), cacheBytes, 1.0));
+
+  return accessProps;
+}
+
+HighFive::DataSet createSnapshotDataSet(HighFive::File& file,
+                                        const std::string& name,
+                                        const std::vector<std::size_t>& shape,
+                                        const std::vector<std::size_t>& chunk,
+                                        const HighFive::DataType& dataType,
+                                        std::size_t capacity,
+                                        const DataOptions& options) {
+  // Define data space with arbitrary length of the time dimension
+  std::vector<std::size_t> dims{capacity};
+  std::vector<std::size_t> maxDims{HighFive::DataSpace::UNLIMITED};
+  dims.insert(dims.end(), shape.begin(), shape.end());
+  maxDims.insert(maxDims.end(), shape.begin(), shape.end());
+  HighFive::DataSpace dataSpace(dims, maxDims);
+
+  // Use chunking, with the shuffle and deflate filters when compressing
+  std::size_t elementBytes = dataType.getSize();
+  HighFive::DataSetCreateProps createProps;
+  createProps.add(
+      HighFive::Chunking(std::vector<hsize_t>(chunk.begin(), chunk.end())));
+  if (options.deflateLevel > 0) {
+    createProps.add(HighFive::Shuffle());
+    createProps.add(HighFive::Deflate(options.deflateLevel));
+  }
+
+  return file.createDataSet(
+      name, dataSpace, dataType, createProps,
+      snapshotAccessProps(shape, chunk, elementBytes, options));
+}
+
+SnapshotDataSet::SnapshotDataSet(HighFive::File& file, const std::string& name,
+                                 const std::vector<std::size_t>& shape,
+                                 const HighFive::DataType& dataType,
+                                 std::size_t capacity,
+                                 const DataOptions& options)
+    : m_shape{shape},
+      m_chunk{
+          snapshotChunkShape(shape, dataType.getSize(), options.chunkBytes)},
+      m_elementBytes{dataType.getSize()},
+      m_deflateLevel{options.deflateLevel},
+      m_mantissaBits{options.mantissaBits},
+      m_dataSet{createSnapshotDataSet(file, name, m_shape, m_chunk, dataType,
+                                      capacity, options)},
+      m_capacity{capacity} {
+  m_dataSet.createAttribute("numSnapshots", m_size);
+}
+
+// Reads the chunk shape and deflate level of an existing snapshot dataset
+std::pair<std::vector<std::size_t>, int> readSnapshotLayout(
+    const HighFive::DataSet& dataSet, std::size_t rank) {
+  hid_t createProps = H5Dget_create_plist(dataSet.getId());
+  std::vector<hsize_t> chunk(rank);
+  int chunkRank = H5Pget_chunk(createProps, static_cast<int>(rank),
+                               chunk.data());
+
+  int deflateLevel = 0;
+  for (int filter = 0; filter < H5Pget_nfilters(createProps); ++filter) {
+    unsigned int flags{};
+    std::size_t numValues = 1;
+    unsigned int level{};
+    if (H5Pget_filter2(createProps, filter, &flags, &numValues, &level, 0,
+                       nullptr, nullptr) == H5Z_FILTER_DEFLATE) {
+      deflateLevel = static_cast<int>(level);
+    }
+  }
+  H5Pclose(createProps);
+
+  if (chunkRank != static_cast<int>(rank)) {
+    throw std::invalid_argument("Snapshot dataset is not chunked");
+  }
+
+  return {{chunk.begin(), chunk.end()}, deflateLevel};
+}
+
+HighFive::DataSet openSnapshotDataSet(HighFive::File& file,
+                                      const std::string& name,
+                                      std::size_t elementBytes,
+                                      const DataOptions& options) {
+  HighFive::DataSet dataSet = file.getDataSet(name);
+  std::vector<std::size_t> dims = dataSet.getDimensions();
+  std::vector<std::size_t> shape(dims.begin() + 1, dims.end());
+  auto [chunk, deflateLevel] = readSnapshotLayout(dataSet, dims.size());
+
+  // Reopen with the chunk cache sized as for a new dataset
+  return file.getDataSet(
+      name, snapshotAccessProps(shape, chunk, elementBytes, options));
+}
+
+SnapshotDataSet::SnapshotDataSet(HighFive::File& file, const std::string& name,
+                                 const HighFive::DataType& dataType,
+                                 std::size_t size, const DataOptions& options)
+    : m_elementBytes{dataType.getSize()},
+      m_mantissaBits{options.mantissaBits},
+      m_dataSet{openSnapshotDataSet(file, name, m_elementBytes, options)},
+      m_size{size} {
+  std::vector<std::size_t> dims = m_dataSet.getDimensions();
+  m_shape.assign(dims.begin() + 1, dims.end());
+  std::tie(m_chunk, m_deflateLevel) =
+      readSnapshotLayout(m_dataSet, dims.size());
+  m_capacity = dims[0];
+
+  if (m_size > m_capacity) {
+    throw std::invalid_argument("Dataset " + name + " holds fewer snapshots " +
+                                "than the run being resumed");
+  }
+
+  // Snapshots past the resumed ones are discarded from now on
+  if (m_dataSet.hasAttribute("numSnapshots")) {
+    writeSize();
+  } else {
+    m_dataSet.createAttribute("numSnapshots", m_size);
+  }
+}
+
+SnapshotDataSet::~SnapshotDataSet() {
+  try {
+    if (m_size < m_capacity) {
+      std::vector<std::size_t> dims{m_size};
+      dims.insert(dims.end(), m_shape.begin(), m_shape.end());
+      m_dataSet.resize(dims);
+    }
+  } catch (const std::exception&) {
+    // Leave the preallocated extent rather than throwing from a destructor
+  }
+}
+
+void SnapshotDataSet::writeSize() {
+  m_dataSet.getAttribute("numSnapshots").write(m_size);
+}
+
+void SnapshotDataSet::reserve(std::size_t capacity) {
+  if (capacity <= m_capacity) {
+    return;
+  }
+
+  m_capacity = std::max(capacity, 2 * m_capacity);
+  std::vector<std::size_t> dims{m_capacity};
+  dims.insert(dims.end(), m_shape.begin(), m_shape.end());
+  m_dataSet.resize(dims);
+}
+
+// Rounds doubles to nearest with the given number of mantissa bits. The
+// discarded bits are zeroed, which the shuffle and deflate filters compress
+// well. Infinities and NaNs are left untouched.
+void roundMantissa(std::vector<unsigned char>& bytes, int mantissaBits) {
+  int droppedBits = 52 - std::max(mantissaBits, 0);
+  if (droppedBits <= 0) {
+    return;
+  }
+
+  constexpr std::uint64_t exponentMask = 0x7ff0000000000000;
+  std::uint64_t half = std::uint64_t{1} << (droppedBits - 1);
+  std::uint64_t mask = ~((std::uint64_t{1} << droppedBits) - 1);
+  for (std::size_t i = 0; i + sizeof(double) <= bytes.size();
+       i += sizeof(double)) {
+    std::uint64_t bits{};
+    std::memcpy(&bits, &bytes[i], sizeof(double));
+    if ((bits & exponentMask) != exponentMask) {
+      bits = (bits + half) & mask;
+    }
+    std::memcpy(&bytes[i], &bits, sizeof(double));
+  }
+}
+
+// Same byte ordering as the HDF5 shuffle filter: byte b of element i is moved
+// to b * numElements + i
+std::vector<unsigned char> shuffleBytes(const std::vector<unsigned char>& bytes,
+                                        std::size_t elementBytes) {
+  std::size_t numElements = bytes.size() / elementBytes;
+  std::vector<unsigned char> shuffled(bytes.size());
+  for (std::size_t i = 0; i < numElements; ++i) {
+    for (std::size_t byte = 0; byte < elementBytes; ++byte) {
+      shuffled[byte * numElements + i] = bytes[i * elementBytes + byte];
+    }
+  }
+
+  return shuffled;
+}
+
+// Same stream format as the HDF5 deflate filter
+bool deflateBytes(const std::vector<unsigned char>& bytes, int level,
+                  std::vector<unsigned char>& compressed) {
+  uLongf size = compressBound(bytes.size());
+  compressed.resize(size);
+  if (compress2(compressed.data(), &size, bytes.data(), bytes.size(), level) !=
+      Z_OK) {
+    return false;
+  }
+  compressed.resize(size);
+
+  return true;
+}
+
+void SnapshotDataSet::writeCompressed(const void* data, bool isDouble) {
+  // Pad the spatial shape and chunk to three dimensions, keeping the last
+  // dimension contiguous
+  std::size_t rank = m_shape.size();
+  std::array<std::size_t, 3> shape{1, 1, 1};
+  std::array<std::size_t, 3> chunk{1, 1, 1};
+  std::array<std::size_t, 3> numChunks{};
+  for (std::size_t d = 0; d < rank; ++d) {
+    shape[3 - rank + d] = m_shape[d];
+    chunk[3 - rank + d] = m_chunk[d + 1];
+  }
+  for (int d = 0; d < 3; ++d) {
+    numChunks[d] = (shape[d] + chunk[d] - 1) / chunk[d];
+  }
+  std::size_t totalChunks = numChunks[0] * numChunks[1] * numChunks[2];
+
+  const auto* source = static_cast<const unsigned char*>(data);
+  std::size_t elementBytes = m_elementBytes;
+  int deflateLevel = m_deflateLevel;
+  int mantissaBits = isDouble ? m_mantissaBits : 52;
+  std::vector<std::vector<unsigned char>> compressed(totalChunks);
+  bool failed = false;
+
+#pragma omp parallel for schedule(dynamic)                                   \
+    shared(shape, chunk, numChunks, totalChunks, source, elementBytes,        \
+               deflateLevel, mantissaBits, compressed, failed) default(none)
+  for (std::size_t n = 0; n < totalChunks; ++n) {
+    std::size_t ci = n / (numChunks[1] * numChunks[2]);
+    std::size_t cj = (n / numChunks[2]) % numChunks[1];
+    std::size_t ck = n % numChunks[2];
+
+    // Edge chunks are stored at full size, padded with zeros
+    std::vector<unsigned char> bytes(
+        chunk[0] * chunk[1] * chunk[2] * elementBytes, 0);
+    std::size_t rowElements = std::min(chunk[2], shape[2] - ck * chunk[2]);
+    for (std::size_t i = 0; i < chunk[0] && ci * chunk[0] + i < shape[0];
+         ++i) {
+      for (std::size_t j = 0; j < chunk[1] && cj * chunk[1] + j < shape[1];
+           ++j) {
+        std::size_t from =
+            ((ci * chunk[0] + i) * shape[1] + cj * chunk[1] + j) * shape[2] +
+            ck * chunk[2];
+        std::size_t to = (i * chunk[1] + j) * chunk[2];
+        std::memcpy(&bytes[to * elementBytes], source + from * elementBytes,
+                    rowElements * elementBytes);
+      }
+    }
+
+    roundMantissa(bytes, mantissaBits);
+    if (!deflateBytes(shuffleBytes(bytes, elementBytes), deflateLevel,
+                      compressed[n])) {
+#pragma omp atomic write
+      failed = true;
+    }
+  }
+  if (failed) {
+    throw std::runtime_error("Failed to compress snapshot chunk");
+  }
+
+  // HDF5 is not thread-safe, so the compressed chunks are written serially
+  for (std::size_t n = 0; n < totalChunks; ++n) {
+    std::array<hsize_t, 3> chunkOffset{
+        n / (numChunks[1] * numChunks[2]) * chunk[0],
+        (n / numChunks[2]) % numChunks[1] * chunk[1],
+        n % numChunks[2] * chunk[2]};
+    std::vector<hsize_t> offset{m_size};
+    offset.insert(offset.end(), chunkOffset.end() - rank, chunkOffset.end());
+
+    if (H5Dwrite_chunk(m_dataSet.getId(), H5P_DEFAULT, 0, offset.data(),
+                       compressed[n].size(), compressed[n].data()) < 0) {
+      throw std::runtime_error("Failed to write snapshot chunk");
+    }
+  }
+}
+
+std::vector<std::size_t> SnapshotDataSet::offset(std::size_t index) const {
+  std::vector<std::size_t> offset(m_shape.size() + 1, 0);
+  offset[0] = index;
+
+  return offset;
+}
+
+std::vector<std::size_t> SnapshotDataSet::count() const {
+  std::vector<std::size_t> count{1};
+  count.insert(count.end(), m_shape.begin(), m_shape.end());
+
+  return count;
+}
+
+std::size_t SnapshotDataSet::size() const { return m_size; }
+
+HighFive::DataSet& SnapshotDataSet::dataSet() { return m_dataSet; }
+
+// Name and datatype of the dataset of an output field
+std::pair<std::string, HighFive::DataType> fieldDataSet(OutputField field) {
+  switch (field) {
+    case OutputField::wavefunctionFloat:
+      return {"wavefunctionFloat", HighFive::AtomicType<std::complex<float>>()};
+    case OutputField::density:
+      return {"density", HighFive::AtomicType<float>()};
+    case OutputField::phase:
+      return {"phase", HighFive::AtomicType<float>()};
+    default:
+      return {"wavefunction", HighFive::AtomicType<std::complex<double>>()};
+  }
+}
+
+// Rounds the doubles of a complex vector in place, in parallel
+void roundMantissa(complexVector_t& values, int mantissaBits) {
+  int droppedBits = 52 - std::max(mantissaBits, 0);
+  if (droppedBits <= 0) {
+    return;
+  }
+
+  std::uint64_t exponentMask = 0x7ff0000000000000;
+  std::uint64_t half = std::uint64_t{1} << (droppedBits - 1);
+  std::uint64_t mask = ~((std::uint64_t{1} << droppedBits) - 1);
+  auto* doubles = reinterpret_cast<double*>(values.data());
+  long size = 2 * static_cast<long>(values.size());
+#pragma omp parallel for shared(size, doubles, exponentMask, half, mask) \
+    default(none)
+  for (long i = 0; i < size; ++i) {
+    std::uint64_t bits{};
+    std::memcpy(&bits, &doubles[i], sizeof(double));
+    if ((bits & exponentMask) != exponentMask) {
+      bits = (bits + half) & mask;
+    }
+    std::memcpy(&doubles[i], &bits, sizeof(double));
+  }
+}
+
+// XORs the bits of the doubles of two complex vectors into the target
+void xorBits(complexVector_t& target, const complexVector_t& values) {
+  auto* targetDoubles = reinterpret_cast<double*>(target.data());
+  const auto* doubles = reinterpret_cast<const double*>(values.data());
+  long size = 2 * static_cast<long>(values.size());
+#pragma omp parallel for shared(size, targetDoubles, doubles) default(none)
+  for (long i = 0; i < size; ++i) {
+    std::uint64_t targetBits{};
+    std::uint64_t bits{};
+    std::memcpy(&targetBits, &targetDoubles[i], sizeof(double));
+    std::memcpy(&bits, &doubles[i], sizeof(double));
+    targetBits ^= bits;
+    std::memcpy(&targetDoubles[i], &targetBits, sizeof(double));
+  }
+}
+
+complexVector_t readDeltaSnapshot(const HighFive::DataSet& dataSet,
+                                  std::size_t index,
+                                  std::size_t keyframeInterval,
+                                  const std::vector<std::size_t>& offset,
+                                  const std::vector<std::size_t>& count) {
+  std::vector<std::size_t> snapshotOffset{index};
+  std::vector<std::size_t> snapshotCount{1};
+  snapshotOffset.insert(snapshotOffset.end(), offset.begin(), offset.end());
+  snapshotCount.insert(snapshotCount.end(), count.begin(), count.end());
+
+  // Start from the keyframe, and apply each delta up to the snapshot
+  std::size_t keyframe = index - index % std::max<std::size_t>(
+                                             keyframeInterval, 1);
+  complexVector_t snapshot(product(count));
+  complexVector_t delta(snapshot.size());
+  snapshotOffset[0] = keyframe;
+  dataSet.select(snapshotOffset, snapshotCount).read(snapshot.data());
+  for (std::size_t frame = keyframe + 1; frame <= index; ++frame) {
+    snapshotOffset[0] = frame;
+    dataSet.select(snapshotOffset, snapshotCount).read(delta.data());
+    xorBits(snapshot, delta);
+  }
+
+  return snapshot;
+}
+
+SnapshotFields::SnapshotFields(HighFive::File& file,
+                               const std::vector<std::size_t>& shape,
+                               std::size_t capacity,
+                               const DataOptions& options)
+    : m_fields{options.fields},
+      m_keyframeInterval{options.keyframeInterval},
+      m_mantissaBits{options.mantissaBits},
+      m_index{options.resumeSnapshots.value_or(0)} {
+  // Delta-encoded snapshots are rounded before encoding, not when written
+  DataOptions deltaOptions = options;
+  deltaOptions.mantissaBits = 52;
+
+  for (const auto& field : m_fields) {
+    auto [name, dataType] = fieldDataSet(field);
+    bool deltaEncoded =
+        m_keyframeInterval > 0 && field == OutputField::wavefunction;
+    const DataOptions& fieldOptions = deltaEncoded ? deltaOptions : options;
+    if (options.resumeSnapshots) {
+      m_dataSets.push_back(std::make_unique<SnapshotDataSet>(
+          file, name, dataType, *options.resumeSnapshots, fieldOptions));
+    } else {
+      m_dataSets.push_back(std::make_unique<SnapshotDataSet>(
+          file, name, shape, dataType, capacity, fieldOptions));
+    }
+
+    // A resumed run between keyframes continues the delta chain from the
+    // last saved snapshot
+    if (deltaEncoded && m_index % m_keyframeInterval != 0) {
+      std::vector<std::size_t> spatialShape = m_dataSets.back()->count();
+      spatialShape.erase(spatialShape.begin());
+      m_previous = readDeltaSnapshot(
+          m_dataSets.back()->dataSet(), m_index - 1, m_keyframeInterval,
+          std::vector<std::size_t>(spatialShape.size(), 0), spatialShape);
+    }
+  }
+}
+
+const complexVector_t& SnapshotFields::encodeDelta(
+    const complexVector_t& snapshot) {
+  bool keyframe = m_index % m_keyframeInterval == 0;
+  m_delta = snapshot;
+  roundMantissa(m_delta, m_mantissaBits);
+  if (keyframe) {
+    m_previous = m_delta;
+    return m_delta;
+  }
+
+  // XOR in place, then swap so that the rounded snapshot becomes the previous
+  // one of the next delta
+  xorBits(m_previous, m_delta);
+  std::swap(m_previous, m_delta);
+  return m_delta;
+}
+
+void SnapshotFields::append(const complexVector_t& snapshot) {
+  int size = static_cast<int>(snapshot.size());
+
+  for (int field = 0; field < m_fields.size(); ++field) {
+    switch (m_fields[field]) {
+      case OutputField::wavefunction:
+        if (m_keyframeInterval > 0) {
+          m_dataSets[field]->append(encodeDelta(snapshot).data());
+        } else {
+          m_dataSets[field]->append(snapshot.data());
+        }
+        break;
+      case OutputField::wavefunctionFloat: {
+        auto& buffer = m_complexBuffer;
+        buffer.resize(size);
+#pragma omp parallel for shared(size, snapshot, buffer) default(none)
+        for (int i = 0; i < size; ++i) {
+          buffer[i] = std::complex<float>(snapshot[i]);
+        }
+        m_dataSets[field]->append(buffer.data());
+        break;
+      }
+      case OutputField::density: {
+        auto& buffer = m_realBuffer;
+        buffer.resize(size);
+#pragma omp parallel for shared(size, snapshot, buffer) default(none)
+        for (int i = 0; i < size; ++i) {
+          buffer[i] = static_cast<float>(std::norm(snapshot[i]));
+        }
+        m_dataSets[field]->append(buffer.data());
+        break;
+      }
+      case OutputField::phase: {
+        auto& buffer = m_realBuffer;
+        buffer.resize(size);
+#pragma omp parallel for shared(size, snapshot, buffer) default(none)
+        for (int i = 0; i < size; ++i) {
+          buffer[i] = static_cast<float>(std::arg(snapshot[i]));
+        }
+        m_dataSets[field]->append(buffer.data());
+        break;
+      }
+    }
+  }
+
+  m_index += 1;
+}
+
+SnapshotWriter::SnapshotWriter(std::size_t numBuffers, WriteFunction write)
+    : m_write{std::move(write)},
+      m_free(std::max<std::size_t>(numBuffers, 1)),
+      m_thread{&SnapshotWriter::run, this} {}
+
+SnapshotWriter::~SnapshotWriter() {
+  {
+    std::lock_guard lock{m_mutex};
+    m_stop = true;
+  }
+  m_queued.notify_one();
+  m_thread.join();
+}
+
+void SnapshotWriter::run() {
+  std::unique_lock lock{m_mutex};
+  while (true) {
+    m_queued.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+    if (m_queue.empty()) {
+      return;
+    }
+
+    complexVector_t buffer = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_writing = true;
+    bool failed = m_error != nullptr;
+    lock.unlock();
+
+    // Write without holding the lock, so compute can stage the next snapshot
+    std::exception_ptr error{};
+    if (!failed) {
+      try {
+        m_write(buffer);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+
+    lock.lock();
+    if (error) {
+      m_error = error;
+    }
+    m_writing = false;
+    m_free.push_back(std::move(buffer));
+    m_written.notify_all();
+  }
+}
+
+void SnapshotWriter::rethrowError() {
+  if (m_error) {
+    std::rethrow_exception(std::exchange(m_error, nullptr));
+  }
+}
+
+void SnapshotWriter::push(const complexVector_t& snapshot) {
+  complexVector_t buffer{};
+  {
+    std::unique_lock lock{m_mutex};
+    m_written.wait(lock, [this] { return !m_free.empty() || m_error; });
+    rethrowError();
+    buffer = std::move(m_free.back());
+    m_free.pop_back();
+  }
+
+  // Reuses the capacity of the staging buffer after the first snapshot
+  buffer.assign(snapshot.begin(), snapshot.end());
+
+  {
+    std::lock_guard lock{m_mutex};
+    m_queue.push_back(std::move(buffer));
+  }
+  m_queued.notify_one();
+}
+
+void SnapshotWriter::flush() {
+  std::unique_lock lock{m_mutex};
+  m_written.wait(lock, [this] { return m_queue.empty() && !m_writing; });
+  rethrowError();
+}
+
+// Cuts every record dataset of a group back to its number of records at the
+// checkpoint being resumed, keyed by dataset path in
+// DataOptions::resumeRecords, and adds the kept counts to resumed. Records
+// written after the checkpoint would otherwise be followed by the same
+// records again, written by the resumed run.
+void resumeRecordDataSets(HighFive::File& file, const std::string& group,
+                          const DataOptions& options,
+                          std::map<std::string, std::size_t>& resumed) {
+  if (!options.resumeSnapshots || !file.exist(group)) {
+    return;
+  }
+
+  for (const auto& name : file.getGroup(group).listObjectNames()) {
+    std::string path = group + "/" + name;
+    auto record = options.resumeRecords.find(path);
+    std::size_t size =
+        record == options.resumeRecords.end() ? 0 : record->second;
+
+    HighFive::DataSet dataSet = file.getDataSet(path);
+    std::vector<std::size_t> dims = dataSet.getDimensions();
+    if (size > dims[0]) {
+      throw std::invalid_argument("Dataset " + path + " holds fewer " +
+                                  "records than the run being resumed");
+    }
+    if (size < dims[0]) {
+      dims[0] = size;
+      dataSet.resize(dims);
+    }
+    resumed[path] = size;
+  }
+}
+
+RegionOutputs::RegionOutputs(HighFive::File& file,
+                             std::vector<std::size_t> gridShape,
+                             const DataOptions& options)
+    : m_file{file},
+      m_gridShape{std::move(gridShape)},
+      m_chunkBytes{options.chunkBytes} {
+  resumeRecordDataSets(m_file, "/regions", options, m_resumed);
+  resumeRecordDataSets(m_file, "/probes", options, m_resumed);
+}
+
+RegionOutputs::~RegionOutputs() {
+  try {
+    write();
+  } catch (const std::exception&) {
+    // Drop the buffered records rather than throwing from a destructor
+  }
+}
+
+// Number of records buffered per block, so that a block fills a chunk
+std::size_t recordBlockLength(std::size_t chunkBytes, std::size_t recordBytes) {
+  return std::max<std::size_t>(chunkBytes / recordBytes, 1);
+}
+
+// Creates an extendible (t, ...) dataset of records chunked by block, or
+// opens the existing one to append to
+HighFive::DataSet recordDataSet(HighFive::File& file, const std::string& name,
+                                const std::vector<std::size_t>& shape,
+                                std::size_t blockLength,
+                                const HighFive::DataType& dataType) {
+  std::vector<std::size_t> dims{0};
+  dims.insert(dims.end(), shape.begin(), shape.end());
+  if (file.exist(name)) {
+    HighFive::DataSet dataSet = file.getDataSet(name);
+    if (dataSet.getDimensions().size() != dims.size() ||
+        !std::equal(shape.begin(), shape.end(),
+                    dataSet.getDimensions().begin() + 1)) {
+      throw std::invalid_argument("Shape of the existing dataset " + name +
+                                  " does not match");
+    }
+    return dataSet;
+  }
+
+  std::vector<std::size_t> maxDims{HighFive::DataSpace::UNLIMITED};
+  std::vector<hsize_t> chunk{blockLength};
+  maxDims.insert(maxDims.end(), shape.begin(), shape.end());
+  chunk.insert(chunk.end(), shape.begin(), shape.end());
+
+  HighFive::DataSetCreateProps createProps;
+  createProps.add(HighFive::Chunking(chunk));
+  return file.createDataSet(name, HighFive::DataSpace(dims, maxDims), dataType,
+                            createProps);
+}
+
+// Appends a block of records after the first size records of a dataset
+template <typename T>
+void appendRecords(HighFive::DataSet& dataSet,
+                   const std::vector<std::size_t>& shape, std::size_t size,
+                   std::size_t numRecords, const T* records) {
+  std::vector<std::size_t> dims{size + numRecords};
+  std::vector<std::size_t> offset(shape.size() + 1, 0);
+  std::vector<std::size_t> count{numRecords};
+  dims.insert(dims.end(), shape.begin(), shape.end());
+  count.insert(count.end(), shape.begin(), shape.end());
+  offset[0] = size;
+
+  dataSet.resize(dims);
+  dataSet.select(offset, count).write_raw(records);
+}
+
+void RegionOutputs::addOutput(const std::string& name,
+                              const std::vector<std::size_t>& shape,
+                              std::vector<std::size_t> indices) {
+  std::size_t blockLength = recordBlockLength(
+      m_chunkBytes, indices.size() * sizeof(std::complex<double>));
+  HighFive::DataSet dataSet =
+      recordDataSet(m_file, name, shape, blockLength,
+                    HighFive::AtomicType<std::complex<double>>());
+  std::size_t size = dataSet.getDimensions()[0];
+
+  m_outputs.push_back({name, dataSet, shape, std::move(indices), blockLength,
+                       {}, 0, size});
+  Output& output = m_outputs.back();
+  output.buffer.resize(output.blockLength * output.indices.size());
+}
+
+void RegionOutputs::addRegion(const std::string& name,
+                              const std::vector<std::size_t>& offset,
+                              const std::vector<std::size_t>& count) {
+  std::size_t rank = m_gridShape.size();
+  if (offset.size() != rank || count.size() != rank) {
+    throw std::invalid_argument("Region " + name +
+                                " does not match the rank of the grid");
+  }
+  for (std::size_t axis = 0; axis < rank; ++axis) {
+    if (count[axis] == 0 || offset[axis] + count[axis] > m_gridShape[axis]) {
+      throw std::invalid_argument("Region " + name + " is outside the grid");
+    }
+  }
+
+  // Flat indices of the region in row-major order, the last axis fastest
+  std::vector<std::size_t> indices(product(count));
+  std::vector<std::size_t> position(rank, 0);
+  for (auto& index : indices) {
+    index = 0;
+    for (std::size_t axis = 0; axis < rank; ++axis) {
+      index = index * m_gridShape[axis] + offset[axis] + position[axis];
+    }
+    for (std::size_t axis = rank; axis-- > 0;) {
+      if (++position[axis] < count[axis]) {
+        break;
+      }
+      position[axis] = 0;
+    }
+  }
+
+  addOutput("/regions/" + name, count, std::move(indices));
+}
+
+void RegionOutputs::addProbes(
+    const std::string& name,
+    const std::vector<std::vector<std::size_t>>& points) {
+  if (points.empty()) {
+    throw std::invalid_argument("Probe list " + name + " is empty");
+  }
+
+  std::vector<std::size_t> indices;
+  indices.reserve(points.size());
+  for (const auto& point : points) {
+    if (point.size() != m_gridShape.size()) {
+      throw std::invalid_argument("Probe of " + name +
+                                  " does not match the rank of the grid");
+    }
+
+    std::size_t index = 0;
+    for (std::size_t axis = 0; axis < point.size(); ++axis) {
+      if (point[axis] >= m_gridShape[axis]) {
+        throw std::invalid_argument("Probe of " + name +
+                                    " is outside the grid");
+      }
+      index = index * m_gridShape[axis] + point[axis];
+    }
+    indices.push_back(index);
+  }
+
+  addOutput("/probes/" + name, {points.size()}, std::move(indices));
+}
+
+bool RegionOutputs::record(const complexVector_t& component) {
+  bool full = false;
+  for (auto& output : m_outputs) {
+    std::size_t numPoints = output.indices.size();
+    std::complex<double>* record = &output.buffer[output.buffered * numPoints];
+    for (std::size_t i = 0; i < numPoints; ++i) {
+      record[i] = component[output.indices[i]];
+    }
+
+    output.buffered += 1;
+    full = full || output.buffered == output.blockLength;
+  }
+
+  return full;
+}
+
+std::map<std::string, std::size_t> RegionOutputs::numRecords() const {
+  std::map<std::string, std::size_t> numRecords = m_resumed;
+  for (const auto& output : m_outputs) {
+    numRecords[output.name] = output.size + output.buffered;
+  }
+  return numRecords;
+}
+
+void RegionOutputs::write() {
+  for (auto& output : m_outputs) {
+    if (output.buffered == 0) {
+      continue;
+    }
+
+    appendRecords(output.dataSet, output.shape, output.size, output.buffered,
+                  output.buffer.data());
+    output.size += output.buffered;
+    output.buffered = 0;
+  }
+}
+
+TimeSeriesOutputs::TimeSeriesOutputs(HighFive::File& file,
+                                     const DataOptions& options)
+    : m_file{file}, m_chunkBytes{options.chunkBytes} {
+  resumeRecordDataSets(m_file, "/timeseries", options, m_resumed);
+}
+
+TimeSeriesOutputs::~TimeSeriesOutputs() {
+  try {
+    write();
+  } catch (const std::exception&) {
+    // Drop the buffered records rather than throwing from a destructor
+  }
+}
+
+bool TimeSeriesOutputs::record(const std::string& name, const double* values,
+                               std::size_t width, bool scalar) {
+  auto series = m_series.find(name);
+  if (series == m_series.end()) {
+    if (width == 0) {
+      throw std::invalid_argument("Time series " + name + " is empty");
+    }
+
+    Series newSeries{};
+    newSeries.shape = scalar ? std::vector<std::size_t>{}
+                             : std::vector<std::size_t>{width};
+    newSeries.width = width;
+    newSeries.blockLength =
+        recordBlockLength(m_chunkBytes, width * sizeof(double));
+    newSeries.buffer.resize(newSeries.blockLength * width);
+    series = m_series.emplace(name, std::move(newSeries)).first;
+  } else if (series->second.width != width ||
+             series->second.shape.empty() != scalar) {
+    throw std::invalid_argument("Time series " + name +
+                                " changed its number of values");
+  }
+
+  Series& recorded = series->second;
+  std::copy(values, values + width,
+            recorded.buffer.begin() + recorded.buffered * width);
+  recorded.buffered += 1;
+
+  return recorded.buffered == recorded.blockLength;
+}
+
+void TimeSeriesOutputs::write() {
+  for (auto& [name, series] : m_series) {
+    if (series.buffered == 0) {
+      continue;
+    }
+
+    // Datasets are created on the first write, so recording never touches
+    // the file
+    if (!series.dataSet) {
+      series.dataSet =
+          recordDataSet(m_file, "/timeseries/" + name, series.shape,
+                        series.blockLength, HighFive::AtomicType<double>());
+      series.size = series.dataSet->getDimensions()[0];
+    }
+
+    appendRecords(*series.dataSet, series.shape, series.size, series.buffered,
+                  series.buffer.data());
+    series.size += series.buffered;
+    series.buffered = 0;
+  }
+}
+
+std::map<std::string, std::size_t> TimeSeriesOutputs::numRecords() const {
+  std::map<std::string, std::size_t> numRecords = m_resumed;
+  for (const auto& [name, series] : m_series) {
+    // Before its first write, a series continues from its resumed records
+    std::size_t& count = numRecords["/timeseries/" + name];
+    count = (series.dataSet ? series.size : count) + series.buffered;
+  }
+  return numRecords;
+}
+
+SnapshotRingBuffer::SnapshotRingBuffer(std::size_t capacity,
+                                       int deflateLevel)
+    : m_frames(capacity), m_deflateLevel{deflateLevel} {}
+
+// Inverse of shuffleBytes, writing the elements to the output
+void unshuffleBytes(const std::vector<unsigned char>& shuffled,
+                    std::size_t elementBytes, unsigned char* bytes) {
+  std::size_t numElements = shuffled.size() / elementBytes;
+  for (std::size_t i = 0; i < numElements; ++i) {
+    for (std::size_t byte = 0; byte < elementBytes; ++byte) {
+      bytes[i * elementBytes + byte] = shuffled[byte * numElements + i];
+    }
+  }
+}
+
+void SnapshotRingBuffer::store(const complexVector_t& snapshot, Frame& frame) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(snapshot.data());
+  std::size_t numBytes = snapshot.size() * sizeof(std::complex<double>);
+  frame.size = snapshot.size();
+  if (m_deflateLevel <= 0) {
+    frame.blocks.resize(1);
+    frame.blocks[0].assign(bytes, bytes + numBytes);
+    return;
+  }
+
+  // Independent blocks of whole doubles, compressed in parallel
+  std::size_t blockBytes = std::size_t{1} << 20;
+  int numBlocks = static_cast<int>((numBytes + blockBytes - 1) / blockBytes);
+  int deflateLevel = m_deflateLevel;
+  bool failed = false;
+  auto& blocks = frame.blocks;
+  blocks.resize(numBlocks);
+#pragma omp parallel for schedule(dynamic)                                   \
+    shared(numBlocks, blockBytes, numBytes, bytes, deflateLevel, blocks,      \
+               failed) default(none)
+  for (int block = 0; block < numBlocks; ++block) {
+    std::size_t begin = block * blockBytes;
+    std::size_t end = std::min(begin + blockBytes, numBytes);
+    std::vector<unsigned char> shuffled = shuffleBytes(
+        std::vector<unsigned char>(bytes + begin, bytes + end), sizeof(double));
+    if (!deflateBytes(shuffled, deflateLevel, blocks[block])) {
+#pragma omp atomic write
+      failed = true;
+    }
+  }
+
+  if (failed) {
+    throw std::runtime_error("Failed to compress a buffered snapshot");
+  }
+}
+
+void SnapshotRingBuffer::load(const Frame& frame) {
+  m_snapshot.resize(frame.size);
+  auto* bytes = reinterpret_cast<unsigned char*>(m_snapshot.data());
+  std::size_t numBytes = frame.size * sizeof(std::complex<double>);
+  if (m_deflateLevel <= 0) {
+    std::memcpy(bytes, frame.blocks[0].data(), numBytes);
+    return;
+  }
+
+  std::size_t blockBytes = std::size_t{1} << 20;
+  int numBlocks = static_cast<int>(frame.blocks.size());
+  bool failed = false;
+  const auto& blocks = frame.blocks;
+#pragma omp parallel for schedule(dynamic)                                   \
+    shared(numBlocks, blockBytes, numBytes, bytes, blocks, failed)            \
+    default(none)
+  for (int block = 0; block < numBlocks; ++block) {
+    std::size_t begin = block * blockBytes;
+    std::vector<unsigned char> shuffled(std::min(blockBytes, numBytes - begin));
+    uLongf size = shuffled.size();
+    if (uncompress(shuffled.data(), &size, blocks[block].data(),
+                   blocks[block].size()) != Z_OK ||
+        size != shuffled.size()) {
+#pragma omp atomic write
+      failed = true;
+      continue;
+    }
+    unshuffleBytes(shuffled, sizeof(double), bytes + begin);
+  }
+
+  if (failed) {
+    throw std::runtime_error("Failed to decompress a buffered snapshot");
+  }
+}
+
+void SnapshotRingBuffer::push(const complexVector_t& snapshot, double time) {
+  if (m_frames.empty()) {
+    return;
+  }
+
+  std::size_t index = (m_first + m_size) % m_frames.size();
+  if (m_size == m_frames.size()) {
+    // Overwrite the oldest frame
+    m_first = (m_first + 1) % m_frames.size();
+  } else {
+    m_size += 1;
+  }
+  store(snapshot, m_frames[index]);
+  m_frames[index].time = time;
+}
+
+void SnapshotRingBuffer::drain(
+    const std::function<void(const complexVector_t&, double)>& save) {
+  for (std::size_t i = 0; i < m_size; ++i) {
+    const Frame& frame = m_frames[(m_first + i) % m_frames.size()];
+    load(frame);
+    save(m_snapshot, frame.time);
+  }
+  m_first = 0;
+  m_size = 0;
+}
+
+std::size_t SnapshotRingBuffer::size() const { return m_size; }
+
+unsigned int openFlags(const DataOptions& options) {
+  if (options.resumeSnapshots) {
+    return HighFive::File::ReadWrite;
+  }
+
+  return HighFive::File::ReadWrite | HighFive::File::Create |
+         HighFive::File::Truncate;
+}
+
+std::unique_ptr<SnapshotWriter> makeSnapshotWriter(
+    const DataOptions& options, SnapshotFields& snapshots) {
+  // Without any fields there is nothing to write, e.g. when only saving
+  // projections or regions
+  if (options.writeBuffers == 0 || options.fields.empty()) {
+    return nullptr;
+  }
+
+  return std::make_unique<SnapshotWriter>(
+      options.writeBuffers, [&snapshots](const complexVector_t& snapshot) {
+        snapshots.append(snapshot);
+      });
+}
+
+template <typename Downsampler, typename Grid>
+std::unique_ptr<Downsampler> makeDownsampler(const Grid& grid,
+                                             const DataOptions& options) {
+  if (options.downsampling <= 1) {
+    return nullptr;
+  }
+
+  return std::make_unique<Downsampler>(grid, options.downsampling);
+}
+
+void saveOutputParameters(HighFive::File& file, const DataOptions& options) {
+  file.createDataSet("/parameters/saveInterval", options.saveInterval);
+  file.createDataSet("/parameters/downsampling", options.downsampling);
+  file.createDataSet("/parameters/fourierOutput",
+                     static_cast<int>(options.fourierOutput));
+  file.createDataSet("/parameters/keyframeInterval", options.keyframeInterval);
+}
+
+std::unique_ptr<SnapshotRingBuffer> makeRingBuffer(
+    const DataOptions& options) {
+  if (options.ringBufferSnapshots == 0 && options.postEventSnapshots == 0) {
+    return nullptr;
+  }
+
+  return std::make_unique<SnapshotRingBuffer>(options.ringBufferSnapshots,
+                                              options.ringBufferDeflateLevel);
+}
+
+std::size_t snapshotCapacity(const Parameters& params,
+                             const DataOptions& options) {
+  std::size_t saveInterval = std::max(options.saveInterval, 1);
+  std::size_t numTimeSteps = std::max(params.numTimeSteps, 0);
+
+  return std::max<std::size_t>(
+      (numTimeSteps + saveInterval - 1) / saveInterval, 1);
+}
+
+std::vector<std::size_t> gridShape(const Grid1D& grid) {
+  return {grid.shape()};
+}
+
+std::vector<std::size_t> gridShape(const Grid2D& grid) {
+  auto [xPoints, yPoints] = grid.shape();
+  return {xPoints, yPoints};
+}
+
+std::vector<std::size_t> gridShape(const Grid3D& grid) {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  return {xPoints, yPoints, zPoints};
+}
+
+// Writes a dataset, overwriting the existing one of the same shape
+void overwriteDataSet(HighFive::File& file, const std::string& name,
+                      const std::vector<std::size_t>& shape,
+                      const std::vector<double>& values) {
+  if (file.exist(name)) {
+    HighFive::DataSet dataSet = file.getDataSet(name);
+    if (dataSet.getDimensions() != shape) {
+      throw std::invalid_argument("Shape of the existing dataset " + name +
+                                  " does not match");
+    }
+    dataSet.write_raw(values.data());
+  } else {
+    file.createDataSet<double>(name, HighFive::DataSpace(shape))
+        .write_raw(values.data());
+  }
+}
+
+void saveAccumulator(HighFive::File& file,
+                     const FieldAccumulator& accumulator) {
+  const std::vector<std::size_t>& shape = accumulator.shape();
+  for (const auto& field : accumulator.fields()) {
+    std::string group = "/accumulators/" + accumulatedFieldName(field);
+    overwriteDataSet(file, group + "/mean", shape, accumulator.mean(field));
+    if (accumulator.keepsVariance()) {
+      overwriteDataSet(file, group + "/variance", shape,
+                       accumulator.variance(field));
+    }
+  }
+
+  if (file.exist("/accumulators/count")) {
+    file.getDataSet("/accumulators/count").write(accumulator.count());
+  } else {
+    file.createDataSet("/accumulators/count", accumulator.count());
+  }
+}
 
 DataManager1D::DataManager1D(const std::string& filename,
-                             const Parameters& params, const Grid1D& grid)
+                             const Parameters& params, const Grid1D& grid,
+                             const DataOptions& options)
     : filename{filename},
-      file{filename, HighFive::File::ReadWrite | HighFive::File::Create |
-                         HighFive::File::Truncate} {
-  saveParameters(params, grid);
-  generateWavefunctionDatasets(grid);
+      file{filename, openFlags(options)},
+      m_downsampler{makeDownsampler<SpectralDownsampler1D>(grid, options)},
+      m_fourierOutput{options.fourierOutput},
+      m_snapshots{generateWavefunctionDatasets(
+          params, m_downsampler ? m_downsampler->grid() : grid, options)},
+      m_regions{file, gridShape(grid), options},
+      m_timeSeries{file, options},
+      m_ringBuffer{makeRingBuffer(options)},
+      m_postEventSnapshots{options.postEventSnapshots},
+      m_numSnapshots{options.resumeSnapshots.value_or(0)} {
+  if (!options.resumeSnapshots) {
+    saveParameters(params, m_downsampler ? m_downsampler->grid() : grid,
+                   options);
+  }
+  m_writer = makeSnapshotWriter(options, m_snapshots);
 }
 
 void DataManager1D::saveParameters(const Parameters& params,
-                                   const Grid1D& grid) {
+                                   const Grid1D& grid,
+                                   const DataOptions& options) {
   // Save condensate and time parameters to file
   file.createDataSet("/parameters/intStrength", params.intStrength);
   file.createDataSet("/parameters/numTimeSteps", params.numTimeSteps);
   file.createDataSet("/parameters/dt", params.timeStep);
+  saveOutputParameters(file, options);
 
   // Save grid parameters to file
   file.createDataSet("/grid/xPoints", grid.shape());
   file.createDataSet("/grid/xGridSpacing", grid.gridSpacing());
 }
 
-void DataManager1D::generateWavefunctionDatasets(const Grid1D& grid) {
-  // Define data space with arbitrary length of last dimension
-  HighFive::DataSpace dsWavefunction = HighFive::DataSpace(
-      {grid.shape(), 1}, {grid.shape(), HighFive::DataSpace::UNLIMITED});
+SnapshotFields DataManager1D::generateWavefunctionDatasets(
+    const Parameters& params, const Grid1D& grid, const DataOptions& options) {
+  return {file, {grid.shape()}, snapshotCapacity(params, options), options};
+}
 
-  // Use chunking
-  HighFive::DataSetCreateProps props;
-  props.add(HighFive::Chunking(std::vector<hsize_t>{(grid.shape()) / 4, 1}));
+const complexVector_t& DataManager1D::snapshotData(Wavefunction1D& wfn) {
+  if (m_downsampler) {
+    // Only the coarse grid is transformed back to position space
+    return m_downsampler->downsample(wfn, m_fourierOutput);
+  }
+  if (m_fourierOutput) {
+    return wfn.fourierComponent();
+  }
 
-  // Create wavefunction dataset
-  file.createDataSet("wavefunction", dsWavefunction,
-                     HighFive::AtomicType<std::complex<double>>(), props);
+  // FFT so we update real-space arrays
+  wfn.ifft();
+  return wfn.component();
 }
 
 void DataManager1D::saveWavefunctionData(Wavefunction1D& wfn) {
-  // Load in datasets
-  HighFive::DataSet dsWavefunction = file.getDataSet("wavefunction");
+  // Event-triggered snapshots are indexed by /timeseries/snapshotTime, which
+  // a snapshot saved here would leave out of step
+  if (m_ringBuffer) {
+    throw std::logic_error(
+        "Snapshots are saved by bufferWavefunctionData when "
+        "DataOptions::ringBufferSnapshots or "
+        "DataOptions::postEventSnapshots is set");
+  }
 
-  // Resize datasets
-  dsWavefunction.resize({wfn.grid().shape(), m_saveIndex + 1});
+  saveSnapshot(snapshotData(wfn));
+}
 
-  // FFT so we update real-space arrays
-  wfn.ifft();
+void DataManager1D::bufferWavefunctionData(Wavefunction1D& wfn, double time) {
+  if (!m_ringBuffer) {
+    throw std::logic_error(
+        "Buffering snapshots requires DataOptions::ringBufferSnapshots or "
+        "DataOptions::postEventSnapshots");
+  }
+
+  if (m_remainingEventSnapshots > 0) {
+    m_remainingEventSnapshots -= 1;
+    saveTimedSnapshot(snapshotData(wfn), time);
+  } else {
+    m_ringBuffer->push(snapshotData(wfn), time);
+  }
+}
+
+void DataManager1D::triggerEvent(double time) {
+  if (!m_ringBuffer) {
+    throw std::logic_error(
+        "Events require DataOptions::ringBufferSnapshots or "
+        "DataOptions::postEventSnapshots");
+  }
 
+  recordScalar("eventTime", time);
+  m_ringBuffer->drain(
+      [this](const complexVector_t& snapshot, double snapshotTime) {
+        saveTimedSnapshot(snapshot, snapshotTime);
+      });
+  m_remainingEventSnapshots = m_postEventSnapshots;
+}
+
+void DataManager1D::saveTimedSnapshot(const complexVector_t& snapshot,
+                                      double time) {
+  saveSnapshot(snapshot);
+  recordScalar("snapshotTime", time);
+}
+
+void DataManager1D::saveSnapshot(const complexVector_t& snapshot) {
   // Save new wavefunction data
-  dsWavefunction.select({0, m_saveIndex}, {wfn.grid().shape(), 1})
-      .write(wfn.component());
+  if (m_writer) {
+    m_writer->push(snapshot);
+  } else {
+    m_snapshots.append(snapshot);
+  }
+  m_numSnapshots += 1;
+}
+
+void DataManager1D::addRegion(const std::string& name,
+                              const std::vector<std::size_t>& offset,
+                              const std::vector<std::size_t>& count) {
+  writeBufferedData();
+  m_regions.addRegion(name, offset, count);
+}
+
+void DataManager1D::addProbes(
+    const std::string& name,
+    const std::vector<std::vector<std::size_t>>& points) {
+  writeBufferedData();
+  m_regions.addProbes(name, points);
+}
+
+void DataManager1D::saveRegionData(Wavefunction1D& wfn) {
+  if (m_regions.record(wfn.component())) {
+    writeBufferedData();
+  }
+}
+
+void DataManager1D::saveAccumulatorData(
+    const FieldAccumulator& accumulator) {
+  // HDF5 calls must wait for the I/O thread to finish pending snapshots
+  if (m_writer) {
+    m_writer->flush();
+  }
+  saveAccumulator(file, accumulator);
+}
+
+void DataManager1D::recordScalar(const std::string& name, double value) {
+  if (m_timeSeries.record(name, &value, 1, true)) {
+    writeBufferedData();
+  }
+}
+
+void DataManager1D::recordSeries(const std::string& name,
+                                 const std::vector<double>& values) {
+  if (m_timeSeries.record(name, values.data(), values.size(), false)) {
+    writeBufferedData();
+  }
+}
+
+void DataManager1D::writeBufferedData() {
+  // HDF5 calls must wait for the I/O thread to finish pending snapshots
+  if (m_writer) {
+    m_writer->flush();
+  }
+  m_regions.write();
+  m_timeSeries.write();
+}
 
-  m_saveIndex += 1;
+void DataManager1D::flush() {
+  writeBufferedData();
+  file.flush();
+}
+
+std::size_t DataManager1D::numSnapshots() const { return m_numSnapshots; }
+
+std::map<std::string, std::size_t> DataManager1D::numRecords() const {
+  std::map<std::string, std::size_t> numRecords = m_regions.numRecords();
+  numRecords.merge(m_timeSeries.numRecords());
+  return numRecords;
 }
 
 DataManager2D::DataManager2D(const std::string& filename,
-                             const Parameters& params, const Grid2D& grid)
+                             const Parameters& params, const Grid2D& grid,
+                             const DataOptions& options)
     : filename{filename},
-      file{filename, HighFive::File::ReadWrite | HighFive::File::Create |
-                         HighFive::File::Truncate} {
-  saveParameters(params, grid);
-  generateWavefunctionDatasets(grid);
+      file{filename, openFlags(options)},
+      m_downsampler{makeDownsampler<SpectralDownsampler2D>(grid, options)},
+      m_fourierOutput{options.fourierOutput},
+      m_snapshots{generateWavefunctionDatasets(
+          params, m_downsampler ? m_downsampler->grid() : grid, options)},
+      m_regions{file, gridShape(grid), options},
+      m_timeSeries{file, options},
+      m_ringBuffer{makeRingBuffer(options)},
+      m_postEventSnapshots{options.postEventSnapshots},
+      m_numSnapshots{options.resumeSnapshots.value_or(0)} {
+  if (!options.resumeSnapshots) {
+    saveParameters(params, m_downsampler ? m_downsampler->grid() : grid,
+                   options);
+  }
+  m_writer = makeSnapshotWriter(options, m_snapshots);
 }
 
 void DataManager2D::saveParameters(const Parameters& params,
-                                   const Grid2D& grid) {
+                                   const Grid2D& grid,
+                                   const DataOptions& options) {
   // Save condensate and time parameters to file
   file.createDataSet("/parameters/intStrength", params.intStrength);
   file.createDataSet("/parameters/numTimeSteps", params.numTimeSteps);
   file.createDataSet("/parameters/dt", params.timeStep);
+  saveOutputParameters(file, options);
 
   // Save grid parameters to file
   auto [xPoints, yPoints] = grid.shape();
@@ -78,60 +1356,190 @@ void DataManager2D::saveParameters(const Parameters& params,
   file.createDataSet("/grid/yGridSpacing", yGridSpacing);
 }
 
-void DataManager2D::generateWavefunctionDatasets(const Grid2D& grid) {
+SnapshotFields DataManager2D::generateWavefunctionDatasets(
+    const Parameters& params, const Grid2D& grid, const DataOptions& options) {
   auto [xPoints, yPoints] = grid.shape();
 
-  // Define data space with arbitrary length of last dimension
-  HighFive::DataSpace dsWavefunction =
-      HighFive::DataSpace({xPoints * yPoints, 1},
-                          {xPoints * yPoints, HighFive::DataSpace::UNLIMITED});
+  return {file, {xPoints, yPoints}, snapshotCapacity(params, options),
+          options};
+}
 
-  // Use chunking
-  HighFive::DataSetCreateProps props;
-  props.add(
-      HighFive::Chunking(std::vector<hsize_t>{(xPoints * yPoints) / 4, 1}));
+const complexVector_t& DataManager2D::snapshotData(Wavefunction2D& wfn) {
+  if (m_downsampler) {
+    // Only the coarse grid is transformed back to position space
+    return m_downsampler->downsample(wfn, m_fourierOutput);
+  }
+  if (m_fourierOutput) {
+    return wfn.fourierComponent();
+  }
 
-  // Create wavefunction dataset
-  file.createDataSet("wavefunction", dsWavefunction,
-                     HighFive::AtomicType<std::complex<double>>(), props);
+  return wfn.component();
 }
 
 void DataManager2D::saveWavefunctionData(Wavefunction2D& wfn) {
-  // Load in datasets
-  HighFive::DataSet dsWavefunction = file.getDataSet("wavefunction");
+  // Event-triggered snapshots are indexed by /timeseries/snapshotTime, which
+  // a snapshot saved here would leave out of step
+  if (m_ringBuffer) {
+    throw std::logic_error(
+        "Snapshots are saved by bufferWavefunctionData when "
+        "DataOptions::ringBufferSnapshots or "
+        "DataOptions::postEventSnapshots is set");
+  }
+
+  saveSnapshot(snapshotData(wfn));
+}
+
+void DataManager2D::bufferWavefunctionData(Wavefunction2D& wfn, double time) {
+  if (!m_ringBuffer) {
+    throw std::logic_error(
+        "Buffering snapshots requires DataOptions::ringBufferSnapshots or "
+        "DataOptions::postEventSnapshots");
+  }
 
-  // Resize datasets
-  auto [xPoints, yPoints] = wfn.grid().shape();
-  dsWavefunction.resize({xPoints * yPoints, m_saveIndex + 1});
+  if (m_remainingEventSnapshots > 0) {
+    m_remainingEventSnapshots -= 1;
+    saveTimedSnapshot(snapshotData(wfn), time);
+  } else {
+    m_ringBuffer->push(snapshotData(wfn), time);
+  }
+}
 
+void DataManager2D::triggerEvent(double time) {
+  if (!m_ringBuffer) {
+    throw std::logic_error(
+        "Events require DataOptions::ringBufferSnapshots or "
+        "DataOptions::postEventSnapshots");
+  }
+
+  recordScalar("eventTime", time);
+  m_ringBuffer->drain(
+      [this](const complexVector_t& snapshot, double snapshotTime) {
+        saveTimedSnapshot(snapshot, snapshotTime);
+      });
+  m_remainingEventSnapshots = m_postEventSnapshots;
+}
+
+void DataManager2D::saveTimedSnapshot(const complexVector_t& snapshot,
+                                      double time) {
+  saveSnapshot(snapshot);
+  recordScalar("snapshotTime", time);
+}
+
+void DataManager2D::saveSnapshot(const complexVector_t& snapshot) {
   // Save new wavefunction data
-  dsWavefunction.select({0, m_saveIndex}, {xPoints * yPoints, 1})
-      .write(wfn.component());
+  if (m_writer) {
+    m_writer->push(snapshot);
+  } else {
+    m_snapshots.append(snapshot);
+  }
+  m_numSnapshots += 1;
+}
+
+void DataManager2D::addRegion(const std::string& name,
+                              const std::vector<std::size_t>& offset,
+                              const std::vector<std::size_t>& count) {
+  writeBufferedData();
+  m_regions.addRegion(name, offset, count);
+}
+
+void DataManager2D::addProbes(
+    const std::string& name,
+    const std::vector<std::vector<std::size_t>>& points) {
+  writeBufferedData();
+  m_regions.addProbes(name, points);
+}
+
+void DataManager2D::saveRegionData(Wavefunction2D& wfn) {
+  if (m_regions.record(wfn.component())) {
+    writeBufferedData();
+  }
+}
+
+void DataManager2D::saveAccumulatorData(
+    const FieldAccumulator& accumulator) {
+  // HDF5 calls must wait for the I/O thread to finish pending snapshots
+  if (m_writer) {
+    m_writer->flush();
+  }
+  saveAccumulator(file, accumulator);
+}
+
+void DataManager2D::recordScalar(const std::string& name, double value) {
+  if (m_timeSeries.record(name, &value, 1, true)) {
+    writeBufferedData();
+  }
+}
 
-  m_saveIndex += 1;
+void DataManager2D::recordSeries(const std::string& name,
+                                 const std::vector<double>& values) {
+  if (m_timeSeries.record(name, values.data(), values.size(), false)) {
+    writeBufferedData();
+  }
+}
+
+void DataManager2D::writeBufferedData() {
+  // HDF5 calls must wait for the I/O thread to finish pending snapshots
+  if (m_writer) {
+    m_writer->flush();
+  }
+  m_regions.write();
+  m_timeSeries.write();
+}
+
+void DataManager2D::flush() {
+  writeBufferedData();
+  file.flush();
+}
+
+std::size_t DataManager2D::numSnapshots() const { return m_numSnapshots; }
+
+std::map<std::string, std::size_t> DataManager2D::numRecords() const {
+  std::map<std::string, std::size_t> numRecords = m_regions.numRecords();
+  numRecords.merge(m_timeSeries.numRecords());
+  return numRecords;
 }
 
 DataManager3D::DataManager3D(const std::string& filename,
-                             const Parameters& params, const Grid3D& grid)
+                             const Parameters& params, const Grid3D& grid,
+                             const DataOptions& options)
     : filename{filename},
-      file{filename, HighFive::File::ReadWrite | HighFive::File::Create |
-                         HighFive::File::Truncate} {
-  saveParameters(params, grid);
-  generateWavefunctionDatasets(grid);
+      file{filename, openFlags(options)},
+      m_downsampler{makeDownsampler<SpectralDownsampler3D>(grid, options)},
+      m_fourierOutput{options.fourierOutput},
+      m_snapshots{generateWavefunctionDatasets(
+          params, m_downsampler ? m_downsampler->grid() : grid, options)},
+      m_regions{file, gridShape(grid), options},
+      m_timeSeries{file, options},
+      m_ringBuffer{makeRingBuffer(options)},
+      m_postEventSnapshots{options.postEventSnapshots},
+      m_options{options},
+      m_capacity{snapshotCapacity(params, options)},
+      m_gridShape{gridShape(grid)},
+      m_fourierGridSpacing{std::apply(
+          [](auto... spacing) { return std::vector<double>{spacing...}; },
+          grid.fourierGridSpacing())},
+      m_numSnapshots{options.resumeSnapshots.value_or(0)} {
+  if (!options.resumeSnapshots) {
+    saveParameters(params, m_downsampler ? m_downsampler->grid() : grid,
+                   options);
+  }
+  m_writer = makeSnapshotWriter(options, m_snapshots);
 }
 
 void DataManager3D::saveParameters(const Parameters& params,
-                                   const Grid3D& grid) {
+                                   const Grid3D& grid,
+                                   const DataOptions& options) {
   // Save condensate and time parameters to file
   file.createDataSet("/parameters/intStrength", params.intStrength);
   file.createDataSet("/parameters/numTimeSteps", params.numTimeSteps);
   file.createDataSet("/parameters/dt", params.timeStep);
+  saveOutputParameters(file, options);
 
   // Save grid parameters to file
   auto [xPoints, yPoints, zPoints] = grid.shape();
   file.createDataSet("/grid/xPoints", xPoints);
   file.createDataSet("/grid/yPoints", yPoints);
-  file.createDataSet("/grid/zPoints", yPoints);
+  file.createDataSet("/grid/zPoints", zPoints);
 
   auto [xGridSpacing, yGridSpacing, zGridSpacing] = grid.gridSpacing();
   file.createDataSet("/grid/xGridSpacing", xGridSpacing);
@@ -139,37 +1547,230 @@ void DataManager3D::saveParameters(const Parameters& params,
   file.createDataSet("/grid/zGridSpacing", zGridSpacing);
 }
 
-void DataManager3D::generateWavefunctionDatasets(const Grid3D& grid) {
+SnapshotFields DataManager3D::generateWavefunctionDatasets(
+    const Parameters& params, const Grid3D& grid, const DataOptions& options) {
   auto [xPoints, yPoints, zPoints] = grid.shape();
 
-  // Define data space with arbitrary length of last dimension
-  auto product = xPoints * yPoints * zPoints;
-  HighFive::DataSpace dsWavefunction = HighFive::DataSpace(
-      {product, 1}, {product, HighFive::DataSpace::UNLIMITED});
+  return {file, {xPoints, yPoints, zPoints}, snapshotCapacity(params, options),
+          options};
+}
 
-  // Use chunking
-  HighFive::DataSetCreateProps props;
-  props.add(HighFive::Chunking(std::vector<hsize_t>{(product) / 4, 1}));
+const complexVector_t& DataManager3D::snapshotData(Wavefunction3D& wfn) {
+  if (m_downsampler) {
+    // Only the coarse grid is transformed back to position space
+    return m_downsampler->downsample(wfn, m_fourierOutput);
+  }
+  if (m_fourierOutput) {
+    return wfn.fourierComponent();
+  }
 
-  // Create wavefunction dataset
-  file.createDataSet("wavefunction", dsWavefunction,
-                     HighFive::AtomicType<std::complex<double>>(), props);
+  // FFT so we update real-space arrays
+  wfn.ifft();
+  return wfn.component();
 }
 
 void DataManager3D::saveWavefunctionData(Wavefunction3D& wfn) {
-  // Load in datasets
-  HighFive::DataSet dsWavefunction = file.getDataSet("wavefunction");
+  // Event-triggered snapshots are indexed by /timeseries/snapshotTime, which
+  // a snapshot saved here would leave out of step
+  if (m_ringBuffer) {
+    throw std::logic_error(
+        "Snapshots are saved by bufferWavefunctionData when "
+        "DataOptions::ringBufferSnapshots or "
+        "DataOptions::postEventSnapshots is set");
+  }
 
-  // Resize datasets
-  auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
-  auto product = xPoints * yPoints * zPoints;
-  dsWavefunction.resize({product, m_saveIndex + 1});
+  const complexVector_t& snapshot = snapshotData(wfn);
+  saveProjections(wfn, !m_downsampler && !m_fourierOutput);
+  saveSnapshot(snapshot);
+}
 
-  // FFT so we update real-space arrays
-  wfn.ifft();
+void DataManager3D::bufferWavefunctionData(Wavefunction3D& wfn, double time) {
+  if (!m_ringBuffer) {
+    throw std::logic_error(
+        "Buffering snapshots requires DataOptions::ringBufferSnapshots or "
+        "DataOptions::postEventSnapshots");
+  }
 
+  if (m_remainingEventSnapshots > 0) {
+    m_remainingEventSnapshots -= 1;
+    saveTimedSnapshot(snapshotData(wfn), time);
+  } else {
+    m_ringBuffer->push(snapshotData(wfn), time);
+  }
+}
+
+void DataManager3D::triggerEvent(double time) {
+  if (!m_ringBuffer) {
+    throw std::logic_error(
+        "Events require DataOptions::ringBufferSnapshots or "
+        "DataOptions::postEventSnapshots");
+  }
+
+  recordScalar("eventTime", time);
+  m_ringBuffer->drain(
+      [this](const complexVector_t& snapshot, double snapshotTime) {
+        saveTimedSnapshot(snapshot, snapshotTime);
+      });
+  m_remainingEventSnapshots = m_postEventSnapshots;
+}
+
+void DataManager3D::saveTimedSnapshot(const complexVector_t& snapshot,
+                                      double time) {
+  saveSnapshot(snapshot);
+  recordScalar("snapshotTime", time);
+}
+
+void DataManager3D::saveProjections(Wavefunction3D& wfn, bool positionSpace) {
+  if (m_projections.empty()) {
+    return;
+  }
+
+  bool needsPositionSpace = std::any_of(
+      m_projections.begin(), m_projections.end(),
+      [](const Projection& projection) { return !projection.momentum; });
+  if (needsPositionSpace && !positionSpace) {
+    wfn.ifft();
+  }
+
+  std::vector<std::vector<float>> images;
+  for (const auto& projection : m_projections) {
+    std::vector<double> image =
+        projection.momentum ? columnMomentumDensity(wfn, projection.axis)
+                            : columnDensity(wfn, projection.axis);
+    images.emplace_back(image.begin(), image.end());
+  }
+
+  // HDF5 calls must wait for the I/O thread to finish pending snapshots
+  if (m_writer) {
+    m_writer->flush();
+  }
+  for (std::size_t i = 0; i < m_projections.size(); ++i) {
+    m_projections[i].dataSet->append(images[i].data());
+  }
+}
+
+void DataManager3D::addProjection(const std::string& name, unsigned int axis,
+                                  bool momentum) {
+  if (axis > 2) {
+    throw std::invalid_argument("Projection axis must be 0, 1 or 2");
+  }
+  if (m_numSnapshots != m_options.resumeSnapshots.value_or(0)) {
+    throw std::logic_error(
+        "Projections must be added before the first snapshot is saved");
+  }
+  if (m_ringBuffer) {
+    throw std::logic_error(
+        "Projections are only saved by saveWavefunctionData, and cannot be "
+        "combined with buffered snapshots");
+  }
+
+  // Resumed runs append to the projections saved with each snapshot
+  std::unique_ptr<SnapshotDataSet> dataSet;
+  if (file.exist(name)) {
+    dataSet = std::make_unique<SnapshotDataSet>(
+        file, name, HighFive::AtomicType<float>(), m_numSnapshots, m_options);
+  } else {
+    std::vector<std::size_t> shape = m_gridShape;
+    shape.erase(shape.begin() + axis);
+    dataSet = std::make_unique<SnapshotDataSet>(
+        file, name, shape, HighFive::AtomicType<float>(), m_capacity,
+        m_options);
+  }
+  m_projections.push_back({axis, momentum, std::move(dataSet)});
+}
+
+void DataManager3D::addColumnDensity(unsigned int axis) {
+  writeBufferedData();
+  addProjection(std::string{"/projections/density"} + "XYZ"[axis % 3], axis,
+                false);
+}
+
+void DataManager3D::addMomentumDensity(unsigned int axis,
+                                       double timeOfFlight) {
+  writeBufferedData();
+  std::string name = std::string{"/projections/momentum"} + "XYZ"[axis % 3];
+  addProjection(name, axis, true);
+
+  if (!file.exist(name + "GridSpacing")) {
+    std::vector<double> gridSpacing = m_fourierGridSpacing;
+    gridSpacing.erase(gridSpacing.begin() + axis);
+    for (auto& spacing : gridSpacing) {
+      spacing *= timeOfFlight > 0 ? timeOfFlight : 1.0;
+    }
+    file.createDataSet(name + "GridSpacing", gridSpacing);
+  }
+}
+
+void DataManager3D::saveSnapshot(const complexVector_t& snapshot) {
   // Save new wavefunction data
-  dsWavefunction.select({0, m_saveIndex}, {product, 1}).write(wfn.component());
+  if (m_writer) {
+    m_writer->push(snapshot);
+  } else {
+    m_snapshots.append(snapshot);
+  }
+  m_numSnapshots += 1;
+}
+
+void DataManager3D::addRegion(const std::string& name,
+                              const std::vector<std::size_t>& offset,
+                              const std::vector<std::size_t>& count) {
+  writeBufferedData();
+  m_regions.addRegion(name, offset, count);
+}
+
+void DataManager3D::addProbes(
+    const std::string& name,
+    const std::vector<std::vector<std::size_t>>& points) {
+  writeBufferedData();
+  m_regions.addProbes(name, points);
+}
+
+void DataManager3D::saveRegionData(Wavefunction3D& wfn) {
+  if (m_regions.record(wfn.component())) {
+    writeBufferedData();
+  }
+}
+
+void DataManager3D::saveAccumulatorData(
+    const FieldAccumulator& accumulator) {
+  // HDF5 calls must wait for the I/O thread to finish pending snapshots
+  if (m_writer) {
+    m_writer->flush();
+  }
+  saveAccumulator(file, accumulator);
+}
+
+void DataManager3D::recordScalar(const std::string& name, double value) {
+  if (m_timeSeries.record(name, &value, 1, true)) {
+    writeBufferedData();
+  }
+}
+
+void DataManager3D::recordSeries(const std::string& name,
+                                 const std::vector<double>& values) {
+  if (m_timeSeries.record(name, values.data(), values.size(), false)) {
+    writeBufferedData();
+  }
+}
+
+void DataManager3D::writeBufferedData() {
+  // HDF5 calls must wait for the I/O thread to finish pending snapshots
+  if (m_writer) {
+    m_writer->flush();
+  }
+  m_regions.write();
+  m_timeSeries.write();
+}
+
+void DataManager3D::flush() {
+  writeBufferedData();
+  file.flush();
+}
+
+std::size_t DataManager3D::numSnapshots() const { return m_numSnapshots; }
 
-  m_saveIndex += 1;
+std::map<std::string, std::size_t> DataManager3D::numRecords() const {
+  std::map<std::string, std::size_t> numRecords = m_regions.numRecords();
+  numRecords.merge(m_timeSeries.numRecords());
+  return numRecords;
 }
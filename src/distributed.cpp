@@ -0,0 +1,248 @@
+#include "distributed.h"
+#include "constants.h"
+#include "kernels.h"
+#include <fftw3-mpi.h>
+#include <cmath>
+#include <stdexcept>
+
+DistributedGrid3D::DistributedGrid3D(
+    MPI_Comm comm, std::tuple<unsigned int, unsigned int, unsigned int> points,
+    std::tuple<double, double, double> gridSpacing)
+    : m_comm{comm},
+      m_gridPoints{std::move(points)},
+      m_gridSpacing{std::move(gridSpacing)} {
+  DistributedGrid3D::constructGridParams();
+  DistributedGrid3D::constructMesh();
+}
+
+void DistributedGrid3D::constructGridParams() {
+  auto [xPoints, yPoints, zPoints] = shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = gridSpacing();
+
+  m_fourierGridSpacing = {PI / (xPoints / 2. * xGridSpacing),
+                          PI / (yPoints / 2. * yGridSpacing),
+                          PI / (zPoints / 2. * zGridSpacing)};
+  m_gridLength = {xPoints * xGridSpacing, yPoints * yGridSpacing,
+                  zPoints * zGridSpacing};
+
+  // Slabs along x in position space, and along y in transposed Fourier space
+  fftw_mpi_init();
+  ptrdiff_t localXPoints{};
+  ptrdiff_t localXStart{};
+  ptrdiff_t localYPoints{};
+  ptrdiff_t localYStart{};
+  m_localSize = fftw_mpi_local_size_3d_transposed(
+      xPoints, yPoints, zPoints, m_comm, &localXPoints, &localXStart,
+      &localYPoints, &localYStart);
+  m_localXPoints = localXPoints;
+  m_localXStart = localXStart;
+  m_localYPoints = localYPoints;
+  m_localYStart = localYStart;
+}
+
+// Fourier space coordinate of index i of an axis, in FFTW ordering
+double fourierCoordinate(int i, unsigned int points, double fourierGridSpacing) {
+  if (i < points / 2) {
+    return i * fourierGridSpacing;
+  }
+  return (i - static_cast<int>(points)) * fourierGridSpacing;
+}
+
+void DistributedGrid3D::constructMesh() {
+  auto [xPoints, yPoints, zPoints] = shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = gridSpacing();
+  auto [xFourierGridSpacing, yFourierGridSpacing, zFourierGridSpacing] =
+      fourierGridSpacing();
+  m_xMesh.resize(localPoints());
+  m_yMesh.resize(localPoints());
+  m_zMesh.resize(localPoints());
+  m_wavenumber.resize(m_localYPoints * xPoints * zPoints);
+
+  for (int i = 0; i < m_localXPoints; ++i) {
+    for (int j = 0; j < yPoints; ++j) {
+      for (int k = 0; k < zPoints; ++k) {
+        auto index = k + zPoints * (j + yPoints * i);
+        m_xMesh[index] = (i + m_localXStart - xPoints / 2.) * xGridSpacing;
+        m_yMesh[index] = (j - yPoints / 2.) * yGridSpacing;
+        m_zMesh[index] = (k - zPoints / 2.) * zGridSpacing;
+      }
+    }
+  }
+
+  // Transposed layout, with y running slowest
+  for (int j = 0; j < m_localYPoints; ++j) {
+    double yFourier = fourierCoordinate(j + m_localYStart, yPoints,
+                                        yFourierGridSpacing);
+    for (int i = 0; i < xPoints; ++i) {
+      double xFourier = fourierCoordinate(i, xPoints, xFourierGridSpacing);
+      for (int k = 0; k < zPoints; ++k) {
+        double zFourier = fourierCoordinate(k, zPoints, zFourierGridSpacing);
+        auto index = k + zPoints * (i + xPoints * j);
+        m_wavenumber[index] = std::pow(xFourier, 2) + std::pow(yFourier, 2) +
+                              std::pow(zFourier, 2);
+      }
+    }
+  }
+}
+
+MPI_Comm DistributedGrid3D::communicator() const { return m_comm; }
+
+std::tuple<unsigned int, unsigned int, unsigned int> DistributedGrid3D::shape()
+    const {
+  return m_gridPoints;
+}
+
+std::tuple<double, double, double> DistributedGrid3D::gridSpacing() const {
+  return m_gridSpacing;
+}
+
+std::tuple<double, double, double> DistributedGrid3D::fourierGridSpacing()
+    const {
+  return m_fourierGridSpacing;
+}
+
+std::tuple<double, double, double> DistributedGrid3D::gridLength() const {
+  return m_gridLength;
+}
+
+std::size_t DistributedGrid3D::localXStart() const { return m_localXStart; }
+
+std::size_t DistributedGrid3D::localXPoints() const { return m_localXPoints; }
+
+std::size_t DistributedGrid3D::localYStart() const { return m_localYStart; }
+
+std::size_t DistributedGrid3D::localYPoints() const { return m_localYPoints; }
+
+std::size_t DistributedGrid3D::localPoints() const {
+  auto [xPoints, yPoints, zPoints] = shape();
+  return m_localXPoints * yPoints * zPoints;
+}
+
+std::size_t DistributedGrid3D::localSize() const { return m_localSize; }
+
+std::vector<double>& DistributedGrid3D::xMesh() { return m_xMesh; }
+
+std::vector<double>& DistributedGrid3D::yMesh() { return m_yMesh; }
+
+std::vector<double>& DistributedGrid3D::zMesh() { return m_zMesh; }
+
+std::vector<double>& DistributedGrid3D::wavenumber() { return m_wavenumber; }
+
+DistributedWavefunction3D::DistributedWavefunction3D(DistributedGrid3D& grid)
+    : m_grid{grid} {
+  m_component.resize(grid.localSize());
+  m_fourierComponent.resize(grid.localSize());
+
+  createFFTPlans(grid);
+}
+
+void DistributedWavefunction3D::createFFTPlans(DistributedGrid3D& grid) {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  m_plans.plan_forward = fftw_mpi_plan_dft_3d(
+      xPoints, yPoints, zPoints,
+      reinterpret_cast<fftw_complex*>(&m_component[0]),
+      reinterpret_cast<fftw_complex*>(&m_fourierComponent[0]),
+      grid.communicator(), FFTW_FORWARD,
+      FFTW_MEASURE | FFTW_MPI_TRANSPOSED_OUT);
+  m_plans.plan_backward = fftw_mpi_plan_dft_3d(
+      xPoints, yPoints, zPoints,
+      reinterpret_cast<fftw_complex*>(&m_fourierComponent[0]),
+      reinterpret_cast<fftw_complex*>(&m_component[0]), grid.communicator(),
+      FFTW_BACKWARD, FFTW_MEASURE | FFTW_MPI_TRANSPOSED_IN);
+}
+
+DistributedWavefunction3D::~DistributedWavefunction3D() { destroyFFTPlans(); }
+
+void DistributedWavefunction3D::destroyFFTPlans() const {
+  fftw_destroy_plan(m_plans.plan_forward);
+  fftw_destroy_plan(m_plans.plan_backward);
+}
+
+DistributedGrid3D& DistributedWavefunction3D::grid() const { return m_grid; }
+
+complexVector_t& DistributedWavefunction3D::component() { return m_component; }
+
+complexVector_t& DistributedWavefunction3D::fourierComponent() {
+  return m_fourierComponent;
+}
+
+std::vector<double> DistributedWavefunction3D::density() const {
+  std::vector<double> density(m_grid.localPoints());
+  for (int i = 0; i < density.size(); ++i) {
+    density[i] = std::norm(m_component[i]);
+  }
+
+  return density;
+}
+
+double DistributedWavefunction3D::atomNumber() const { return m_atomNumber; }
+
+void DistributedWavefunction3D::fft() const {
+  fftw_execute(m_plans.plan_forward);
+}
+
+void DistributedWavefunction3D::ifft() {
+  fftw_execute(m_plans.plan_backward);
+
+  // Renormalise wavefunction
+  auto [xPoints, yPoints, zPoints] = m_grid.shape();
+  auto n = static_cast<double>(xPoints) * yPoints * zPoints;
+  int localPoints = static_cast<int>(m_grid.localPoints());
+  auto& component = m_component;
+#pragma omp parallel for shared(localPoints, component, n) default(none)
+  for (int i = 0; i < localPoints; ++i) {
+    component[i] /= n;
+  }
+}
+
+void DistributedWavefunction3D::updateAtomNumber() {
+  m_atomNumber = calculateAtomNum(*this);
+}
+
+void DistributedWavefunction3D::setComponent(complexVector_t& component) {
+  if (component.size() != m_grid.localPoints()) {
+    throw std::invalid_argument("Component does not match the local slab");
+  }
+  std::copy(component.begin(), component.end(), m_component.begin());
+
+  // Update the Fourier-space wavefunction and atom number
+  fft();
+  updateAtomNumber();
+}
+
+void fourierStep(DistributedWavefunction3D& wfn, const Parameters& params) {
+  fourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                params.timeStep);
+}
+
+void interactionStep(DistributedWavefunction3D& wfn,
+                     const Parameters& params) {
+  if (params.trap.size() != wfn.grid().localPoints()) {
+    throw std::invalid_argument("Trap does not match the local slab");
+  }
+
+  interactionKernel(wfn.component(), params.trap, params.intStrength,
+                    params.timeStep);
+}
+
+double calculateAtomNum(const DistributedWavefunction3D& wfn) {
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  std::vector<double> dens = wfn.density();
+  double localAtomNumber{};
+  for (auto value : dens) {
+    localAtomNumber += value * xGridSpacing * yGridSpacing * zGridSpacing;
+  }
+
+  double atomNumber{};
+  MPI_Allreduce(&localAtomNumber, &atomNumber, 1, MPI_DOUBLE, MPI_SUM,
+                wfn.grid().communicator());
+
+  return atomNumber;
+}
+
+void renormaliseAtomNum(DistributedWavefunction3D& wfn) {
+  double scale = std::sqrt(wfn.atomNumber() / calculateAtomNum(wfn));
+  for (std::size_t i = 0; i < wfn.grid().localPoints(); ++i) {
+    wfn.component()[i] *= scale;
+  }
+}
@@ -0,0 +1,315 @@
+#include "ensemble.h"
+#include "kernels.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <stdexcept>
+
+// Helpers shared by the 1D and 2D ensembles, where each realisation holds
+// size points
+
+void checkRealisation(unsigned int realisation, unsigned int numRealisations) {
+  if (realisation >= numRealisations) {
+    throw std::out_of_range("Realisation index is out of range");
+  }
+}
+
+complexVector_t copyRealisation(const complexVector_t& component,
+                                std::size_t size, unsigned int realisation) {
+  auto first = component.begin() + realisation * size;
+  return {first, first + size};
+}
+
+void storeRealisation(complexVector_t& component, std::size_t size,
+                      unsigned int realisation,
+                      const complexVector_t& values) {
+  if (values.size() != size) {
+    throw std::invalid_argument("Realisation does not match the grid");
+  }
+  std::copy(values.begin(), values.end(),
+            component.begin() + realisation * size);
+}
+
+std::vector<double> realisationDensity(const complexVector_t& component,
+                                       std::size_t size,
+                                       unsigned int realisation) {
+  std::vector<double> density(size);
+  auto first = component.begin() + realisation * size;
+  std::transform(first, first + size, density.begin(),
+                 [](const auto& value) { return std::norm(value); });
+
+  return density;
+}
+
+std::vector<double> ensembleMeanDensity(const complexVector_t& component,
+                                        std::size_t size,
+                                        unsigned int numRealisations) {
+  std::vector<double> density(size, 0.0);
+  long points = static_cast<long>(size);
+  long batch = numRealisations;
+  double weight = 1.0 / numRealisations;
+#pragma omp parallel for shared(component, density, points, batch, weight) \
+    default(none)
+  for (long i = 0; i < points; ++i) {
+    double sum = 0.0;
+    for (long realisation = 0; realisation < batch; ++realisation) {
+      sum += std::norm(component[i + realisation * points]);
+    }
+    density[i] = weight * sum;
+  }
+
+  return density;
+}
+
+std::vector<double> ensembleAtomNumbers(const complexVector_t& component,
+                                        std::size_t size,
+                                        unsigned int numRealisations,
+                                        double volumeElement) {
+  std::vector<double> atomNumbers(numRealisations, 0.0);
+  long points = static_cast<long>(size);
+  long batch = numRealisations;
+#pragma omp parallel for shared(component, atomNumbers, points, batch, \
+    volumeElement) default(none)
+  for (long realisation = 0; realisation < batch; ++realisation) {
+    double sum = 0.0;
+    for (long i = 0; i < points; ++i) {
+      sum += std::norm(component[i + realisation * points]);
+    }
+    atomNumbers[realisation] = sum * volumeElement;
+  }
+
+  return atomNumbers;
+}
+
+void normaliseEnsemble(complexVector_t& component, double n) {
+  long size = static_cast<long>(component.size());
+#pragma omp parallel for shared(component, size, n) default(none)
+  for (long i = 0; i < size; ++i) {
+    component[i] /= n;
+  }
+}
+
+double meanOf(const std::vector<double>& values) {
+  return std::accumulate(values.begin(), values.end(), 0.0) /
+         static_cast<double>(values.size());
+}
+
+EnsembleWavefunction1D::EnsembleWavefunction1D(Grid1D& grid,
+                                               unsigned int numRealisations)
+    : m_grid{grid}, m_numRealisations{numRealisations} {
+  if (numRealisations == 0) {
+    throw std::invalid_argument("An ensemble needs at least one realisation");
+  }
+  m_component.resize(grid.shape() * numRealisations);
+  m_fourierComponent.resize(grid.shape() * numRealisations);
+
+  createFFTPlans(grid);
+}
+
+void EnsembleWavefunction1D::createFFTPlans(const Grid1D& grid) {
+  int points = static_cast<int>(grid.shape());
+  int numRealisations = static_cast<int>(m_numRealisations);
+  m_plans.plan_forward = fftw_plan_many_dft(
+      1, &points, numRealisations,
+      reinterpret_cast<fftw_complex*>(&m_component[0]), nullptr, 1, points,
+      reinterpret_cast<fftw_complex*>(&m_fourierComponent[0]), nullptr, 1,
+      points, FFTW_FORWARD, FFTW_MEASURE);
+  m_plans.plan_backward = fftw_plan_many_dft(
+      1, &points, numRealisations,
+      reinterpret_cast<fftw_complex*>(&m_fourierComponent[0]), nullptr, 1,
+      points, reinterpret_cast<fftw_complex*>(&m_component[0]), nullptr, 1,
+      points, FFTW_BACKWARD, FFTW_MEASURE);
+}
+
+EnsembleWavefunction1D::~EnsembleWavefunction1D() { destroyFFTPlans(); }
+
+void EnsembleWavefunction1D::destroyFFTPlans() const {
+  fftw_destroy_plan(m_plans.plan_forward);
+  fftw_destroy_plan(m_plans.plan_backward);
+}
+
+Grid1D& EnsembleWavefunction1D::grid() const { return m_grid; }
+
+unsigned int EnsembleWavefunction1D::numRealisations() const {
+  return m_numRealisations;
+}
+
+complexVector_t& EnsembleWavefunction1D::component() { return m_component; }
+
+complexVector_t& EnsembleWavefunction1D::fourierComponent() {
+  return m_fourierComponent;
+}
+
+complexVector_t EnsembleWavefunction1D::realisation(
+    unsigned int realisation) const {
+  checkRealisation(realisation, m_numRealisations);
+  return copyRealisation(m_component, m_grid.shape(), realisation);
+}
+
+void EnsembleWavefunction1D::setRealisation(unsigned int realisation,
+                                            const complexVector_t& component) {
+  checkRealisation(realisation, m_numRealisations);
+  storeRealisation(m_component, m_grid.shape(), realisation, component);
+}
+
+std::vector<double> EnsembleWavefunction1D::density(
+    unsigned int realisation) const {
+  checkRealisation(realisation, m_numRealisations);
+  return realisationDensity(m_component, m_grid.shape(), realisation);
+}
+
+std::vector<double> EnsembleWavefunction1D::meanDensity() const {
+  return ensembleMeanDensity(m_component, m_grid.shape(), m_numRealisations);
+}
+
+std::vector<double> EnsembleWavefunction1D::atomNumbers() const {
+  return ensembleAtomNumbers(m_component, m_grid.shape(), m_numRealisations,
+                             m_grid.gridSpacing());
+}
+
+double EnsembleWavefunction1D::meanAtomNumber() const {
+  return meanOf(atomNumbers());
+}
+
+void EnsembleWavefunction1D::fft() const {
+  fftw_execute(m_plans.plan_forward);
+}
+
+void EnsembleWavefunction1D::ifft() {
+  fftw_execute(m_plans.plan_backward);
+  normaliseEnsemble(m_component, m_grid.shape());
+}
+
+EnsembleWavefunction2D::EnsembleWavefunction2D(Grid2D& grid,
+                                               unsigned int numRealisations)
+    : m_grid{grid}, m_numRealisations{numRealisations} {
+  if (numRealisations == 0) {
+    throw std::invalid_argument("An ensemble needs at least one realisation");
+  }
+  auto [xPoints, yPoints] = grid.shape();
+  m_component.resize(xPoints * yPoints * numRealisations);
+  m_fourierComponent.resize(xPoints * yPoints * numRealisations);
+
+  createFFTPlans(grid);
+}
+
+void EnsembleWavefunction2D::createFFTPlans(const Grid2D& grid) {
+  auto [xPoints, yPoints] = grid.shape();
+  std::array<int, 2> points{static_cast<int>(xPoints),
+                            static_cast<int>(yPoints)};
+  int distance = points[0] * points[1];
+  int numRealisations = static_cast<int>(m_numRealisations);
+  m_plans.plan_forward = fftw_plan_many_dft(
+      2, points.data(), numRealisations,
+      reinterpret_cast<fftw_complex*>(&m_component[0]), nullptr, 1, distance,
+      reinterpret_cast<fftw_complex*>(&m_fourierComponent[0]), nullptr, 1,
+      distance, FFTW_FORWARD, FFTW_MEASURE);
+  m_plans.plan_backward = fftw_plan_many_dft(
+      2, points.data(), numRealisations,
+      reinterpret_cast<fftw_complex*>(&m_fourierComponent[0]), nullptr, 1,
+      distance, reinterpret_cast<fftw_complex*>(&m_component[0]), nullptr, 1,
+      distance, FFTW_BACKWARD, FFTW_MEASURE);
+}
+
+EnsembleWavefunction2D::~EnsembleWavefunction2D() { destroyFFTPlans(); }
+
+void EnsembleWavefunction2D::destroyFFTPlans() const {
+  fftw_destroy_plan(m_plans.plan_forward);
+  fftw_destroy_plan(m_plans.plan_backward);
+}
+
+Grid2D& EnsembleWavefunction2D::grid() const { return m_grid; }
+
+unsigned int EnsembleWavefunction2D::numRealisations() const {
+  return m_numRealisations;
+}
+
+complexVector_t& EnsembleWavefunction2D::component() { return m_component; }
+
+complexVector_t& EnsembleWavefunction2D::fourierComponent() {
+  return m_fourierComponent;
+}
+
+complexVector_t EnsembleWavefunction2D::realisation(
+    unsigned int realisation) const {
+  checkRealisation(realisation, m_numRealisations);
+  auto [xPoints, yPoints] = m_grid.shape();
+  return copyRealisation(m_component, xPoints * yPoints, realisation);
+}
+
+void EnsembleWavefunction2D::setRealisation(unsigned int realisation,
+                                            const complexVector_t& component) {
+  checkRealisation(realisation, m_numRealisations);
+  auto [xPoints, yPoints] = m_grid.shape();
+  storeRealisation(m_component, xPoints * yPoints, realisation, component);
+}
+
+std::vector<double> EnsembleWavefunction2D::density(
+    unsigned int realisation) const {
+  checkRealisation(realisation, m_numRealisations);
+  auto [xPoints, yPoints] = m_grid.shape();
+  return realisationDensity(m_component, xPoints * yPoints, realisation);
+}
+
+std::vector<double> EnsembleWavefunction2D::meanDensity() const {
+  auto [xPoints, yPoints] = m_grid.shape();
+  return ensembleMeanDensity(m_component, xPoints * yPoints,
+                             m_numRealisations);
+}
+
+std::vector<double> EnsembleWavefunction2D::atomNumbers() const {
+  auto [xPoints, yPoints] = m_grid.shape();
+  auto [xGridSpacing, yGridSpacing] = m_grid.gridSpacing();
+  return ensembleAtomNumbers(m_component, xPoints * yPoints, m_numRealisations,
+                             xGridSpacing * yGridSpacing);
+}
+
+double EnsembleWavefunction2D::meanAtomNumber() const {
+  return meanOf(atomNumbers());
+}
+
+void EnsembleWavefunction2D::fft() const {
+  fftw_execute(m_plans.plan_forward);
+}
+
+void EnsembleWavefunction2D::ifft() {
+  fftw_execute(m_plans.plan_backward);
+  auto [xPoints, yPoints] = m_grid.shape();
+  normaliseEnsemble(m_component, static_cast<double>(xPoints) * yPoints);
+}
+
+void fourierStep(EnsembleWavefunction1D& wfn, const Parameters& params) {
+  fourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                params.timeStep, wfn.numRealisations());
+}
+
+void fourierStep(EnsembleWavefunction2D& wfn, const Parameters& params) {
+  fourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                params.timeStep, wfn.numRealisations());
+}
+
+void fourierStep(EnsembleWavefunction1D& wfn, const Parameters& params,
+                 const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, 0.0, projector,
+                         wfn.numRealisations());
+}
+
+void fourierStep(EnsembleWavefunction2D& wfn, const Parameters& params,
+                 const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, 0.0, projector,
+                         wfn.numRealisations());
+}
+
+void interactionStep(EnsembleWavefunction1D& wfn, const Parameters& params) {
+  checkTrap(params.trap, wfn.grid().wavenumber().size());
+  interactionKernel(wfn.component(), params.trap, params.intStrength,
+                    params.timeStep, wfn.numRealisations());
+}
+
+void interactionStep(EnsembleWavefunction2D& wfn, const Parameters& params) {
+  checkTrap(params.trap, wfn.grid().wavenumber().size());
+  interactionKernel(wfn.component(), params.trap, params.intStrength,
+                    params.timeStep, wfn.numRealisations());
+}
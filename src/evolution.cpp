@@ -1,78 +1,203 @@
 #include "evolution.h"
+#include "kernels.h"
+#include <stdexcept>
 
 void fourierStep(Wavefunction1D& wfn, const Parameters& params) {
-#pragma omp parallel for shared(wfn, params) default(none)
-  for (int i = 0; i < wfn.grid().shape(); ++i) {
-    wfn.fourierComponent()[i] *=
-        exp(-0.25 * I * params.timeStep * wfn.grid().wavenumber()[i]);
-  }
+  fourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                params.timeStep);
 }
 
 void fourierStep(Wavefunction2D& wfn, const Parameters& params) {
+  fourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                params.timeStep);
+}
+
+void fourierStep(Wavefunction3D& wfn, const Parameters& params) {
+  fourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                params.timeStep);
+}
+
+void fourierStep(Wavefunction1D& wfn, const Parameters& params,
+                 const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, 0.0, projector);
+}
+
+void fourierStep(Wavefunction2D& wfn, const Parameters& params,
+                 const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, 0.0, projector);
+}
+
+void fourierStep(Wavefunction3D& wfn, const Parameters& params,
+                 const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, 0.0, projector);
+}
+
+void interactionStep(Wavefunction1D& wfn, const Parameters& params) {
+  checkTrap(params.trap, wfn.component().size());
+  interactionKernel(wfn.component(), params.trap, params.intStrength,
+                    params.timeStep);
+}
+
+void interactionStep(Wavefunction2D& wfn, const Parameters& params) {
+  checkTrap(params.trap, wfn.component().size());
+  interactionKernel(wfn.component(), params.trap, params.intStrength,
+                    params.timeStep);
+}
+
+void interactionStep(Wavefunction3D& wfn, const Parameters& params) {
+  checkTrap(params.trap, wfn.component().size());
+  interactionKernel(wfn.component(), params.trap, params.intStrength,
+                    params.timeStep);
+}
+
+// Potential at grid point (i, j, k) from everything but the separable parts
+inline double localPotential(const PotentialTerms& terms, unsigned int i,
+                             unsigned int j, unsigned int k, size_t index) {
+  double potential = terms.staticPart ? (*terms.staticPart)[index] : 0.0;
+  for (const auto& stirrer : terms.stirrers) {
+    potential += stirrer.value(i, j, k);
+  }
+
+  return potential;
+}
+
+void interactionStep(Wavefunction1D& wfn, const Parameters& params,
+                     const Potential& potential) {
+  auto xPoints = wfn.grid().shape();
+  PotentialTerms terms =
+      potential.evaluate({xPoints, 1, 1}, {wfn.grid().gridSpacing(), 1, 1},
+                         params.currentTime + 0.5 * params.timeStep.real());
+  std::complex<double> factor = -I * params.timeStep;
+
+#pragma omp parallel for shared(wfn, params, terms, factor, xPoints) \
+    default(none)
+  for (int i = 0; i < xPoints; ++i) {
+    double trap = terms.axis[0][i] + localPotential(terms, i, 0, 0, i);
+    wfn.component()[i] *=
+        exp(factor *
+            (trap + params.intStrength * std::norm(wfn.component()[i])));
+  }
+}
+
+void interactionStep(Wavefunction2D& wfn, const Parameters& params,
+                     const Potential& potential) {
   auto [xPoints, yPoints] = wfn.grid().shape();
-#pragma omp parallel for collapse(2) \
-    shared(wfn, params, xPoints, yPoints) default(none)
+  auto [xGridSpacing, yGridSpacing] = wfn.grid().gridSpacing();
+  PotentialTerms terms =
+      potential.evaluate({xPoints, yPoints, 1}, {xGridSpacing, yGridSpacing, 1},
+                         params.currentTime + 0.5 * params.timeStep.real());
+  std::complex<double> factor = -I * params.timeStep;
+
+#pragma omp parallel for collapse(2) shared(wfn, params, terms, factor, \
+    xPoints, yPoints) default(none)
   for (int i = 0; i < xPoints; ++i) {
     for (int j = 0; j < yPoints; ++j) {
       auto index = j + i * yPoints;
-      wfn.fourierComponent()[index] *=
-          exp(-0.25 * I * params.timeStep * wfn.grid().wavenumber()[index]);
+      double trap = terms.axis[0][i] + terms.axis[1][j] +
+                    localPotential(terms, i, j, 0, index);
+      wfn.component()[index] *=
+          exp(factor *
+              (trap + params.intStrength * std::norm(wfn.component()[index])));
     }
   }
 }
 
-void fourierStep(Wavefunction3D& wfn, const Parameters& params) {
+void interactionStep(Wavefunction3D& wfn, const Parameters& params,
+                     const Potential& potential) {
   auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
-#pragma omp parallel for collapse(3) \
-    shared(wfn, params, xPoints, yPoints, zPoints) default(none)
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  PotentialTerms terms = potential.evaluate(
+      {xPoints, yPoints, zPoints}, {xGridSpacing, yGridSpacing, zGridSpacing},
+      params.currentTime + 0.5 * params.timeStep.real());
+  std::complex<double> factor = -I * params.timeStep;
+
+#pragma omp parallel for collapse(2) shared(wfn, params, terms, factor, \
+    xPoints, yPoints, zPoints) default(none)
   for (int i = 0; i < xPoints; ++i) {
     for (int j = 0; j < yPoints; ++j) {
+      double rowTrap = terms.axis[0][i] + terms.axis[1][j];
       for (int k = 0; k < zPoints; ++k) {
         auto index = k + zPoints * (j + i * yPoints);
-        wfn.fourierComponent()[index] *=
-            exp(-0.25 * I * params.timeStep * wfn.grid().wavenumber()[index]);
+        double trap =
+            rowTrap + terms.axis[2][k] + localPotential(terms, i, j, k, index);
+        wfn.component()[index] *=
+            exp(factor * (trap + params.intStrength *
+                                     std::norm(wfn.component()[index])));
       }
     }
   }
 }
 
-void interactionStep(Wavefunction1D& wfn, const Parameters& params) {
-#pragma omp parallel for shared(wfn, params) default(none)
-  for (int i = 0; i < wfn.grid().shape(); ++i) {
+void checkPropagator(const Parameters& params,
+                     const TrapPropagator& propagator,
+                     const std::array<unsigned int, 3>& shape) {
+  if (propagator.timeStep() != params.timeStep) {
+    throw std::invalid_argument(
+        "TrapPropagator was built with a different time step");
+  }
+  if (propagator.axis(Axis::x).size() != shape[0] ||
+      propagator.axis(Axis::y).size() != shape[1] ||
+      propagator.axis(Axis::z).size() != shape[2]) {
+    throw std::invalid_argument("TrapPropagator was built for another grid");
+  }
+}
+
+void interactionStep(Wavefunction1D& wfn, const Parameters& params,
+                     const TrapPropagator& propagator) {
+  auto xPoints = wfn.grid().shape();
+  checkPropagator(params, propagator, {xPoints, 1, 1});
+  const auto& xPropagator = propagator.axis(Axis::x);
+  std::complex<double> factor = -I * params.timeStep * params.intStrength;
+
+#pragma omp parallel for shared(wfn, xPropagator, factor, xPoints) \
+    default(none)
+  for (int i = 0; i < xPoints; ++i) {
     wfn.component()[i] *=
-        exp(-I * params.timeStep *
-            (params.trap[i] +
-             params.intStrength * pow(abs(wfn.component()[i]), 2)));
+        xPropagator[i] * exp(factor * std::norm(wfn.component()[i]));
   }
 }
 
-void interactionStep(Wavefunction2D& wfn, const Parameters& params) {
+void interactionStep(Wavefunction2D& wfn, const Parameters& params,
+                     const TrapPropagator& propagator) {
   auto [xPoints, yPoints] = wfn.grid().shape();
-#pragma omp parallel for collapse(2) \
-    shared(wfn, params, xPoints, yPoints) default(none)
+  checkPropagator(params, propagator, {xPoints, yPoints, 1});
+  const auto& xPropagator = propagator.axis(Axis::x);
+  const auto& yPropagator = propagator.axis(Axis::y);
+  std::complex<double> factor = -I * params.timeStep * params.intStrength;
+
+#pragma omp parallel for collapse(2) shared(wfn, xPropagator, yPropagator, \
+    factor, xPoints, yPoints) default(none)
   for (int i = 0; i < xPoints; ++i) {
     for (int j = 0; j < yPoints; ++j) {
       auto index = j + i * yPoints;
-      wfn.component()[index] *=
-          exp(-I * params.timeStep *
-              (params.trap[index] +
-               params.intStrength * pow(abs(wfn.component()[index]), 2)));
+      wfn.component()[index] *= xPropagator[i] * yPropagator[j] *
+                                exp(factor * std::norm(wfn.component()[index]));
     }
   }
 }
 
-void interactionStep(Wavefunction3D& wfn, const Parameters& params) {
+void interactionStep(Wavefunction3D& wfn, const Parameters& params,
+                     const TrapPropagator& propagator) {
   auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
-#pragma omp parallel for collapse(3) \
-    shared(wfn, params, xPoints, yPoints, zPoints) default(none)
+  checkPropagator(params, propagator, {xPoints, yPoints, zPoints});
+  const auto& xPropagator = propagator.axis(Axis::x);
+  const auto& yPropagator = propagator.axis(Axis::y);
+  const auto& zPropagator = propagator.axis(Axis::z);
+  std::complex<double> factor = -I * params.timeStep * params.intStrength;
+
+#pragma omp parallel for collapse(2) shared(wfn, xPropagator, yPropagator, \
+    zPropagator, factor, xPoints, yPoints, zPoints) default(none)
   for (int i = 0; i < xPoints; ++i) {
     for (int j = 0; j < yPoints; ++j) {
+      auto rowPropagator = xPropagator[i] * yPropagator[j];
       for (int k = 0; k < zPoints; ++k) {
         auto index = k + zPoints * (j + i * yPoints);
         wfn.component()[index] *=
-            exp(-I * params.timeStep *
-                (params.trap[index] +
-                 params.intStrength * pow(abs(wfn.component()[index]), 2)));
+            rowPropagator * zPropagator[k] *
+            exp(factor * std::norm(wfn.component()[index]));
       }
     }
   }
@@ -32,7 +32,8 @@ void Grid1D::constructMesh() {
     if (i < xPoints / 2) {
       m_mesh.xFourierMesh[i] = i * xFourierGridSpacing;
     } else {
-      m_mesh.xFourierMesh[i] = (i - xPoints) * xFourierGridSpacing;
+      m_mesh.xFourierMesh[i] =
+          (i - static_cast<int>(xPoints)) * xFourierGridSpacing;
     }
 
     m_mesh.wavenumber[i] = std::pow(m_mesh.xFourierMesh[i], 2);
@@ -89,12 +90,14 @@ void Grid2D::constructMesh() {
       if (i < xPoints / 2) {
         m_mesh.xFourierMesh[index] = i * xFourierGridSpacing;
       } else {
-        m_mesh.xFourierMesh[index] = (i - xPoints) * xFourierGridSpacing;
+        m_mesh.xFourierMesh[index] =
+            (i - static_cast<int>(xPoints)) * xFourierGridSpacing;
       }
       if (j < yPoints / 2) {
         m_mesh.yFourierMesh[index] = j * yFourierGridSpacing;
       } else {
-        m_mesh.yFourierMesh[index] = (j - yPoints) * yFourierGridSpacing;
+        m_mesh.yFourierMesh[index] =
+            (j - static_cast<int>(yPoints)) * yFourierGridSpacing;
       }
 
       m_mesh.wavenumber[index] = std::pow(m_mesh.xFourierMesh[index], 2) +
@@ -135,8 +138,8 @@ void Grid3D::constructGridParams() {
   m_fourierGridSpacing = {PI / (xPoints / 2. * xGridSpacing),
                           PI / (yPoints / 2. * yGridSpacing),
                           PI / (zPoints / 2. * zGridSpacing)};
-  m_gridLength = {xPoints * xGridSpacing, yPoints * zGridSpacing,
-                  yPoints * zGridSpacing};
+  m_gridLength = {xPoints * xGridSpacing, yPoints * yGridSpacing,
+                  zPoints * zGridSpacing};
 }
 
 void resizeMesh3D(Mesh3D& mesh, unsigned int xPoints, unsigned int yPoints,
@@ -168,17 +171,20 @@ void Grid3D::constructMesh() {
         if (i < xPoints / 2) {
           m_mesh.xFourierMesh[index] = i * xFourierGridSpacing;
         } else {
-          m_mesh.xFourierMesh[index] = (i - xPoints) * xFourierGridSpacing;
+          m_mesh.xFourierMesh[index] =
+              (i - static_cast<int>(xPoints)) * xFourierGridSpacing;
         }
         if (j < yPoints / 2) {
           m_mesh.yFourierMesh[index] = j * yFourierGridSpacing;
         } else {
-          m_mesh.yFourierMesh[index] = (j - yPoints) * yFourierGridSpacing;
+          m_mesh.yFourierMesh[index] =
+              (j - static_cast<int>(yPoints)) * yFourierGridSpacing;
         }
         if (k < zPoints / 2) {
-          m_mesh.zFourierMesh[index] = k * yFourierGridSpacing;
+          m_mesh.zFourierMesh[index] = k * zFourierGridSpacing;
         } else {
-          m_mesh.zFourierMesh[index] = (k - zPoints) * yFourierGridSpacing;
+          m_mesh.zFourierMesh[index] =
+              (k - static_cast<int>(zPoints)) * zFourierGridSpacing;
         }
 
         m_mesh.wavenumber[index] = std::pow(m_mesh.xFourierMesh[index], 2) +
@@ -0,0 +1,148 @@
+#include "groundstate.h"
+#include "evolution.h"
+#include "spectral.h"
+#include <limits>
+
+// Computes the atom number from the Fourier space vector using Parseval's
+// theorem, so the position space vector does not need to be up to date.
+double fourierAtomNumber(Wavefunction3D& wfn) {
+  auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  auto numPoints = static_cast<long>(xPoints) * yPoints * zPoints;
+
+  double sum{};
+#pragma omp parallel for reduction(+ : sum) shared(wfn, numPoints) default(none)
+  for (long i = 0; i < numPoints; ++i) {
+    sum += std::norm(wfn.fourierComponent()[i]);
+  }
+
+  return sum * xGridSpacing * yGridSpacing * zGridSpacing /
+         static_cast<double>(numPoints);
+}
+
+void scaleFourierComponent(Wavefunction3D& wfn, double factor) {
+  auto numPoints = static_cast<long>(wfn.fourierComponent().size());
+
+#pragma omp parallel for shared(wfn, numPoints, factor) default(none)
+  for (long i = 0; i < numPoints; ++i) {
+    wfn.fourierComponent()[i] *= factor;
+  }
+}
+
+// Evolves in imaginary time starting from, and finishing with, an up to date
+// Fourier space vector. The norm is held at atomNumber throughout.
+int evolveFourierState(Wavefunction3D& wfn, const Parameters& params,
+                       const GroundStateOptions& options, double atomNumber) {
+  double timeStep = std::abs(params.timeStep);
+  double previousChemicalPotential = std::numeric_limits<double>::infinity();
+
+  int step = 0;
+  while (step < options.maxIterations) {
+    fourierStep(wfn, params);
+    wfn.ifft();
+    interactionStep(wfn, params);
+    wfn.fft();
+    fourierStep(wfn, params);
+    ++step;
+
+    // In imaginary time the norm decays as exp(-2 mu dt)
+    double currentAtomNumber = fourierAtomNumber(wfn);
+    scaleFourierComponent(wfn, std::sqrt(atomNumber / currentAtomNumber));
+
+    if (step % options.checkInterval == 0) {
+      double chemicalPotential =
+          -std::log(currentAtomNumber / atomNumber) / (2 * timeStep);
+      if (std::abs(chemicalPotential - previousChemicalPotential) <=
+          options.tolerance * std::abs(chemicalPotential)) {
+        break;
+      }
+      previousChemicalPotential = chemicalPotential;
+    }
+  }
+
+  return step;
+}
+
+int imaginaryTimeEvolution(Wavefunction3D& wfn, const Parameters& params,
+                           const GroundStateOptions& options) {
+  wfn.fft();
+  int steps = evolveFourierState(wfn, params, options, fourierAtomNumber(wfn));
+  wfn.ifft();
+
+  return steps;
+}
+
+unsigned int coarsenPoints(unsigned int points, unsigned int minPoints) {
+  if (points % 2 == 0 && points / 2 >= minPoints) {
+    return points / 2;
+  }
+  return points;
+}
+
+void groundStateLadder(Wavefunction3D& wfn, const Parameters& params,
+                       const TrapFunction3D& trap,
+                       const GroundStateOptions& options) {
+  if (!options.wisdomFile.empty()) {
+    fftw_import_wisdom_from_filename(options.wisdomFile.c_str());
+  }
+
+  // Build the grid shapes of each level, from finest to coarsest
+  auto targetShape = wfn.grid().shape();
+  std::vector<std::tuple<unsigned int, unsigned int, unsigned int>> shapes{
+      targetShape};
+  for (int level = 1; level < options.numLevels; ++level) {
+    auto [xPoints, yPoints, zPoints] = shapes.back();
+    std::tuple<unsigned int, unsigned int, unsigned int> coarsened{
+        coarsenPoints(xPoints, options.minPoints),
+        coarsenPoints(yPoints, options.minPoints),
+        coarsenPoints(zPoints, options.minPoints)};
+    if (coarsened == shapes.back()) {
+      break;
+    }
+    shapes.push_back(coarsened);
+  }
+
+  // Every level spans the same box as the target grid
+  auto [xTarget, yTarget, zTarget] = targetShape;
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  double xLength = xTarget * xGridSpacing;
+  double yLength = yTarget * yGridSpacing;
+  double zLength = zTarget * zGridSpacing;
+
+  wfn.fft();
+  double atomNumber = fourierAtomNumber(wfn);
+  complexVector_t fourierState = wfn.fourierComponent();
+  auto previousShape = targetShape;
+
+  for (auto level = shapes.size() - 1; level > 0; --level) {
+    auto [xPoints, yPoints, zPoints] = shapes[level];
+    Grid3D grid{shapes[level],
+                {xLength / xPoints, yLength / yPoints, zLength / zPoints}};
+    Wavefunction3D levelWfn{grid};
+
+    Parameters levelParams = params;
+    levelParams.trap = trap(grid);
+
+    resampleFourier(fourierState, previousShape, levelWfn.fourierComponent(),
+                    shapes[level]);
+    scaleFourierComponent(
+        levelWfn, std::sqrt(atomNumber / fourierAtomNumber(levelWfn)));
+    evolveFourierState(levelWfn, levelParams, options, atomNumber);
+
+    fourierState = levelWfn.fourierComponent();
+    previousShape = shapes[level];
+  }
+
+  // Finish on the target grid, reusing the plans of the wave function
+  Parameters targetParams = params;
+  targetParams.trap = trap(wfn.grid());
+
+  resampleFourier(fourierState, previousShape, wfn.fourierComponent(),
+                  targetShape);
+  evolveFourierState(wfn, targetParams, options, atomNumber);
+  wfn.ifft();
+
+  if (!options.wisdomFile.empty()) {
+    fftw_export_wisdom_to_filename(options.wisdomFile.c_str());
+  }
+}
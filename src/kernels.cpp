@@ -0,0 +1,132 @@
+#include "kernels.h"
+#include "noise.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+void fourierKernel(complexVector_t& fourierComponent,
+                   const std::vector<double>& wavenumber,
+                   std::complex<double> timeStep,
+                   unsigned int numRealisations) {
+  std::complex<double> factor = std::complex<double>{0, -0.25} * timeStep;
+  long size = static_cast<long>(wavenumber.size());
+  long batch = numRealisations;
+#pragma omp parallel for shared(fourierComponent, wavenumber, factor, size, \
+    batch) default(none)
+  for (long i = 0; i < size; ++i) {
+    std::complex<double> propagator = exp(factor * wavenumber[i]);
+    for (long realisation = 0; realisation < batch; ++realisation) {
+      fourierComponent[i + realisation * size] *= propagator;
+    }
+  }
+}
+
+void checkTrap(const std::vector<double>& trap, std::size_t numPoints) {
+  if (trap.size() != numPoints) {
+    throw std::invalid_argument("Trap does not match the grid");
+  }
+}
+
+void interactionKernel(complexVector_t& component,
+                       const std::vector<double>& trap, double intStrength,
+                       std::complex<double> timeStep,
+                       unsigned int numRealisations) {
+  std::complex<double> factor = std::complex<double>{0, -1} * timeStep;
+  long size = static_cast<long>(trap.size());
+  long batch = numRealisations;
+#pragma omp parallel for collapse(2) shared(component, trap, intStrength, \
+    factor, size, batch) default(none)
+  for (long realisation = 0; realisation < batch; ++realisation) {
+    for (long i = 0; i < size; ++i) {
+      auto index = i + realisation * size;
+      component[index] *=
+          exp(factor * (trap[i] + intStrength * std::norm(component[index])));
+    }
+  }
+}
+
+void dampedFourierKernel(complexVector_t& fourierComponent,
+                         const std::vector<double>& wavenumber,
+                         std::complex<double> timeStep, double damping,
+                         unsigned int numRealisations) {
+  std::complex<double> factor =
+      std::complex<double>{-0.25 * damping, -0.25} * timeStep;
+  long size = static_cast<long>(wavenumber.size());
+  long batch = numRealisations;
+#pragma omp parallel for shared(fourierComponent, wavenumber, factor, size, \
+    batch) default(none)
+  for (long i = 0; i < size; ++i) {
+    std::complex<double> propagator = exp(factor * wavenumber[i]);
+    for (long realisation = 0; realisation < batch; ++realisation) {
+      fourierComponent[i + realisation * size] *= propagator;
+    }
+  }
+}
+
+void projectedFourierKernel(complexVector_t& fourierComponent,
+                            const std::vector<double>& wavenumber,
+                            std::complex<double> timeStep, double damping,
+                            const Projector& projector,
+                            unsigned int numRealisations) {
+  if (wavenumber.size() != projector.numRows() * projector.rowLength()) {
+    throw std::invalid_argument("Projector does not match the grid");
+  }
+  std::complex<double> factor =
+      std::complex<double>{-0.25 * damping, -0.25} * timeStep;
+  const auto& rowEnds = projector.rowEnds();
+  const auto& rowStarts = projector.rowStarts();
+  long numRows = static_cast<long>(projector.numRows());
+  long rowLength = projector.rowLength();
+  long size = static_cast<long>(wavenumber.size());
+  long batch = numRealisations;
+#pragma omp parallel for shared(fourierComponent, wavenumber, factor, \
+    rowEnds, rowStarts, numRows, rowLength, size, batch) default(none)
+  for (long row = 0; row < numRows; ++row) {
+    long first = row * rowLength;
+    long zeroFirst = first + rowEnds[row];
+    long zeroLast = first + rowStarts[row];
+
+    // The kept modes of the row lie either side of the zeroed range
+    for (auto [begin, end] : {std::pair{first, zeroFirst},
+                              std::pair{zeroLast, first + rowLength}}) {
+      for (long i = begin; i < end; ++i) {
+        std::complex<double> propagator = exp(factor * wavenumber[i]);
+        for (long realisation = 0; realisation < batch; ++realisation) {
+          fourierComponent[i + realisation * size] *= propagator;
+        }
+      }
+    }
+    for (long realisation = 0; realisation < batch; ++realisation) {
+      std::fill(fourierComponent.begin() + zeroFirst + realisation * size,
+                fourierComponent.begin() + zeroLast + realisation * size,
+                std::complex<double>{});
+    }
+  }
+}
+
+void stochasticInteractionKernel(complexVector_t& component,
+                                 const std::vector<double>& trap,
+                                 double intStrength, double chemicalPotential,
+                                 std::complex<double> timeStep, double damping,
+                                 double noiseAmplitude, std::uint64_t seed,
+                                 std::uint64_t stream,
+                                 unsigned int numRealisations) {
+  std::complex<double> factor = std::complex<double>{-damping, -1} * timeStep;
+  long size = static_cast<long>(trap.size());
+  long batch = numRealisations;
+#pragma omp parallel for collapse(2) shared(component, trap, intStrength, \
+    chemicalPotential, factor, noiseAmplitude, seed, stream, size, batch) \
+    default(none)
+  for (long realisation = 0; realisation < batch; ++realisation) {
+    for (long i = 0; i < size; ++i) {
+      auto index = i + realisation * size;
+      component[index] *=
+          exp(factor * (trap[i] + intStrength * std::norm(component[index]) -
+                        chemicalPotential));
+      if (noiseAmplitude != 0) {
+        component[index] +=
+            noiseAmplitude * complexGaussian(seed, stream + realisation, i);
+      }
+    }
+  }
+}
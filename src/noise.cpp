@@ -0,0 +1,253 @@
+#include "noise.h"
+#include <cmath>
+#include <stdexcept>
+
+philoxCounter_t philox4x32(philoxCounter_t counter, philoxKey_t key) {
+  constexpr std::uint64_t multiplier0 = 0xD2511F53;
+  constexpr std::uint64_t multiplier1 = 0xCD9E8D57;
+  constexpr std::uint32_t weyl0 = 0x9E3779B9;
+  constexpr std::uint32_t weyl1 = 0xBB67AE85;
+
+  for (int round = 0; round < 10; ++round) {
+    std::uint64_t product0 = multiplier0 * counter[0];
+    std::uint64_t product1 = multiplier1 * counter[2];
+    counter = {
+        static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+        static_cast<std::uint32_t>(product1),
+        static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+        static_cast<std::uint32_t>(product0)};
+    key[0] += weyl0;
+    key[1] += weyl1;
+  }
+
+  return counter;
+}
+
+// Draws the four words of randomness of one index from the generator
+philoxCounter_t philoxDraw(std::uint64_t seed, std::uint64_t stream,
+                           std::uint64_t index) {
+  return philox4x32({static_cast<std::uint32_t>(index),
+                     static_cast<std::uint32_t>(index >> 32),
+                     static_cast<std::uint32_t>(stream),
+                     static_cast<std::uint32_t>(stream >> 32)},
+                    {static_cast<std::uint32_t>(seed),
+                     static_cast<std::uint32_t>(seed >> 32)});
+}
+
+// Maps two words to a double in [0, 1) with the full 53 bits of precision
+double toUniform(std::uint32_t high, std::uint32_t low) {
+  std::uint64_t bits = (static_cast<std::uint64_t>(high) << 32 | low) >> 11;
+  return static_cast<double>(bits) * 0x1.0p-53;
+}
+
+std::complex<double> complexGaussian(std::uint64_t seed, std::uint64_t stream,
+                                     std::uint64_t index) {
+  philoxCounter_t words = philoxDraw(seed, stream, index);
+
+  // Box-Muller transform, with the radius drawn from (0, 1] to avoid log(0)
+  double radius = 1.0 - toUniform(words[0], words[1]);
+  double angle = 2 * PI * toUniform(words[2], words[3]);
+  return std::polar(std::sqrt(-std::log(radius)), angle);
+}
+
+double uniformPhase(std::uint64_t seed, std::uint64_t stream,
+                    std::uint64_t index) {
+  philoxCounter_t words = philoxDraw(seed, stream, index);
+  return 2 * PI * toUniform(words[0], words[1]);
+}
+
+double uniformReal(std::uint64_t seed, std::uint64_t stream,
+                   std::uint64_t index) {
+  philoxCounter_t words = philoxDraw(seed, stream, index);
+  return toUniform(words[0], words[1]);
+}
+
+// Adds amplitude(i) times a complex Gaussian to element i of each realisation,
+// where amplitude is any callable of the index within the realisation
+template <typename Amplitude>
+void addNoise(complexVector_t& field, const Amplitude& amplitude,
+              std::uint64_t seed, std::uint64_t stream,
+              unsigned int numRealisations) {
+  long size = static_cast<long>(field.size() / numRealisations);
+  long batch = numRealisations;
+#pragma omp parallel for collapse(2) shared(field, amplitude, seed, stream, \
+    size, batch) default(none)
+  for (long realisation = 0; realisation < batch; ++realisation) {
+    for (long i = 0; i < size; ++i) {
+      field[i + realisation * size] +=
+          amplitude(i) * complexGaussian(seed, stream + realisation, i);
+    }
+  }
+}
+
+void addComplexGaussian(complexVector_t& field, double amplitude,
+                        std::uint64_t seed, std::uint64_t stream,
+                        unsigned int numRealisations) {
+  addNoise(
+      field, [amplitude](long) { return amplitude; }, seed, stream,
+      numRealisations);
+}
+
+void applyRandomPhase(complexVector_t& field, std::uint64_t seed,
+                      std::uint64_t stream, unsigned int numRealisations) {
+  long size = static_cast<long>(field.size() / numRealisations);
+  long batch = numRealisations;
+#pragma omp parallel for collapse(2) shared(field, seed, stream, size, batch) \
+    default(none)
+  for (long realisation = 0; realisation < batch; ++realisation) {
+    for (long i = 0; i < size; ++i) {
+      field[i + realisation * size] *=
+          std::polar(1.0, uniformPhase(seed, stream + realisation, i));
+    }
+  }
+}
+
+// With the unnormalised forward FFT, a mode occupied by n atoms has an
+// amplitude of sqrt(n N / dV) in the Fourier space vector, for N points
+// of volume dV
+double modeScale(double numPoints, double volumeElement) {
+  return std::sqrt(numPoints / volumeElement);
+}
+
+void addThermalModes(complexVector_t& fourierComponent,
+                     const std::vector<double>& wavenumber, double scale,
+                     double temperature, double chemicalPotential,
+                     std::uint64_t seed, std::uint64_t stream,
+                     unsigned int numRealisations) {
+  if (chemicalPotential >= 0) {
+    throw std::invalid_argument(
+        "The chemical potential of a classical thermal field must be "
+        "negative");
+  }
+  addNoise(
+      fourierComponent,
+      [&wavenumber, scale, temperature, chemicalPotential](long i) {
+        return scale *
+               std::sqrt(temperature /
+                         (0.5 * wavenumber[i] - chemicalPotential));
+      },
+      seed, stream, numRealisations);
+}
+
+void addVacuumNoise(Wavefunction1D& wfn, std::uint64_t seed,
+                    std::uint64_t stream) {
+  double scale = modeScale(wfn.grid().shape(), wfn.grid().gridSpacing());
+  addComplexGaussian(wfn.fourierComponent(), scale * std::sqrt(0.5), seed,
+                     stream);
+  wfn.ifft();
+}
+
+void addVacuumNoise(Wavefunction2D& wfn, std::uint64_t seed,
+                    std::uint64_t stream) {
+  auto [xPoints, yPoints] = wfn.grid().shape();
+  auto [xGridSpacing, yGridSpacing] = wfn.grid().gridSpacing();
+  double scale = modeScale(static_cast<double>(xPoints) * yPoints,
+                           xGridSpacing * yGridSpacing);
+  addComplexGaussian(wfn.fourierComponent(), scale * std::sqrt(0.5), seed,
+                     stream);
+  wfn.ifft();
+}
+
+void addVacuumNoise(Wavefunction3D& wfn, std::uint64_t seed,
+                    std::uint64_t stream) {
+  auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  double scale = modeScale(static_cast<double>(xPoints) * yPoints * zPoints,
+                           xGridSpacing * yGridSpacing * zGridSpacing);
+  addComplexGaussian(wfn.fourierComponent(), scale * std::sqrt(0.5), seed,
+                     stream);
+  wfn.ifft();
+}
+
+void addVacuumNoise(EnsembleWavefunction1D& wfn, std::uint64_t seed,
+                    std::uint64_t stream) {
+  double scale = modeScale(wfn.grid().shape(), wfn.grid().gridSpacing());
+  addComplexGaussian(wfn.fourierComponent(), scale * std::sqrt(0.5), seed,
+                     stream, wfn.numRealisations());
+  wfn.ifft();
+}
+
+void addVacuumNoise(EnsembleWavefunction2D& wfn, std::uint64_t seed,
+                    std::uint64_t stream) {
+  auto [xPoints, yPoints] = wfn.grid().shape();
+  auto [xGridSpacing, yGridSpacing] = wfn.grid().gridSpacing();
+  double scale = modeScale(static_cast<double>(xPoints) * yPoints,
+                           xGridSpacing * yGridSpacing);
+  addComplexGaussian(wfn.fourierComponent(), scale * std::sqrt(0.5), seed,
+                     stream, wfn.numRealisations());
+  wfn.ifft();
+}
+
+void addThermalNoise(Wavefunction1D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream) {
+  double scale = modeScale(wfn.grid().shape(), wfn.grid().gridSpacing());
+  addThermalModes(wfn.fourierComponent(), wfn.grid().wavenumber(), scale,
+                  temperature, chemicalPotential, seed, stream, 1);
+  wfn.ifft();
+}
+
+void addThermalNoise(Wavefunction2D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream) {
+  auto [xPoints, yPoints] = wfn.grid().shape();
+  auto [xGridSpacing, yGridSpacing] = wfn.grid().gridSpacing();
+  double scale = modeScale(static_cast<double>(xPoints) * yPoints,
+                           xGridSpacing * yGridSpacing);
+  addThermalModes(wfn.fourierComponent(), wfn.grid().wavenumber(), scale,
+                  temperature, chemicalPotential, seed, stream, 1);
+  wfn.ifft();
+}
+
+void addThermalNoise(Wavefunction3D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream) {
+  auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  double scale = modeScale(static_cast<double>(xPoints) * yPoints * zPoints,
+                           xGridSpacing * yGridSpacing * zGridSpacing);
+  addThermalModes(wfn.fourierComponent(), wfn.grid().wavenumber(), scale,
+                  temperature, chemicalPotential, seed, stream, 1);
+  wfn.ifft();
+}
+
+void addThermalNoise(EnsembleWavefunction1D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream) {
+  double scale = modeScale(wfn.grid().shape(), wfn.grid().gridSpacing());
+  addThermalModes(wfn.fourierComponent(), wfn.grid().wavenumber(), scale,
+                  temperature, chemicalPotential, seed, stream,
+                  wfn.numRealisations());
+  wfn.ifft();
+}
+
+void addThermalNoise(EnsembleWavefunction2D& wfn, double temperature,
+                     double chemicalPotential, std::uint64_t seed,
+                     std::uint64_t stream) {
+  auto [xPoints, yPoints] = wfn.grid().shape();
+  auto [xGridSpacing, yGridSpacing] = wfn.grid().gridSpacing();
+  double scale = modeScale(static_cast<double>(xPoints) * yPoints,
+                           xGridSpacing * yGridSpacing);
+  addThermalModes(wfn.fourierComponent(), wfn.grid().wavenumber(), scale,
+                  temperature, chemicalPotential, seed, stream,
+                  wfn.numRealisations());
+  wfn.ifft();
+}
+
+void applyRandomPhase(Wavefunction1D& wfn, std::uint64_t seed,
+                      std::uint64_t stream) {
+  applyRandomPhase(wfn.component(), seed, stream);
+  wfn.fft();
+}
+
+void applyRandomPhase(Wavefunction2D& wfn, std::uint64_t seed,
+                      std::uint64_t stream) {
+  applyRandomPhase(wfn.component(), seed, stream);
+  wfn.fft();
+}
+
+void applyRandomPhase(Wavefunction3D& wfn, std::uint64_t seed,
+                      std::uint64_t stream) {
+  applyRandomPhase(wfn.component(), seed, stream);
+  wfn.fft();
+}
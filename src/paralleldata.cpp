@@ -0,0 +1,228 @@
+#include "paralleldata.h"
+#include <H5Dpublic.h>
+#include <H5FDmpio.h>
+#include <H5Ppublic.h>
+#include <H5Spublic.h>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+
+// Objects from 64 KiB up, i.e. the chunks, start on 1 MiB boundaries, so that
+// collective writes map onto whole file system stripes
+constexpr hsize_t alignmentThreshold = 64 << 10;
+constexpr hsize_t alignment = 1 << 20;
+
+HighFive::FileAccessProps parallelAccessProps(MPI_Comm comm) {
+  HighFive::FileAccessProps accessProps;
+  accessProps.add(HighFive::MPIOFileAccess{comm, MPI_INFO_NULL});
+  H5Pset_alignment(accessProps.getId(), alignmentThreshold, alignment);
+
+  return accessProps;
+}
+
+// Checks the slab of every rank before the file is opened, so that all ranks
+// throw together rather than leaving the others in a collective call
+MPI_Comm checkSlab(MPI_Comm comm, std::size_t xPoints, std::size_t localXStart,
+                   std::size_t localXPoints) {
+  int invalid = localXStart + localXPoints > xPoints ? 1 : 0;
+  int anyInvalid{};
+  MPI_Allreduce(&invalid, &anyInvalid, 1, MPI_INT, MPI_LOR, comm);
+  if (anyInvalid != 0) {
+    throw std::invalid_argument("Slab of a rank lies outside the grid");
+  }
+
+  return comm;
+}
+
+// Chunks hold one time and whole slabs along x: their x extent divides the
+// start of every slab, so that each chunk is written by a single rank. The
+// y and z extents are halved first to fit the target size, then x is
+// reduced to a smaller divisor.
+std::vector<std::size_t> slabChunkShape(MPI_Comm comm,
+                                        const std::vector<std::size_t>& shape,
+                                        std::size_t localXStart,
+                                        std::size_t chunkBytes) {
+  int numRanks{};
+  MPI_Comm_size(comm, &numRanks);
+  unsigned long start = localXStart;
+  std::vector<unsigned long> starts(numRanks);
+  MPI_Allgather(&start, 1, MPI_UNSIGNED_LONG, starts.data(), 1,
+                MPI_UNSIGNED_LONG, comm);
+
+  // A single slab spans the whole grid
+  std::size_t slabPoints = 0;
+  for (auto slabStart : starts) {
+    slabPoints = std::gcd(slabPoints, slabStart);
+  }
+  if (slabPoints == 0 || slabPoints > shape[0]) {
+    slabPoints = shape[0];
+  }
+
+  std::vector<std::size_t> chunk{1, slabPoints, shape[1], shape[2]};
+  auto chunkSize = [&chunk]() {
+    return std::accumulate(chunk.begin(), chunk.end(), std::size_t{1},
+                           std::multiplies<>()) *
+           sizeof(std::complex<double>);
+  };
+  while (chunkSize() > chunkBytes) {
+    if (chunk[2] > 1 || chunk[3] > 1) {
+      auto largest = std::max_element(chunk.begin() + 2, chunk.end());
+      *largest = (*largest + 1) / 2;
+    } else if (chunk[1] > 1) {
+      do {
+        chunk[1] -= 1;
+      } while (slabPoints % chunk[1] != 0);
+    } else {
+      break;
+    }
+  }
+
+  return chunk;
+}
+
+ParallelDataManager3D::ParallelDataManager3D(
+    const std::string& filename, MPI_Comm comm, const Parameters& params,
+    const std::tuple<unsigned int, unsigned int, unsigned int>& points,
+    const std::tuple<double, double, double>& gridSpacing,
+    std::size_t localXStart, std::size_t localXPoints,
+    const DataOptions& options)
+    : filename{filename},
+      file{filename,
+           HighFive::File::ReadWrite | HighFive::File::Create |
+               HighFive::File::Truncate,
+           parallelAccessProps(checkSlab(comm, std::get<0>(points),
+                                         localXStart, localXPoints))},
+      m_shape{std::get<0>(points), std::get<1>(points), std::get<2>(points)},
+      m_localXStart{localXStart},
+      m_localXPoints{localXPoints},
+      m_capacity{snapshotCapacity(params, options)},
+      m_dataSet{createWavefunctionDataSet(comm, options)} {
+  saveParameters(params, gridSpacing, options);
+}
+
+ParallelDataManager3D::ParallelDataManager3D(const std::string& filename,
+                                             const Parameters& params,
+                                             const DistributedGrid3D& grid,
+                                             const DataOptions& options)
+    : ParallelDataManager3D(filename, grid.communicator(), params,
+                            grid.shape(), grid.gridSpacing(),
+                            grid.localXStart(), grid.localXPoints(),
+                            options) {}
+
+ParallelDataManager3D::~ParallelDataManager3D() {
+  try {
+    if (m_numSnapshots < m_capacity) {
+      std::vector<std::size_t> dims{m_numSnapshots};
+      dims.insert(dims.end(), m_shape.begin(), m_shape.end());
+      m_dataSet.resize(dims);
+    }
+  } catch (const std::exception&) {
+    // Leave the preallocated extent rather than throwing from a destructor
+  }
+}
+
+void ParallelDataManager3D::saveParameters(
+    const Parameters& params,
+    const std::tuple<double, double, double>& gridSpacing,
+    const DataOptions& options) {
+  // Save condensate and time parameters to file
+  file.createDataSet("/parameters/intStrength", params.intStrength);
+  file.createDataSet("/parameters/numTimeSteps", params.numTimeSteps);
+  file.createDataSet("/parameters/dt", params.timeStep);
+  file.createDataSet("/parameters/saveInterval", options.saveInterval);
+
+  // Save grid parameters to file
+  file.createDataSet("/grid/xPoints", static_cast<unsigned int>(m_shape[0]));
+  file.createDataSet("/grid/yPoints", static_cast<unsigned int>(m_shape[1]));
+  file.createDataSet("/grid/zPoints", static_cast<unsigned int>(m_shape[2]));
+
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = gridSpacing;
+  file.createDataSet("/grid/xGridSpacing", xGridSpacing);
+  file.createDataSet("/grid/yGridSpacing", yGridSpacing);
+  file.createDataSet("/grid/zGridSpacing", zGridSpacing);
+}
+
+HighFive::DataSet ParallelDataManager3D::createWavefunctionDataSet(
+    MPI_Comm comm, const DataOptions& options) {
+  // Define data space with arbitrary length of the time dimension
+  std::vector<std::size_t> dims{m_capacity};
+  std::vector<std::size_t> maxDims{HighFive::DataSpace::UNLIMITED};
+  dims.insert(dims.end(), m_shape.begin(), m_shape.end());
+  maxDims.insert(maxDims.end(), m_shape.begin(), m_shape.end());
+  HighFive::DataSpace dataSpace(dims, maxDims);
+
+  // Every point is written, so skip writing fill values on allocation
+  std::vector<std::size_t> chunk =
+      slabChunkShape(comm, m_shape, m_localXStart, options.chunkBytes);
+  HighFive::DataSetCreateProps createProps;
+  createProps.add(
+      HighFive::Chunking(std::vector<hsize_t>(chunk.begin(), chunk.end())));
+  H5Pset_fill_time(createProps.getId(), H5D_FILL_TIME_NEVER);
+
+  // As in DataManager3D, readers take the count of saved snapshots from the
+  // "numSnapshots" attribute rather than the preallocated time extent
+  HighFive::DataSet dataSet = file.createDataSet(
+      "wavefunction", dataSpace, HighFive::AtomicType<std::complex<double>>(),
+      createProps);
+  dataSet.createAttribute("numSnapshots", std::size_t{0});
+  return dataSet;
+}
+
+void ParallelDataManager3D::saveWavefunctionData(const complexVector_t& slab) {
+  if (slab.size() != m_localXPoints * m_shape[1] * m_shape[2]) {
+    throw std::invalid_argument("Slab does not match the local grid");
+  }
+
+  writeSlab(slab.data());
+}
+
+void ParallelDataManager3D::saveWavefunctionData(
+    DistributedWavefunction3D& wfn) {
+  // Only the first localPoints values of the component are the slab
+  wfn.ifft();
+  writeSlab(wfn.component().data());
+}
+
+void ParallelDataManager3D::writeSlab(const std::complex<double>* slab) {
+  // Every rank grows the dataset together, as resizing is collective
+  if (m_numSnapshots == m_capacity) {
+    m_capacity *= 2;
+    std::vector<std::size_t> dims{m_capacity};
+    dims.insert(dims.end(), m_shape.begin(), m_shape.end());
+    m_dataSet.resize(dims);
+  }
+
+  std::array<hsize_t, 4> offset{m_numSnapshots, m_localXStart, 0, 0};
+  std::array<hsize_t, 4> count{1, m_localXPoints, m_shape[1], m_shape[2]};
+  hid_t fileSpace = H5Dget_space(m_dataSet.getId());
+  hid_t memorySpace = H5Screate_simple(4, count.data(), nullptr);
+  if (m_localXPoints > 0) {
+    H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset.data(), nullptr,
+                        count.data(), nullptr);
+  } else {
+    // Ranks without a slab still take part in the collective write
+    H5Sselect_none(fileSpace);
+    H5Sselect_none(memorySpace);
+  }
+
+  hid_t transferProps = H5Pcreate(H5P_DATASET_XFER);
+  H5Pset_dxpl_mpio(transferProps, H5FD_MPIO_COLLECTIVE);
+  herr_t status = H5Dwrite(
+      m_dataSet.getId(), HighFive::AtomicType<std::complex<double>>().getId(),
+      memorySpace, fileSpace, transferProps, slab);
+  H5Pclose(transferProps);
+  H5Sclose(memorySpace);
+  H5Sclose(fileSpace);
+  if (status < 0) {
+    throw std::runtime_error("Failed to write wavefunction slab");
+  }
+
+  m_numSnapshots += 1;
+  m_dataSet.getAttribute("numSnapshots").write(m_numSnapshots);
+}
+
+std::size_t ParallelDataManager3D::numSnapshots() const {
+  return m_numSnapshots;
+}
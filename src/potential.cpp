@@ -0,0 +1,223 @@
+#include "potential.h"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+// Positions of the grid points along one axis, matching the grid meshes
+std::vector<double> axisPositions(unsigned int points, double gridSpacing) {
+  std::vector<double> positions(points);
+  for (int i = 0; i < points; ++i) {
+    positions[i] = (i - points / 2.) * gridSpacing;
+  }
+
+  return positions;
+}
+
+std::vector<double> harmonicProfile(unsigned int points, double gridSpacing,
+                                    double omega) {
+  std::vector<double> profile = axisPositions(points, gridSpacing);
+  for (auto& value : profile) {
+    value = 0.5 * omega * omega * value * value;
+  }
+
+  return profile;
+}
+
+SeparableTrap harmonicTrap(const Grid1D& grid, double omega) {
+  SeparableTrap trap{};
+  trap.axis[0] = harmonicProfile(grid.shape(), grid.gridSpacing(), omega);
+
+  return trap;
+}
+
+SeparableTrap harmonicTrap(const Grid2D& grid,
+                           std::tuple<double, double> omega) {
+  auto [xPoints, yPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing] = grid.gridSpacing();
+  auto [xOmega, yOmega] = omega;
+
+  SeparableTrap trap{};
+  trap.axis[0] = harmonicProfile(xPoints, xGridSpacing, xOmega);
+  trap.axis[1] = harmonicProfile(yPoints, yGridSpacing, yOmega);
+
+  return trap;
+}
+
+SeparableTrap harmonicTrap(const Grid3D& grid,
+                           std::tuple<double, double, double> omega) {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = grid.gridSpacing();
+  auto [xOmega, yOmega, zOmega] = omega;
+
+  SeparableTrap trap{};
+  trap.axis[0] = harmonicProfile(xPoints, xGridSpacing, xOmega);
+  trap.axis[1] = harmonicProfile(yPoints, yGridSpacing, yOmega);
+  trap.axis[2] = harmonicProfile(zPoints, zGridSpacing, zOmega);
+
+  return trap;
+}
+
+std::vector<double> boxProfile(unsigned int points, double gridSpacing,
+                               double height, double halfWidth) {
+  std::vector<double> profile = axisPositions(points, gridSpacing);
+  for (auto& value : profile) {
+    value = (std::abs(value) < halfWidth) ? 0.0 : height;
+  }
+
+  return profile;
+}
+
+SeparableTrap boxTrap(const Grid3D& grid, double height,
+                      std::tuple<double, double, double> halfWidth) {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = grid.gridSpacing();
+  auto [xHalfWidth, yHalfWidth, zHalfWidth] = halfWidth;
+
+  SeparableTrap trap{};
+  trap.axis[0] = boxProfile(xPoints, xGridSpacing, height, xHalfWidth);
+  trap.axis[1] = boxProfile(yPoints, yGridSpacing, height, yHalfWidth);
+  trap.axis[2] = boxProfile(zPoints, zGridSpacing, height, zHalfWidth);
+
+  return trap;
+}
+
+TrapPropagator::TrapPropagator(const SeparableTrap& trap,
+                               const std::array<unsigned int, 3>& shape,
+                               std::complex<double> timeStep)
+    : m_timeStep{timeStep} {
+  for (int axis = 0; axis < 3; ++axis) {
+    if (trap.axis[axis].empty()) {
+      m_axis[axis].assign(shape[axis], 1.0);
+      continue;
+    }
+    if (trap.axis[axis].size() != shape[axis]) {
+      throw std::invalid_argument(
+          "Trap profile does not match the number of grid points");
+    }
+    m_axis[axis].resize(shape[axis]);
+    for (int i = 0; i < shape[axis]; ++i) {
+      m_axis[axis][i] = std::exp(std::complex<double>{0, -1} * timeStep *
+                                 trap.axis[axis][i]);
+    }
+  }
+}
+
+TrapPropagator::TrapPropagator(const SeparableTrap& trap, const Grid1D& grid,
+                               std::complex<double> timeStep)
+    : TrapPropagator(trap, {grid.shape(), 1, 1}, timeStep) {}
+
+TrapPropagator::TrapPropagator(const SeparableTrap& trap, const Grid2D& grid,
+                               std::complex<double> timeStep)
+    : TrapPropagator(trap,
+                     {std::get<0>(grid.shape()), std::get<1>(grid.shape()), 1},
+                     timeStep) {}
+
+TrapPropagator::TrapPropagator(const SeparableTrap& trap, const Grid3D& grid,
+                               std::complex<double> timeStep)
+    : TrapPropagator(trap,
+                     {std::get<0>(grid.shape()), std::get<1>(grid.shape()),
+                      std::get<2>(grid.shape())},
+                     timeStep) {}
+
+std::complex<double> TrapPropagator::timeStep() const { return m_timeStep; }
+
+const std::vector<std::complex<double>>& TrapPropagator::axis(
+    Axis axis) const {
+  return m_axis[static_cast<int>(axis)];
+}
+
+void Potential::setStatic(std::vector<double> potential) {
+  m_static = std::move(potential);
+}
+
+void Potential::addSeparable(Axis axis, std::vector<double> profile,
+                             Amplitude amplitude) {
+  m_separable.push_back({axis, std::move(profile), std::move(amplitude)});
+}
+
+void Potential::addSeparable(const SeparableTrap& trap) {
+  for (int axis = 0; axis < 3; ++axis) {
+    if (!trap.axis[axis].empty()) {
+      addSeparable(static_cast<Axis>(axis), trap.axis[axis]);
+    }
+  }
+}
+
+void Potential::addStirrer(GaussianStirrer stirrer) {
+  m_stirrers.push_back(std::move(stirrer));
+}
+
+PotentialTerms Potential::evaluate(const std::array<unsigned int, 3>& shape,
+                                   const std::array<double, 3>& gridSpacing,
+                                   double time) const {
+  PotentialTerms terms{};
+  if (!m_static.empty() &&
+      m_static.size() != std::size_t{shape[0]} * shape[1] * shape[2]) {
+    throw std::invalid_argument(
+        "Static potential does not match the number of grid points");
+  }
+  terms.staticPart = m_static.empty() ? nullptr : &m_static;
+
+  for (int axis = 0; axis < 3; ++axis) {
+    terms.axis[axis].assign(shape[axis], 0.0);
+  }
+  for (const auto& part : m_separable) {
+    double amplitude = part.amplitude ? part.amplitude(time) : 1.0;
+    auto& values = terms.axis[static_cast<int>(part.axis)];
+    if (part.profile.size() != values.size()) {
+      throw std::invalid_argument(
+          "Separable profile does not match the number of grid points");
+    }
+    for (int i = 0; i < values.size(); ++i) {
+      values[i] += amplitude * part.profile[i];
+    }
+  }
+
+  for (const auto& stirrer : m_stirrers) {
+    auto centre = stirrer.position(time);
+    double halfWidth = stirrer.cutoff * stirrer.width;
+    StirrerTerm term{};
+    bool inside = true;
+
+    for (int axis = 0; axis < 3; ++axis) {
+      if (shape[axis] == 1) {
+        term.begin[axis] = 0;
+        term.end[axis] = 1;
+        term.profile[axis] = {1.0};
+        continue;
+      }
+
+      // Grid points sit at (i - N / 2) * dx, as in the grid meshes
+      double offset = shape[axis] / 2.;
+      double first =
+          std::ceil((centre[axis] - halfWidth) / gridSpacing[axis] + offset);
+      double last =
+          std::floor((centre[axis] + halfWidth) / gridSpacing[axis] + offset);
+      first = std::max(first, 0.0);
+      last = std::min(last, shape[axis] - 1.0);
+      if (first > last) {
+        inside = false;
+        break;
+      }
+
+      term.begin[axis] = static_cast<unsigned int>(first);
+      term.end[axis] = static_cast<unsigned int>(last) + 1;
+      for (auto i = term.begin[axis]; i < term.end[axis]; ++i) {
+        double distance = (i - offset) * gridSpacing[axis] - centre[axis];
+        term.profile[axis].push_back(std::exp(
+            -distance * distance / (2 * stirrer.width * stirrer.width)));
+      }
+    }
+    if (!inside) {
+      continue;
+    }
+
+    double amplitude = stirrer.amplitude(time);
+    for (auto& value : term.profile[0]) {
+      value *= amplitude;
+    }
+    terms.stirrers.push_back(std::move(term));
+  }
+
+  return terms;
+}
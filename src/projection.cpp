@@ -0,0 +1,98 @@
+#include "projection.h"
+#include <array>
+#include <stdexcept>
+
+unsigned int checkedAxis(unsigned int axis) {
+  if (axis > 2) {
+    throw std::invalid_argument("Projection axis must be 0, 1 or 2");
+  }
+
+  return axis;
+}
+
+// Remaining axes of a 3D grid projected along one axis, in their order
+std::array<unsigned int, 2> remainingAxes(unsigned int axis) {
+  switch (checkedAxis(axis)) {
+    case 0:
+      return {1, 2};
+    case 1:
+      return {0, 2};
+    default:
+      return {0, 1};
+  }
+}
+
+// Integrates values of a 3D array along one axis, for every index of the two
+// remaining axes. If centred, the remaining axes are shifted by half their
+// length, moving index 0 to the centre as for FFTW-ordered modes.
+template <typename Value>
+std::vector<double> integrateAxis(const Grid3D& grid, unsigned int axis,
+                                  double scale, bool centred, Value value) {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  std::array<int, 3> points{static_cast<int>(xPoints),
+                            static_cast<int>(yPoints),
+                            static_cast<int>(zPoints)};
+  std::array<int, 3> strides{points[1] * points[2], points[2], 1};
+  auto [rowAxis, columnAxis] = remainingAxes(axis);
+
+  int rows = points[rowAxis];
+  int columns = points[columnAxis];
+  int depth = points[axis];
+  int rowStride = strides[rowAxis];
+  int columnStride = strides[columnAxis];
+  int depthStride = strides[axis];
+  int rowShift = centred ? rows / 2 : 0;
+  int columnShift = centred ? columns / 2 : 0;
+
+  std::vector<double> projection(rows * columns);
+#pragma omp parallel for collapse(2)                                         \
+    shared(rows, columns, depth, rowStride, columnStride, depthStride,       \
+               rowShift, columnShift, scale, value, projection) default(none)
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < columns; ++j) {
+      int offset = i * rowStride + j * columnStride;
+      double sum = 0;
+      for (int k = 0; k < depth; ++k) {
+        sum += value(offset + k * depthStride);
+      }
+
+      int row = (i + rowShift) % rows;
+      int column = (j + columnShift) % columns;
+      projection[column + row * columns] = scale * sum;
+    }
+  }
+
+  return projection;
+}
+
+std::vector<double> columnDensity(Wavefunction3D& wfn, unsigned int axis) {
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  std::array<double, 3> gridSpacing{xGridSpacing, yGridSpacing, zGridSpacing};
+  const complexVector_t& component = wfn.component();
+
+  return integrateAxis(
+      wfn.grid(), axis, gridSpacing[checkedAxis(axis)], false,
+      [&component](int index) { return std::norm(component[index]); });
+}
+
+std::vector<double> columnMomentumDensity(Wavefunction3D& wfn,
+                                          unsigned int axis) {
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  auto [xFourierGridSpacing, yFourierGridSpacing, zFourierGridSpacing] =
+      wfn.grid().fourierGridSpacing();
+  std::array<double, 3> fourierGridSpacing{
+      xFourierGridSpacing, yFourierGridSpacing, zFourierGridSpacing};
+  auto [rowAxis, columnAxis] = remainingAxes(axis);
+  const complexVector_t& fourierComponent = wfn.fourierComponent();
+
+  // The FFT is unnormalised, so by Parseval's theorem the atom number is
+  // dV / N times the sum of |psi(k)|^2
+  double scale = xGridSpacing * yGridSpacing * zGridSpacing /
+                 (static_cast<double>(fourierComponent.size()) *
+                  fourierGridSpacing[rowAxis] * fourierGridSpacing[columnAxis]);
+
+  return integrateAxis(wfn.grid(), axis, scale, true,
+                       [&fourierComponent](int index) {
+                         return std::norm(fourierComponent[index]);
+                       });
+}
@@ -0,0 +1,86 @@
+#include "projector.h"
+#include <stdexcept>
+
+Projector::Projector(Grid1D& grid, double cutoff) : m_cutoff{cutoff} {
+  buildRows(grid.wavenumber(), grid.shape());
+}
+
+Projector::Projector(Grid2D& grid, double cutoff) : m_cutoff{cutoff} {
+  auto [xPoints, yPoints] = grid.shape();
+  buildRows(grid.wavenumber(), yPoints);
+}
+
+Projector::Projector(Grid3D& grid, double cutoff) : m_cutoff{cutoff} {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  buildRows(grid.wavenumber(), zPoints);
+}
+
+void Projector::buildRows(const std::vector<double>& wavenumber,
+                          unsigned int rowLength) {
+  m_rowLength = rowLength;
+  std::size_t numRows = wavenumber.size() / rowLength;
+  m_rowEnds.assign(numRows, 0);
+  m_rowStarts.assign(numRows, rowLength);
+
+  // The wavenumber grows along the first half of each row and shrinks along
+  // the second, so the kept modes of each half are contiguous
+  double maxWavenumber = m_cutoff * m_cutoff;
+  for (std::size_t row = 0; row < numRows; ++row) {
+    for (unsigned int j = 0; j < rowLength; ++j) {
+      if (wavenumber[j + row * rowLength] >= maxWavenumber) {
+        continue;
+      }
+      if (j < rowLength / 2) {
+        m_rowEnds[row] = j + 1;
+      } else if (j < m_rowStarts[row]) {
+        m_rowStarts[row] = j;
+      }
+    }
+  }
+}
+
+double Projector::cutoff() const { return m_cutoff; }
+
+unsigned int Projector::rowLength() const { return m_rowLength; }
+
+std::size_t Projector::numRows() const { return m_rowEnds.size(); }
+
+const std::vector<unsigned int>& Projector::rowEnds() const {
+  return m_rowEnds;
+}
+
+const std::vector<unsigned int>& Projector::rowStarts() const {
+  return m_rowStarts;
+}
+
+std::size_t Projector::numModes() const {
+  std::size_t numModes = 0;
+  for (std::size_t row = 0; row < numRows(); ++row) {
+    numModes += m_rowEnds[row] + m_rowLength - m_rowStarts[row];
+  }
+
+  return numModes;
+}
+
+void Projector::apply(complexVector_t& fourierComponent,
+                      unsigned int numRealisations) const {
+  long numRows = static_cast<long>(this->numRows());
+  long rowLength = m_rowLength;
+  long size = numRows * rowLength;
+  if (fourierComponent.size() != size * numRealisations) {
+    throw std::invalid_argument("Projector does not match the grid");
+  }
+  long batch = numRealisations;
+  const auto& rowEnds = m_rowEnds;
+  const auto& rowStarts = m_rowStarts;
+#pragma omp parallel for collapse(2) shared(fourierComponent, rowEnds, \
+    rowStarts, numRows, rowLength, size, batch) default(none)
+  for (long realisation = 0; realisation < batch; ++realisation) {
+    for (long row = 0; row < numRows; ++row) {
+      auto first = fourierComponent.begin() + realisation * size +
+                   row * rowLength;
+      std::fill(first + rowEnds[row], first + rowStarts[row],
+                std::complex<double>{});
+    }
+  }
+}
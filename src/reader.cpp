@@ -0,0 +1,220 @@
+#include "reader.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+DataReader::DataReader(const std::string& filename)
+    : m_file{filename, HighFive::File::ReadOnly} {}
+
+std::vector<std::size_t> DataReader::dimensions(
+    const std::string& field) const {
+  return m_file.getDataSet(field).getDimensions();
+}
+
+std::string DataReader::wavefunctionField() const {
+  return m_file.exist("wavefunction") ? "wavefunction" : "wavefunctionFloat";
+}
+
+bool DataReader::fourierOutput() const {
+  int fourierOutput = 0;
+  if (m_file.exist("/parameters/fourierOutput")) {
+    m_file.getDataSet("/parameters/fourierOutput").read(fourierOutput);
+  }
+
+  return fourierOutput != 0;
+}
+
+std::size_t DataReader::keyframeInterval() const {
+  std::size_t keyframeInterval = 0;
+  if (m_file.exist("/parameters/keyframeInterval")) {
+    m_file.getDataSet("/parameters/keyframeInterval").read(keyframeInterval);
+  }
+
+  return keyframeInterval;
+}
+
+Parameters DataReader::parameters() const {
+  Parameters params{};
+  m_file.getDataSet("/parameters/intStrength").read(params.intStrength);
+  m_file.getDataSet("/parameters/numTimeSteps").read(params.numTimeSteps);
+  m_file.getDataSet("/parameters/dt").read(params.timeStep);
+
+  return params;
+}
+
+Grid1D DataReader::grid1D() const {
+  unsigned int xPoints{};
+  double xGridSpacing{};
+  m_file.getDataSet("/grid/xPoints").read(xPoints);
+  m_file.getDataSet("/grid/xGridSpacing").read(xGridSpacing);
+
+  return {xPoints, xGridSpacing};
+}
+
+Grid2D DataReader::grid2D() const {
+  unsigned int xPoints{};
+  unsigned int yPoints{};
+  double xGridSpacing{};
+  double yGridSpacing{};
+  m_file.getDataSet("/grid/xPoints").read(xPoints);
+  m_file.getDataSet("/grid/yPoints").read(yPoints);
+  m_file.getDataSet("/grid/xGridSpacing").read(xGridSpacing);
+  m_file.getDataSet("/grid/yGridSpacing").read(yGridSpacing);
+
+  return {{xPoints, yPoints}, {xGridSpacing, yGridSpacing}};
+}
+
+Grid3D DataReader::grid3D() const {
+  unsigned int xPoints{};
+  unsigned int yPoints{};
+  unsigned int zPoints{};
+  double xGridSpacing{};
+  double yGridSpacing{};
+  double zGridSpacing{};
+  m_file.getDataSet("/grid/xPoints").read(xPoints);
+  m_file.getDataSet("/grid/yPoints").read(yPoints);
+  m_file.getDataSet("/grid/zPoints").read(zPoints);
+  m_file.getDataSet("/grid/xGridSpacing").read(xGridSpacing);
+  m_file.getDataSet("/grid/yGridSpacing").read(yGridSpacing);
+  m_file.getDataSet("/grid/zGridSpacing").read(zGridSpacing);
+
+  return {{xPoints, yPoints, zPoints},
+          {xGridSpacing, yGridSpacing, zGridSpacing}};
+}
+
+std::vector<std::size_t> DataReader::shape(const std::string& field) const {
+  std::vector<std::size_t> dims = dimensions(field);
+  return {dims.begin() + 1, dims.end()};
+}
+
+std::size_t DataReader::numSnapshots(const std::string& field) const {
+  // The time extent of a dataset still being written is its capacity, so
+  // prefer the count of saved snapshots where it is recorded
+  HighFive::DataSet dataSet = m_file.getDataSet(field);
+  if (dataSet.hasAttribute("numSnapshots")) {
+    std::size_t numSnapshots{};
+    dataSet.getAttribute("numSnapshots").read(numSnapshots);
+    return numSnapshots;
+  }
+
+  return dataSet.getDimensions()[0];
+}
+
+double DataReader::time(std::size_t index) const {
+  if (m_file.exist("/timeseries/snapshotTime")) {
+    HighFive::DataSet snapshotTime =
+        m_file.getDataSet("/timeseries/snapshotTime");
+    if (index >= snapshotTime.getDimensions()[0]) {
+      throw std::out_of_range("Time of the snapshot was not recorded");
+    }
+
+    double time{};
+    snapshotTime.select({index}, {1}).read(&time);
+    return time;
+  }
+
+  // Files written before saveInterval was recorded saved every step
+  int saveInterval = 1;
+  if (m_file.exist("/parameters/saveInterval")) {
+    m_file.getDataSet("/parameters/saveInterval").read(saveInterval);
+  }
+
+  return static_cast<double>(index) * saveInterval *
+         parameters().timeStep.real();
+}
+
+std::size_t DataReader::snapshotIndex(double time) const {
+  if (m_file.exist("/timeseries/snapshotTime")) {
+    // Recorded times are increasing, but may trail the snapshots of a file
+    // still being written
+    std::vector<double> times;
+    m_file.getDataSet("/timeseries/snapshotTime").read(times);
+    times.resize(std::min(times.size(), numSnapshots()));
+    if (times.empty()) {
+      return 0;
+    }
+
+    auto next = std::lower_bound(times.begin(), times.end(), time);
+    if (next == times.end() ||
+        (next != times.begin() && time - *(next - 1) <= *next - time)) {
+      --next;
+    }
+    return static_cast<std::size_t>(next - times.begin());
+  }
+
+  double snapshotSpacing = this->time(1);
+  std::size_t lastIndex = std::max<std::size_t>(numSnapshots(), 1) - 1;
+  if (snapshotSpacing <= 0) {
+    return 0;
+  }
+
+  double index = std::round(time / snapshotSpacing);
+  return static_cast<std::size_t>(
+      std::clamp(index, 0.0, static_cast<double>(lastIndex)));
+}
+
+void readWavefunction(const HighFive::File& file, const std::string& field,
+                      std::size_t index, const std::vector<std::size_t>& shape,
+                      std::size_t keyframeInterval,
+                      complexVector_t& component) {
+  std::vector<std::size_t> dims = file.getDataSet(field).getDimensions();
+  if (!std::equal(shape.begin(), shape.end(), dims.begin() + 1, dims.end())) {
+    throw std::invalid_argument(
+        "Grid of the wave function does not match the saved snapshots");
+  }
+
+  if (field == "wavefunction" && keyframeInterval > 0) {
+    // Copy into place, as the FFT plans hold the address of the component
+    complexVector_t snapshot = readDeltaSnapshot(
+        file.getDataSet(field), index, keyframeInterval,
+        std::vector<std::size_t>(shape.size(), 0), shape);
+    std::copy(snapshot.begin(), snapshot.end(), component.begin());
+    return;
+  }
+
+  std::vector<std::size_t> offset(dims.size(), 0);
+  std::vector<std::size_t> count{1};
+  offset[0] = index;
+  count.insert(count.end(), shape.begin(), shape.end());
+  file.getDataSet(field).select(offset, count).read(component.data());
+}
+
+void DataReader::readSnapshot(std::size_t index, Wavefunction1D& wfn) const {
+  if (fourierOutput()) {
+    readWavefunction(m_file, wavefunctionField(), index, {wfn.grid().shape()},
+                     keyframeInterval(), wfn.fourierComponent());
+    wfn.ifft();
+  } else {
+    readWavefunction(m_file, wavefunctionField(), index, {wfn.grid().shape()},
+                     keyframeInterval(), wfn.component());
+    wfn.fft();
+  }
+}
+
+void DataReader::readSnapshot(std::size_t index, Wavefunction2D& wfn) const {
+  auto [xPoints, yPoints] = wfn.grid().shape();
+  if (fourierOutput()) {
+    readWavefunction(m_file, wavefunctionField(), index, {xPoints, yPoints},
+                     keyframeInterval(), wfn.fourierComponent());
+    wfn.ifft();
+  } else {
+    readWavefunction(m_file, wavefunctionField(), index, {xPoints, yPoints},
+                     keyframeInterval(), wfn.component());
+    wfn.fft();
+  }
+}
+
+void DataReader::readSnapshot(std::size_t index, Wavefunction3D& wfn) const {
+  auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
+  if (fourierOutput()) {
+    readWavefunction(m_file, wavefunctionField(), index,
+                     {xPoints, yPoints, zPoints}, keyframeInterval(),
+                     wfn.fourierComponent());
+    wfn.ifft();
+  } else {
+    readWavefunction(m_file, wavefunctionField(), index,
+                     {xPoints, yPoints, zPoints}, keyframeInterval(),
+                     wfn.component());
+    wfn.fft();
+  }
+}
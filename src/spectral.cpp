@@ -0,0 +1,164 @@
+#include "spectral.h"
+
+// Maps each target index along one axis to the source index holding the same
+// signed mode, or -1 if that mode is not shared by both grids.
+std::vector<long> modeMap(unsigned int sourcePoints,
+                          unsigned int targetPoints) {
+  long common = std::min(sourcePoints, targetPoints);
+  std::vector<long> map(targetPoints, -1);
+
+  for (long i = 0; i < targetPoints; ++i) {
+    long mode = (i < (targetPoints + 1) / 2)
+                    ? i
+                    : i - static_cast<long>(targetPoints);
+    if (mode < -common / 2 || mode >= (common + 1) / 2) {
+      continue;
+    }
+    map[i] = (mode >= 0) ? mode : mode + static_cast<long>(sourcePoints);
+  }
+
+  return map;
+}
+
+void resampleFourier(const complexVector_t& source, unsigned int sourcePoints,
+                     complexVector_t& target, unsigned int targetPoints) {
+  resampleFourier(source, {sourcePoints, 1, 1}, target, {targetPoints, 1, 1});
+}
+
+void resampleFourier(const complexVector_t& source,
+                     std::tuple<unsigned int, unsigned int> sourceShape,
+                     complexVector_t& target,
+                     std::tuple<unsigned int, unsigned int> targetShape) {
+  auto [xSource, ySource] = sourceShape;
+  auto [xTarget, yTarget] = targetShape;
+  resampleFourier(source, {xSource, ySource, 1}, target,
+                  {xTarget, yTarget, 1});
+}
+
+void resampleFourier(
+    const complexVector_t& source,
+    std::tuple<unsigned int, unsigned int, unsigned int> sourceShape,
+    complexVector_t& target,
+    std::tuple<unsigned int, unsigned int, unsigned int> targetShape) {
+  auto [xSource, ySource, zSource] = sourceShape;
+  auto [xTarget, yTarget, zTarget] = targetShape;
+  target.resize(static_cast<size_t>(xTarget) * yTarget * zTarget);
+
+  std::vector<long> xMap = modeMap(xSource, xTarget);
+  std::vector<long> yMap = modeMap(ySource, yTarget);
+  std::vector<long> zMap = modeMap(zSource, zTarget);
+
+  // The forward FFT is unnormalised, so rescale by the ratio of grid sizes to
+  // keep position space amplitudes unchanged
+  double scale = static_cast<double>(xTarget) * yTarget * zTarget /
+                 (static_cast<double>(xSource) * ySource * zSource);
+
+#pragma omp parallel for collapse(2) shared(source, target, xMap, yMap, zMap, \
+    scale, xTarget, yTarget, zTarget, ySource, zSource) default(none)
+  for (int i = 0; i < xTarget; ++i) {
+    for (int j = 0; j < yTarget; ++j) {
+      for (int k = 0; k < zTarget; ++k) {
+        auto index = k + zTarget * (j + i * yTarget);
+        if (xMap[i] < 0 || yMap[j] < 0 || zMap[k] < 0) {
+          target[index] = 0.0;
+          continue;
+        }
+        auto sourceIndex = zMap[k] + zSource * (yMap[j] + xMap[i] * ySource);
+        target[index] = scale * source[sourceIndex];
+      }
+    }
+  }
+}
+
+// Coarse number of points spanning the same length, at least one
+unsigned int coarsePoints(unsigned int points, unsigned int factor) {
+  return std::max(points / std::max(factor, 1U), 1U);
+}
+
+double coarseGridSpacing(unsigned int points, double gridSpacing,
+                         unsigned int factor) {
+  return points * gridSpacing / coarsePoints(points, factor);
+}
+
+Grid1D coarseGrid(const Grid1D& grid, unsigned int factor) {
+  return {coarsePoints(grid.shape(), factor),
+          coarseGridSpacing(grid.shape(), grid.gridSpacing(), factor)};
+}
+
+Grid2D coarseGrid(const Grid2D& grid, unsigned int factor) {
+  auto [xPoints, yPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing] = grid.gridSpacing();
+  return {{coarsePoints(xPoints, factor), coarsePoints(yPoints, factor)},
+          {coarseGridSpacing(xPoints, xGridSpacing, factor),
+           coarseGridSpacing(yPoints, yGridSpacing, factor)}};
+}
+
+Grid3D coarseGrid(const Grid3D& grid, unsigned int factor) {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = grid.gridSpacing();
+  return {{coarsePoints(xPoints, factor), coarsePoints(yPoints, factor),
+           coarsePoints(zPoints, factor)},
+          {coarseGridSpacing(xPoints, xGridSpacing, factor),
+           coarseGridSpacing(yPoints, yGridSpacing, factor),
+           coarseGridSpacing(zPoints, zGridSpacing, factor)}};
+}
+
+SpectralDownsampler1D::SpectralDownsampler1D(const Grid1D& grid,
+                                             unsigned int factor)
+    : m_grid{coarseGrid(grid, factor)},
+      m_wfn{m_grid},
+      m_sourcePoints{grid.shape()} {}
+
+const Grid1D& SpectralDownsampler1D::grid() const { return m_grid; }
+
+const complexVector_t& SpectralDownsampler1D::downsample(Wavefunction1D& wfn,
+                                                         bool fourierSpace) {
+  resampleFourier(wfn.fourierComponent(), m_sourcePoints,
+                  m_wfn.fourierComponent(), m_grid.shape());
+  if (fourierSpace) {
+    return m_wfn.fourierComponent();
+  }
+
+  m_wfn.ifft();
+  return m_wfn.component();
+}
+
+SpectralDownsampler2D::SpectralDownsampler2D(const Grid2D& grid,
+                                             unsigned int factor)
+    : m_grid{coarseGrid(grid, factor)},
+      m_wfn{m_grid},
+      m_sourceShape{grid.shape()} {}
+
+const Grid2D& SpectralDownsampler2D::grid() const { return m_grid; }
+
+const complexVector_t& SpectralDownsampler2D::downsample(Wavefunction2D& wfn,
+                                                         bool fourierSpace) {
+  resampleFourier(wfn.fourierComponent(), m_sourceShape,
+                  m_wfn.fourierComponent(), m_grid.shape());
+  if (fourierSpace) {
+    return m_wfn.fourierComponent();
+  }
+
+  m_wfn.ifft();
+  return m_wfn.component();
+}
+
+SpectralDownsampler3D::SpectralDownsampler3D(const Grid3D& grid,
+                                             unsigned int factor)
+    : m_grid{coarseGrid(grid, factor)},
+      m_wfn{m_grid},
+      m_sourceShape{grid.shape()} {}
+
+const Grid3D& SpectralDownsampler3D::grid() const { return m_grid; }
+
+const complexVector_t& SpectralDownsampler3D::downsample(Wavefunction3D& wfn,
+                                                         bool fourierSpace) {
+  resampleFourier(wfn.fourierComponent(), m_sourceShape,
+                  m_wfn.fourierComponent(), m_grid.shape());
+  if (fourierSpace) {
+    return m_wfn.fourierComponent();
+  }
+
+  m_wfn.ifft();
+  return m_wfn.component();
+}
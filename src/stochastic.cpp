@@ -0,0 +1,134 @@
+#include "stochastic.h"
+#include "kernels.h"
+#include <cmath>
+
+// Standard deviation of the Wiener increment of the reservoir at each point
+double noiseAmplitude(const Reservoir& reservoir, const Parameters& params,
+                      double volumeElement) {
+  return std::sqrt(2 * reservoir.damping * reservoir.temperature *
+                   params.timeStep.real() / volumeElement);
+}
+
+// Noise of step n draws from the streams above n + 1 in the upper 32 bits,
+// leaving the lower streams to the initial state
+std::uint64_t stepStream(const Reservoir& reservoir, std::uint64_t step) {
+  return ((step + 1) << 32) + reservoir.stream;
+}
+
+void fourierStep(Wavefunction1D& wfn, const Parameters& params,
+                 const Reservoir& reservoir) {
+  dampedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                      params.timeStep, reservoir.damping);
+}
+
+void fourierStep(Wavefunction2D& wfn, const Parameters& params,
+                 const Reservoir& reservoir) {
+  dampedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                      params.timeStep, reservoir.damping);
+}
+
+void fourierStep(Wavefunction3D& wfn, const Parameters& params,
+                 const Reservoir& reservoir) {
+  dampedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                      params.timeStep, reservoir.damping);
+}
+
+void fourierStep(EnsembleWavefunction1D& wfn, const Parameters& params,
+                 const Reservoir& reservoir) {
+  dampedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                      params.timeStep, reservoir.damping,
+                      wfn.numRealisations());
+}
+
+void fourierStep(EnsembleWavefunction2D& wfn, const Parameters& params,
+                 const Reservoir& reservoir) {
+  dampedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                      params.timeStep, reservoir.damping,
+                      wfn.numRealisations());
+}
+
+void fourierStep(Wavefunction1D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, reservoir.damping, projector);
+}
+
+void fourierStep(Wavefunction2D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, reservoir.damping, projector);
+}
+
+void fourierStep(Wavefunction3D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, reservoir.damping, projector);
+}
+
+void fourierStep(EnsembleWavefunction1D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, reservoir.damping, projector,
+                         wfn.numRealisations());
+}
+
+void fourierStep(EnsembleWavefunction2D& wfn, const Parameters& params,
+                 const Reservoir& reservoir, const Projector& projector) {
+  projectedFourierKernel(wfn.fourierComponent(), wfn.grid().wavenumber(),
+                         params.timeStep, reservoir.damping, projector,
+                         wfn.numRealisations());
+}
+
+void interactionStep(Wavefunction1D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step) {
+  checkTrap(params.trap, wfn.component().size());
+  stochasticInteractionKernel(
+      wfn.component(), params.trap, params.intStrength,
+      reservoir.chemicalPotential, params.timeStep, reservoir.damping,
+      noiseAmplitude(reservoir, params, wfn.grid().gridSpacing()),
+      reservoir.seed, stepStream(reservoir, step));
+}
+
+void interactionStep(Wavefunction2D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step) {
+  checkTrap(params.trap, wfn.component().size());
+  auto [xGridSpacing, yGridSpacing] = wfn.grid().gridSpacing();
+  stochasticInteractionKernel(
+      wfn.component(), params.trap, params.intStrength,
+      reservoir.chemicalPotential, params.timeStep, reservoir.damping,
+      noiseAmplitude(reservoir, params, xGridSpacing * yGridSpacing),
+      reservoir.seed, stepStream(reservoir, step));
+}
+
+void interactionStep(Wavefunction3D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step) {
+  checkTrap(params.trap, wfn.component().size());
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  stochasticInteractionKernel(
+      wfn.component(), params.trap, params.intStrength,
+      reservoir.chemicalPotential, params.timeStep, reservoir.damping,
+      noiseAmplitude(reservoir, params,
+                     xGridSpacing * yGridSpacing * zGridSpacing),
+      reservoir.seed, stepStream(reservoir, step));
+}
+
+void interactionStep(EnsembleWavefunction1D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step) {
+  checkTrap(params.trap, wfn.grid().wavenumber().size());
+  stochasticInteractionKernel(
+      wfn.component(), params.trap, params.intStrength,
+      reservoir.chemicalPotential, params.timeStep, reservoir.damping,
+      noiseAmplitude(reservoir, params, wfn.grid().gridSpacing()),
+      reservoir.seed, stepStream(reservoir, step), wfn.numRealisations());
+}
+
+void interactionStep(EnsembleWavefunction2D& wfn, const Parameters& params,
+                     const Reservoir& reservoir, std::uint64_t step) {
+  checkTrap(params.trap, wfn.grid().wavenumber().size());
+  auto [xGridSpacing, yGridSpacing] = wfn.grid().gridSpacing();
+  stochasticInteractionKernel(
+      wfn.component(), params.trap, params.intStrength,
+      reservoir.chemicalPotential, params.timeStep, reservoir.damping,
+      noiseAmplitude(reservoir, params, xGridSpacing * yGridSpacing),
+      reservoir.seed, stepStream(reservoir, step), wfn.numRealisations());
+}
@@ -0,0 +1,374 @@
+#include "stream.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+template <typename T>
+void writeJsonArray(std::ostream& out, const std::vector<T>& values) {
+  out << '[';
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    out << (i == 0 ? "" : ", ") << values[i];
+  }
+  out << ']';
+}
+
+void writeRawSnapshotIndex(const std::string& filename,
+                           const RawSnapshotIndex& index) {
+  // Replace the index atomically, so it always describes complete snapshots
+  std::string temporary = filename + ".json.tmp";
+  {
+    std::ofstream out{temporary};
+    out << std::setprecision(17);
+    out << "{\n  \"dtype\": \"complex128\",\n  \"shape\": ";
+    writeJsonArray(out, index.shape);
+    out << ",\n  \"gridSpacing\": ";
+    writeJsonArray(out, index.gridSpacing);
+    out << ",\n  \"intStrength\": " << index.intStrength;
+    out << ",\n  \"numTimeSteps\": " << index.numTimeSteps;
+    out << ",\n  \"dt\": [" << index.timeStep.real() << ", "
+        << index.timeStep.imag() << ']';
+    out << ",\n  \"snapshotBytes\": " << index.snapshotBytes;
+    out << ",\n  \"stride\": " << index.stride;
+    out << ",\n  \"times\": ";
+    writeJsonArray(out, index.times);
+    out << ",\n  \"offsets\": ";
+    writeJsonArray(out, index.offsets);
+    out << "\n}\n";
+    if (!out) {
+      throw std::runtime_error("Failed to write raw snapshot index " +
+                               temporary);
+    }
+  }
+  std::filesystem::rename(temporary, filename + ".json");
+}
+
+// Parses the number or array of numbers stored under a key of the index
+std::vector<double> jsonValues(const std::string& text,
+                               const std::string& key) {
+  std::size_t position = text.find("\"" + key + "\":");
+  if (position == std::string::npos) {
+    throw std::runtime_error("Raw snapshot index has no " + key);
+  }
+  position += key.size() + 3;
+
+  std::size_t end{};
+  position = text.find_first_not_of(' ', position);
+  if (text[position] == '[') {
+    position += 1;
+    end = text.find(']', position);
+  } else {
+    end = text.find_first_of(",\n}", position);
+  }
+
+  std::vector<double> values{};
+  std::istringstream stream{text.substr(position, end - position)};
+  std::string value{};
+  while (std::getline(stream, value, ',')) {
+    if (value.find_first_not_of(' ') != std::string::npos) {
+      values.push_back(std::stod(value));
+    }
+  }
+
+  return values;
+}
+
+RawSnapshotIndex readRawSnapshotIndex(const std::string& filename) {
+  std::ifstream in{filename + ".json"};
+  if (!in) {
+    throw std::runtime_error("Failed to open raw snapshot index " + filename +
+                             ".json");
+  }
+  std::stringstream buffer{};
+  buffer << in.rdbuf();
+  std::string text = buffer.str();
+
+  RawSnapshotIndex index{};
+  for (auto value : jsonValues(text, "shape")) {
+    index.shape.push_back(static_cast<std::size_t>(value));
+  }
+  index.gridSpacing = jsonValues(text, "gridSpacing");
+  index.intStrength = jsonValues(text, "intStrength").at(0);
+  index.numTimeSteps = static_cast<int>(jsonValues(text, "numTimeSteps").at(0));
+  std::vector<double> timeStep = jsonValues(text, "dt");
+  index.timeStep = {timeStep.at(0), timeStep.at(1)};
+  index.snapshotBytes =
+      static_cast<std::size_t>(jsonValues(text, "snapshotBytes").at(0));
+  index.stride = static_cast<std::size_t>(jsonValues(text, "stride").at(0));
+  index.times = jsonValues(text, "times");
+  for (auto value : jsonValues(text, "offsets")) {
+    index.offsets.push_back(static_cast<std::size_t>(value));
+  }
+
+  return index;
+}
+
+RawSnapshotFile::RawSnapshotFile(std::string filename, RawSnapshotIndex index,
+                                 std::size_t capacity)
+    : m_filename{std::move(filename)}, m_index{std::move(index)} {
+  // Page-aligned snapshots, so each one maps to whole pages of the file
+  auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  std::size_t numElements = 1;
+  for (auto points : m_index.shape) {
+    numElements *= points;
+  }
+  m_index.snapshotBytes = numElements * sizeof(std::complex<double>);
+  m_index.stride = (m_index.snapshotBytes + pageSize - 1) / pageSize * pageSize;
+  m_index.times.clear();
+  m_index.offsets.clear();
+
+  m_file = open(m_filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_file < 0) {
+    throw std::runtime_error("Failed to create raw snapshot file " +
+                             m_filename);
+  }
+  try {
+    reserve(std::max<std::size_t>(capacity, 1));
+    writeRawSnapshotIndex(m_filename, m_index);
+  } catch (...) {
+    unmap();
+    close(m_file);
+    throw;
+  }
+}
+
+RawSnapshotFile::~RawSnapshotFile() {
+  try {
+    writeRawSnapshotIndex(m_filename, m_index);
+  } catch (const std::exception&) {
+    // The index of the last flush is left in place
+  }
+  unmap();
+  if (ftruncate(m_file, static_cast<off_t>(size() * m_index.stride)) != 0) {
+    // On failure the file keeps its preallocated size, which the index still
+    // describes correctly
+  }
+  close(m_file);
+}
+
+void RawSnapshotFile::unmap() {
+  if (m_map != nullptr) {
+    munmap(m_map, m_capacity * m_index.stride);
+    m_map = nullptr;
+  }
+}
+
+void RawSnapshotFile::reserve(std::size_t capacity) {
+  if (capacity <= m_capacity) {
+    return;
+  }
+
+  capacity = std::max(capacity, 2 * m_capacity);
+  std::size_t bytes = capacity * m_index.stride;
+  unmap();
+
+  // Allocate the blocks up front, so appends never extend the file
+  if (posix_fallocate(m_file, 0, static_cast<off_t>(bytes)) != 0) {
+    throw std::runtime_error("Failed to preallocate raw snapshot file " +
+                             m_filename);
+  }
+  void* map =
+      mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+  if (map == MAP_FAILED) {
+    throw std::runtime_error("Failed to map raw snapshot file " + m_filename);
+  }
+  m_map = static_cast<unsigned char*>(map);
+  m_capacity = capacity;
+}
+
+void RawSnapshotFile::append(const complexVector_t& snapshot, double time) {
+  if (snapshot.size() * sizeof(std::complex<double>) !=
+      m_index.snapshotBytes) {
+    throw std::invalid_argument(
+        "Snapshot does not match the shape of the raw snapshot file");
+  }
+  reserve(size() + 1);
+  std::size_t offset = size() * m_index.stride;
+
+  // Copy in blocks across threads, which also spreads the page faults of the
+  // fresh mapping
+  const auto* source = reinterpret_cast<const unsigned char*>(snapshot.data());
+  unsigned char* destination = m_map + offset;
+  auto bytes = static_cast<std::int64_t>(m_index.snapshotBytes);
+  std::int64_t blockBytes = 1 << 20;
+  std::int64_t numBlocks = (bytes + blockBytes - 1) / blockBytes;
+
+#pragma omp parallel for shared(source, destination, bytes, blockBytes, \
+                                    numBlocks) default(none)
+  for (std::int64_t block = 0; block < numBlocks; ++block) {
+    std::int64_t begin = block * blockBytes;
+    std::memcpy(destination + begin, source + begin,
+                std::min(blockBytes, bytes - begin));
+  }
+
+  m_index.offsets.push_back(offset);
+  m_index.times.push_back(time);
+}
+
+void RawSnapshotFile::flush() {
+  if (msync(m_map, size() * m_index.stride, MS_SYNC) != 0) {
+    throw std::runtime_error("Failed to write raw snapshot file " +
+                             m_filename);
+  }
+  writeRawSnapshotIndex(m_filename, m_index);
+}
+
+std::size_t RawSnapshotFile::size() const { return m_index.offsets.size(); }
+
+RawSnapshotIndex rawSnapshotIndex(const Parameters& params,
+                                  std::vector<std::size_t> shape,
+                                  std::vector<double> gridSpacing) {
+  RawSnapshotIndex index{};
+  index.shape = std::move(shape);
+  index.gridSpacing = std::move(gridSpacing);
+  index.intStrength = params.intStrength;
+  index.numTimeSteps = params.numTimeSteps;
+  index.timeStep = params.timeStep;
+
+  return index;
+}
+
+RawSnapshotIndex rawSnapshotIndex(const Parameters& params,
+                                  const Grid1D& grid) {
+  return rawSnapshotIndex(params, {grid.shape()}, {grid.gridSpacing()});
+}
+
+RawSnapshotIndex rawSnapshotIndex(const Parameters& params,
+                                  const Grid2D& grid) {
+  auto [xPoints, yPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing] = grid.gridSpacing();
+  return rawSnapshotIndex(params, {xPoints, yPoints},
+                          {xGridSpacing, yGridSpacing});
+}
+
+RawSnapshotIndex rawSnapshotIndex(const Parameters& params,
+                                  const Grid3D& grid) {
+  auto [xPoints, yPoints, zPoints] = grid.shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = grid.gridSpacing();
+  return rawSnapshotIndex(params, {xPoints, yPoints, zPoints},
+                          {xGridSpacing, yGridSpacing, zGridSpacing});
+}
+
+RawDataManager1D::RawDataManager1D(const std::string& filename,
+                                   const Parameters& params,
+                                   const Grid1D& grid,
+                                   const DataOptions& options)
+    : m_file{filename, rawSnapshotIndex(params, grid),
+             snapshotCapacity(params, options)} {}
+
+void RawDataManager1D::saveWavefunctionData(Wavefunction1D& wfn,
+                                            double time) {
+  // FFT so we update real-space arrays
+  wfn.ifft();
+
+  m_file.append(wfn.component(), time);
+}
+
+void RawDataManager1D::flush() { m_file.flush(); }
+
+std::size_t RawDataManager1D::numSnapshots() const { return m_file.size(); }
+
+RawDataManager2D::RawDataManager2D(const std::string& filename,
+                                   const Parameters& params,
+                                   const Grid2D& grid,
+                                   const DataOptions& options)
+    : m_file{filename, rawSnapshotIndex(params, grid),
+             snapshotCapacity(params, options)} {}
+
+void RawDataManager2D::saveWavefunctionData(Wavefunction2D& wfn,
+                                            double time) {
+  m_file.append(wfn.component(), time);
+}
+
+void RawDataManager2D::flush() { m_file.flush(); }
+
+std::size_t RawDataManager2D::numSnapshots() const { return m_file.size(); }
+
+RawDataManager3D::RawDataManager3D(const std::string& filename,
+                                   const Parameters& params,
+                                   const Grid3D& grid,
+                                   const DataOptions& options)
+    : m_file{filename, rawSnapshotIndex(params, grid),
+             snapshotCapacity(params, options)} {}
+
+void RawDataManager3D::saveWavefunctionData(Wavefunction3D& wfn,
+                                            double time) {
+  // FFT so we update real-space arrays
+  wfn.ifft();
+
+  m_file.append(wfn.component(), time);
+}
+
+void RawDataManager3D::flush() { m_file.flush(); }
+
+std::size_t RawDataManager3D::numSnapshots() const { return m_file.size(); }
+
+void convertRawToHDF5(const std::string& rawFilename,
+                      const std::string& filename,
+                      const DataOptions& options) {
+  RawSnapshotIndex index = readRawSnapshotIndex(rawFilename);
+  std::ifstream in{rawFilename, std::ios::binary};
+  if (!in) {
+    throw std::runtime_error("Failed to open raw snapshot file " +
+                             rawFilename);
+  }
+
+  HighFive::File file{filename, HighFive::File::ReadWrite |
+                                    HighFive::File::Create |
+                                    HighFive::File::Truncate};
+
+  // Raw snapshots are saved on the full position space grid, and are stored
+  // as such whatever the output options of the run
+  DataOptions convertOptions = options;
+  convertOptions.resumeSnapshots.reset();
+  convertOptions.downsampling = 1;
+  convertOptions.fourierOutput = false;
+
+  // Save the parameters and grid as the DataManager classes do, including
+  // the options DataReader needs, e.g. to decode delta-encoded snapshots
+  file.createDataSet("/parameters/intStrength", index.intStrength);
+  file.createDataSet("/parameters/numTimeSteps", index.numTimeSteps);
+  file.createDataSet("/parameters/dt", index.timeStep);
+  saveOutputParameters(file, convertOptions);
+
+  const std::string axes[] = {"x", "y", "z"};
+  for (std::size_t axis = 0; axis < index.shape.size(); ++axis) {
+    file.createDataSet("/grid/" + axes[axis] + "Points",
+                       static_cast<unsigned int>(index.shape[axis]));
+    file.createDataSet("/grid/" + axes[axis] + "GridSpacing",
+                       index.gridSpacing[axis]);
+  }
+
+  SnapshotFields snapshots{
+      file, index.shape, std::max<std::size_t>(index.offsets.size(), 1),
+      convertOptions};
+  complexVector_t snapshot(index.snapshotBytes / sizeof(std::complex<double>));
+  for (auto offset : index.offsets) {
+    in.seekg(static_cast<std::streamoff>(offset));
+    in.read(reinterpret_cast<char*>(snapshot.data()),
+            static_cast<std::streamsize>(index.snapshotBytes));
+    if (!in) {
+      throw std::runtime_error("Raw snapshot file " + rawFilename +
+                               " is shorter than its index");
+    }
+    snapshots.append(snapshot);
+  }
+
+  // Raw runs need not save at a fixed interval, so keep the time of each
+  // snapshot as the DataManager classes do for timed snapshots
+  TimeSeriesOutputs timeSeries{file, convertOptions};
+  for (double time : index.times) {
+    if (timeSeries.record("snapshotTime", &time, 1, true)) {
+      timeSeries.write();
+    }
+  }
+  timeSeries.write();
+}
@@ -0,0 +1,29 @@
+#include "trigger.h"
+
+ThresholdTrigger::ThresholdTrigger(double threshold, Crossing direction)
+    : m_threshold{threshold}, m_direction{direction} {}
+
+bool ThresholdTrigger::update(double value) {
+  bool above = value >= m_threshold;
+  bool crossed = m_above && *m_above != above;
+  m_above = above;
+  if (!crossed) {
+    return false;
+  }
+
+  switch (m_direction) {
+    case Crossing::rising:
+      return above;
+    case Crossing::falling:
+      return !above;
+    default:
+      return true;
+  }
+}
+
+bool ChangeTrigger::update(long value) {
+  bool changed = m_last && *m_last != value;
+  m_last = value;
+
+  return changed;
+}
@@ -0,0 +1,256 @@
+#include "vortex.h"
+#include "noise.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Number of vortices whose tables of image terms are held at once
+constexpr std::size_t vortexBlockSize = 64;
+
+// Number of periodic images of a vortex summed on either side along y
+constexpr int numImages = 5;
+
+// Cells of one axis of the spatial hash neighbouring a cell, wrapped
+// periodically and without repeats
+std::vector<long> neighbourCells(long cell, long numCells) {
+  if (numCells < 3) {
+    std::vector<long> cells(numCells);
+    for (long i = 0; i < numCells; ++i) {
+      cells[i] = i;
+    }
+    return cells;
+  }
+
+  return {(cell + numCells - 1) % numCells, cell, (cell + 1) % numCells};
+}
+
+// Squared distance between two points, across the periodic boundaries
+double periodicDistanceSquared(const Vortex& first, const Vortex& second,
+                               double xLength, double yLength) {
+  double dx = std::abs(first.x - second.x);
+  double dy = std::abs(first.y - second.y);
+  dx = std::min(dx, xLength - dx);
+  dy = std::min(dy, yLength - dy);
+
+  return dx * dx + dy * dy;
+}
+
+std::vector<Vortex> sampleVortices(double xLength, double yLength,
+                                   unsigned int numVortices,
+                                   double minSeparation, std::uint64_t seed,
+                                   unsigned int maxAttempts) {
+  if (numVortices % 2 != 0) {
+    throw std::invalid_argument("The number of vortices must be even");
+  }
+
+  // Cells are at least minSeparation wide, so only neighbouring cells can
+  // hold vortices that are too close, and are capped in number to keep the
+  // hash small when the separation is tiny
+  double maxCells = std::ceil(std::sqrt(numVortices)) + 1;
+  auto cellsAlong = [&](double length) {
+    double cells =
+        minSeparation > 0 ? std::floor(length / minSeparation) : maxCells;
+    return static_cast<long>(std::clamp(cells, 1.0, maxCells));
+  };
+  long xCells = cellsAlong(xLength);
+  long yCells = cellsAlong(yLength);
+  std::vector<std::vector<std::size_t>> cells(xCells * yCells);
+
+  std::vector<Vortex> vortices;
+  vortices.reserve(numVortices);
+  double minSeparationSquared = minSeparation * minSeparation;
+  for (std::uint64_t attempt = 0; vortices.size() < numVortices; ++attempt) {
+    if (attempt == maxAttempts) {
+      throw std::runtime_error(
+          "Could not place all vortices at the requested separation");
+    }
+    double x = xLength * uniformReal(seed, 0, 2 * attempt);
+    double y = yLength * uniformReal(seed, 0, 2 * attempt + 1);
+    Vortex candidate{x - 0.5 * xLength, y - 0.5 * yLength,
+                     vortices.size() % 2 == 0 ? 1 : -1};
+
+    long xCell = std::min(static_cast<long>(x / xLength * xCells), xCells - 1);
+    long yCell = std::min(static_cast<long>(y / yLength * yCells), yCells - 1);
+    bool accepted = true;
+    for (long i : neighbourCells(xCell, xCells)) {
+      for (long j : neighbourCells(yCell, yCells)) {
+        for (std::size_t index : cells[j + i * yCells]) {
+          if (periodicDistanceSquared(candidate, vortices[index], xLength,
+                                      yLength) < minSeparationSquared) {
+            accepted = false;
+          }
+        }
+      }
+    }
+
+    if (accepted) {
+      cells[yCell + xCell * yCells].push_back(vortices.size());
+      vortices.push_back(candidate);
+    }
+  }
+
+  return vortices;
+}
+
+std::vector<Vortex> randomVortices(Grid2D& grid, unsigned int numVortices,
+                                   double minSeparation, std::uint64_t seed,
+                                   unsigned int maxAttempts) {
+  auto [xLength, yLength] = grid.gridLength();
+  return sampleVortices(xLength, yLength, numVortices, minSeparation, seed,
+                        maxAttempts);
+}
+
+std::vector<Vortex> randomVortices(Grid3D& grid, unsigned int numVortices,
+                                   double minSeparation, std::uint64_t seed,
+                                   unsigned int maxAttempts) {
+  auto [xLength, yLength, zLength] = grid.gridLength();
+  return sampleVortices(xLength, yLength, numVortices, minSeparation, seed,
+                        maxAttempts);
+}
+
+// Multiplies the periodic phase of the vortices into a vector laid out as
+// rows along y, each point of which is repeated numRepeats times
+// contiguously, i.e. once for a 2D grid and once per z point for a 3D grid.
+//
+// In coordinates X, Y scaled to [0, 2 pi) across the box, the phase of a
+// vortex of charge q and its images is
+// -q (sum_k atan(tanh((Y + 2 pi k) / 2) tan((X - pi) / 2)) - pi H(X)),
+// and a term linear in Y, summed over all vortices, makes the total periodic.
+void imprintPlanarVortices(complexVector_t& component, unsigned int xPoints,
+                           unsigned int yPoints, double xGridSpacing,
+                           double yGridSpacing,
+                           const std::vector<Vortex>& vortices,
+                           unsigned int numRepeats) {
+  int totalCharge = 0;
+  for (const auto& vortex : vortices) {
+    totalCharge += vortex.charge;
+  }
+  if (totalCharge != 0) {
+    throw std::invalid_argument(
+        "The total charge of vortices in a periodic box must vanish");
+  }
+
+  double twoPi = 2 * PI;
+  std::vector<double> xScaled(vortices.size());
+  std::vector<double> yScaled(vortices.size());
+  std::vector<double> charge(vortices.size());
+  double slope = 0.0;
+  for (std::size_t v = 0; v < vortices.size(); ++v) {
+    xScaled[v] = twoPi * (vortices[v].x / (xPoints * xGridSpacing) + 0.5);
+    yScaled[v] = twoPi * (vortices[v].y / (yPoints * yGridSpacing) + 0.5);
+    // The image sum winds clockwise, hence the sign
+    charge[v] = -vortices[v].charge;
+    slope += charge[v] * xScaled[v] / twoPi;
+  }
+
+  long numRows = xPoints;
+  long rowLength = yPoints;
+  long repeats = numRepeats;
+  long images = 2 * numImages + 1;
+  long centreImage = numImages;
+  for (std::size_t first = 0; first < vortices.size();
+       first += vortexBlockSize) {
+    long offset = static_cast<long>(first);
+    long blockSize = static_cast<long>(
+        std::min(vortexBlockSize, vortices.size() - first));
+    bool addSlope = first == 0;
+
+    // The factors tanh((Y + 2 pi k) / 2) only depend on the column, so are
+    // shared by all rows
+    std::vector<double> tanhTable(blockSize * rowLength * images);
+#pragma omp parallel for collapse(2) shared(tanhTable, yScaled, twoPi, \
+    offset, blockSize, rowLength, images, centreImage) default(none)
+    for (long v = 0; v < blockSize; ++v) {
+      for (long j = 0; j < rowLength; ++j) {
+        double y = twoPi * j / rowLength - yScaled[offset + v];
+        for (long k = 0; k < images; ++k) {
+          tanhTable[k + images * (j + rowLength * v)] =
+              std::tanh(0.5 * (y + twoPi * (k - centreImage)));
+        }
+      }
+    }
+
+#pragma omp parallel for shared(component, tanhTable, xScaled, charge, \
+    slope, twoPi, offset, blockSize, addSlope, numRows, rowLength, repeats, \
+    images) default(none)
+    for (long i = 0; i < numRows; ++i) {
+      std::vector<double> phase(rowLength, 0.0);
+      if (addSlope) {
+        for (long j = 0; j < rowLength; ++j) {
+          phase[j] = slope * twoPi * j / rowLength;
+        }
+      }
+
+      for (long v = 0; v < blockSize; ++v) {
+        // Terms depending only on the row and the vortex
+        double x = twoPi * i / numRows - xScaled[offset + v];
+        double tangent = std::tan(0.5 * (x - PI));
+        double branch = x >= 0 ? PI : 0.0;
+        double vortexCharge = charge[offset + v];
+        const double* table = &tanhTable[images * rowLength * v];
+
+        for (long j = 0; j < rowLength; ++j) {
+          double sum = 0.0;
+          for (long k = 0; k < images; ++k) {
+            sum += std::atan(table[k + images * j] * tangent);
+          }
+          phase[j] += vortexCharge * (sum - branch);
+        }
+      }
+
+      for (long j = 0; j < rowLength; ++j) {
+        std::complex<double> factor = std::polar(1.0, phase[j]);
+        for (long r = 0; r < repeats; ++r) {
+          component[r + repeats * (j + rowLength * i)] *= factor;
+        }
+      }
+    }
+  }
+}
+
+void imprintVortices(Wavefunction2D& wfn, const std::vector<Vortex>& vortices) {
+  auto [xPoints, yPoints] = wfn.grid().shape();
+  auto [xGridSpacing, yGridSpacing] = wfn.grid().gridSpacing();
+  imprintPlanarVortices(wfn.component(), xPoints, yPoints, xGridSpacing,
+                        yGridSpacing, vortices, 1);
+  wfn.fft();
+}
+
+void imprintVortices(Wavefunction3D& wfn, const std::vector<Vortex>& vortices) {
+  auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
+  auto [xGridSpacing, yGridSpacing, zGridSpacing] = wfn.grid().gridSpacing();
+  imprintPlanarVortices(wfn.component(), xPoints, yPoints, xGridSpacing,
+                        yGridSpacing, vortices, zPoints);
+  wfn.fft();
+}
+
+void imprintVortexRings(Wavefunction3D& wfn,
+                        const std::vector<VortexRing>& rings) {
+  auto [xPoints, yPoints, zPoints] = wfn.grid().shape();
+  long numRows = static_cast<long>(xPoints) * yPoints;
+  long rowLength = zPoints;
+  auto& component = wfn.component();
+  const auto& xMesh = wfn.grid().xMesh();
+  const auto& yMesh = wfn.grid().yMesh();
+  const auto& zMesh = wfn.grid().zMesh();
+#pragma omp parallel for shared(component, rings, xMesh, yMesh, zMesh, \
+    numRows, rowLength) default(none)
+  for (long row = 0; row < numRows; ++row) {
+    std::vector<double> phase(rowLength, 0.0);
+    for (const auto& ring : rings) {
+      // Distance from the axis of the ring, shared by the whole row along z
+      double rho = std::hypot(xMesh[row * rowLength] - ring.x,
+                              yMesh[row * rowLength] - ring.y);
+      for (long k = 0; k < rowLength; ++k) {
+        double z = zMesh[k] - ring.z;
+        phase[k] += ring.charge * (std::atan2(z, rho - ring.radius) -
+                                   std::atan2(z, rho + ring.radius));
+      }
+    }
+
+    for (long k = 0; k < rowLength; ++k) {
+      component[k + row * rowLength] *= std::polar(1.0, phase[k]);
+    }
+  }
+  wfn.fft();
+}
@@ -73,6 +73,10 @@ void Wavefunction1D::setComponent(complexVector_t& component) {
   updateAtomNumber();
 }
 
+void Wavefunction1D::setAtomNumber(double atomNumber) {
+  m_atomNumber = atomNumber;
+}
+
 Wavefunction2D::Wavefunction2D(Grid2D& grid) : m_grid{grid} {
   auto [xPoints, yPoints] = grid.shape();
   m_component.resize(xPoints * yPoints);
@@ -163,6 +167,10 @@ void Wavefunction2D::setComponent(complexVector_t& component) {
   updateAtomNumber();
 }
 
+void Wavefunction2D::setAtomNumber(double atomNumber) {
+  m_atomNumber = atomNumber;
+}
+
 Wavefunction3D::Wavefunction3D(Grid3D& grid) : m_grid{grid} {
   auto [xPoints, yPoints, zPoints] = grid.shape();
   m_component.resize(xPoints * yPoints * zPoints);
@@ -263,3 +271,7 @@ void Wavefunction3D::setComponent(complexVector_t& component) {
   fft();
   updateAtomNumber();
 }
+
+void Wavefunction3D::setAtomNumber(double atomNumber) {
+  m_atomNumber = atomNumber;
+}
@@ -0,0 +1,13 @@
+#include <gtest/gtest.h>
+#include <mpi.h>
+
+// Shared main of the MPI tests, which run on every rank
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+    MPI_Finalize();
+
+    return result;
+}
@@ -0,0 +1,128 @@
+#include "accumulator.h"
+#include <gtest/gtest.h>
+#include <numeric>
+
+constexpr auto X_POINTS = 16;
+constexpr auto Y_POINTS = 8;
+constexpr auto GRID_SPACING = 0.5;
+constexpr auto NUM_SAMPLES = 5;
+
+complexVector_t sampleState(int sample)
+{
+    complexVector_t state(X_POINTS * Y_POINTS);
+    for (int i = 0; i < state.size(); ++i)
+    {
+        state[i] = std::polar(1.0 + 0.1 * sample * std::sin(0.3 * i),
+                              0.2 * sample * i);
+    }
+
+    return state;
+}
+
+TEST(FieldAccumulatorTest, TestWelfordMatchesDirectAverages)
+{
+    Grid2D grid{{X_POINTS, Y_POINTS}, {GRID_SPACING, GRID_SPACING}};
+    Wavefunction2D wfn{grid};
+    FieldAccumulator accumulator{grid, {AccumulatedField::density}};
+
+    std::vector<double> sum(X_POINTS * Y_POINTS, 0.0);
+    std::vector<double> sumSquares(X_POINTS * Y_POINTS, 0.0);
+    for (int sample = 0; sample < NUM_SAMPLES; ++sample)
+    {
+        complexVector_t state = sampleState(sample);
+        wfn.setComponent(state);
+        accumulator.accumulate(wfn);
+
+        for (int i = 0; i < state.size(); ++i)
+        {
+            sum[i] += std::norm(state[i]);
+            sumSquares[i] += std::pow(std::norm(state[i]), 2);
+        }
+    }
+
+    ASSERT_EQ(accumulator.count(), NUM_SAMPLES);
+    const std::vector<double>& mean =
+            accumulator.mean(AccumulatedField::density);
+    std::vector<double> variance =
+            accumulator.variance(AccumulatedField::density);
+    for (int i = 0; i < sum.size(); ++i)
+    {
+        double expectedMean = sum[i] / NUM_SAMPLES;
+        ASSERT_NEAR(mean[i], expectedMean, 1e-12);
+        ASSERT_NEAR(variance[i],
+                    sumSquares[i] / NUM_SAMPLES - expectedMean * expectedMean,
+                    1e-12);
+    }
+}
+
+TEST(FieldAccumulatorTest, TestMomentumDensitySumsToAtomNumber)
+{
+    Grid2D grid{{X_POINTS, Y_POINTS}, {GRID_SPACING, GRID_SPACING}};
+    Wavefunction2D wfn{grid};
+    FieldAccumulator accumulator{grid, {AccumulatedField::momentumDensity},
+                                 false};
+
+    complexVector_t state = sampleState(3);
+    wfn.setComponent(state);
+    accumulator.accumulate(wfn);
+
+    double atomNumber = 0;
+    for (const auto& value : state)
+    {
+        atomNumber += std::norm(value) * GRID_SPACING * GRID_SPACING;
+    }
+    const std::vector<double>& mean =
+            accumulator.mean(AccumulatedField::momentumDensity);
+    ASSERT_NEAR(std::accumulate(mean.begin(), mean.end(), 0.0), atomNumber,
+                1e-10);
+    ASSERT_THROW(static_cast<void>(accumulator.variance(
+                         AccumulatedField::momentumDensity)),
+                 std::logic_error);
+    ASSERT_THROW(static_cast<void>(
+                         accumulator.mean(AccumulatedField::density)),
+                 std::invalid_argument);
+}
+
+TEST(FieldAccumulatorTest, TestMomentumDensityCentred)
+{
+    Grid2D grid{{X_POINTS, Y_POINTS}, {GRID_SPACING, GRID_SPACING}};
+    Wavefunction2D wfn{grid};
+    FieldAccumulator accumulator{grid, {AccumulatedField::momentumDensity},
+                                 false};
+
+    // A uniform state only holds the zero momentum mode
+    complexVector_t state(X_POINTS * Y_POINTS, {1.0, 0.0});
+    wfn.setComponent(state);
+    accumulator.accumulate(wfn);
+
+    const std::vector<double>& mean =
+            accumulator.mean(AccumulatedField::momentumDensity);
+    int centre = (X_POINTS / 2) * Y_POINTS + Y_POINTS / 2;
+    ASSERT_NEAR(mean[centre],
+                X_POINTS * Y_POINTS * GRID_SPACING * GRID_SPACING, 1e-10);
+    for (int i = 0; i < mean.size(); ++i)
+    {
+        if (i != centre)
+        {
+            ASSERT_NEAR(mean[i], 0.0, 1e-10);
+        }
+    }
+}
+
+TEST(FieldAccumulatorTest, TestResetDiscardsSamples)
+{
+    Grid1D grid{X_POINTS, GRID_SPACING};
+    Wavefunction1D wfn{grid};
+    FieldAccumulator accumulator{grid, {AccumulatedField::density}};
+
+    complexVector_t state(X_POINTS, {2.0, 0.0});
+    wfn.setComponent(state);
+    accumulator.accumulate(wfn);
+    accumulator.reset();
+
+    ASSERT_EQ(accumulator.count(), 0);
+    for (const auto& value : accumulator.mean(AccumulatedField::density))
+    {
+        ASSERT_EQ(value, 0.0);
+    }
+}
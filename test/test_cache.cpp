@@ -0,0 +1,92 @@
+#include "cache.h"
+#include <filesystem>
+#include <gtest/gtest.h>
+
+constexpr auto GRID_LENGTH = 16;
+constexpr auto GRID_SPACING = 0.5;
+constexpr auto ATOM_NUMBER = 100.0;
+
+class GroundStateCacheTest : public ::testing::Test
+{
+public:
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    Parameters params = harmonicParameters();
+    GroundStateCache cache{emptyDirectory("test_ground_state_cache")};
+
+    static std::string emptyDirectory(const std::string& directory)
+    {
+        std::filesystem::remove_all(directory);
+        return directory;
+    }
+
+    Parameters harmonicParameters()
+    {
+        Parameters params{};
+        params.intStrength = 1.0;
+        params.trap.resize(GRID_LENGTH * GRID_LENGTH);
+        for (int i = 0; i < params.trap.size(); ++i)
+        {
+            params.trap[i] = 0.5 * (std::pow(grid.xMesh()[i], 2) +
+                                    std::pow(grid.yMesh()[i], 2));
+        }
+        return params;
+    }
+};
+
+TEST_F(GroundStateCacheTest, ThomasFermiStateNormalised)
+{
+    complexVector_t state = thomasFermiState(params.trap, params.intStrength,
+                                             ATOM_NUMBER,
+                                             GRID_SPACING * GRID_SPACING);
+
+    double atomNumber{};
+    for (const auto& value : state)
+    {
+        atomNumber += std::norm(value) * GRID_SPACING * GRID_SPACING;
+    }
+    ASSERT_NEAR(atomNumber, ATOM_NUMBER, 1e-9);
+}
+
+TEST_F(GroundStateCacheTest, StoredStateLoaded)
+{
+    GroundStateKey key = makeGroundStateKey(grid, params, ATOM_NUMBER, 1e-8);
+    complexVector_t state(GRID_LENGTH * GRID_LENGTH, {1.0, 2.0});
+    cache.store(key, state);
+
+    ASSERT_TRUE(cache.contains(key));
+    ASSERT_EQ(*cache.load(key), state);
+}
+
+TEST_F(GroundStateCacheTest, DifferentParametersHaveDifferentKeys)
+{
+    GroundStateKey key = makeGroundStateKey(grid, params, ATOM_NUMBER, 1e-8);
+    params.intStrength = 2.0;
+    GroundStateKey otherKey =
+            makeGroundStateKey(grid, params, ATOM_NUMBER, 1e-8);
+
+    ASSERT_NE(key.hash(), otherKey.hash());
+    ASSERT_TRUE(key.sameSystem(otherKey));
+}
+
+TEST_F(GroundStateCacheTest, WarmStartUsesNearbyState)
+{
+    GroundStateKey key = makeGroundStateKey(grid, params, ATOM_NUMBER, 1e-8);
+    complexVector_t state(GRID_LENGTH * GRID_LENGTH, {1.0, 0.0});
+    cache.store(key, state);
+
+    params.intStrength = 1.01;
+    GroundStateKey nearbyKey =
+            makeGroundStateKey(grid, params, ATOM_NUMBER, 1e-8);
+    complexVector_t warmStart = cache.warmStart(nearbyKey, params.trap,
+                                                GRID_SPACING * GRID_SPACING);
+
+    // Uniform cached state rescaled to the atom number
+    double expected = std::sqrt(ATOM_NUMBER / (GRID_LENGTH * GRID_LENGTH *
+                                               GRID_SPACING * GRID_SPACING));
+    for (const auto& value : warmStart)
+    {
+        ASSERT_NEAR(value.real(), expected, 1e-12);
+    }
+}
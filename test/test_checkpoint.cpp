@@ -0,0 +1,252 @@
+#include "checkpoint.h"
+#include "evolution.h"
+#include <gtest/gtest.h>
+
+constexpr auto GRID_LENGTH = 16;
+constexpr auto GRID_SPACING = 0.5;
+
+class CheckpointTest : public ::testing::Test
+{
+public:
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    Parameters params = parameters();
+
+    static Parameters parameters()
+    {
+        Parameters params{};
+        params.intStrength = 2.0;
+        params.trap.resize(GRID_LENGTH * GRID_LENGTH, 0.5);
+        params.numTimeSteps = 10;
+        params.timeStep = std::complex<double>{1e-2, 0};
+        params.currentTime = 0.37;
+        return params;
+    }
+
+    static complexVector_t state(double value)
+    {
+        complexVector_t state(GRID_LENGTH * GRID_LENGTH);
+        for (int i = 0; i < state.size(); ++i)
+        {
+            state[i] = {value, 0.01 * i};
+        }
+        return state;
+    }
+};
+
+TEST_F(CheckpointTest, TestStateRestored)
+{
+    Wavefunction2D wfn{grid};
+    complexVector_t initialState = state(1.0);
+    wfn.setComponent(initialState);
+
+    CheckpointState checkpoint{};
+    checkpoint.step = 5;
+    checkpoint.fourierSpace = true;
+    checkpoint.numSnapshots = 3;
+    checkpoint.rngState = {1, 2, 3, 4};
+    checkpoint.numRecords = {{"/timeseries/atomNumber", 7},
+                             {"/regions/core", 2}};
+    writeCheckpoint("2D_checkpoint.h5", wfn, params, checkpoint);
+
+    Wavefunction2D restoredWfn{grid};
+    Parameters restoredParams{};
+    CheckpointState restored =
+            readCheckpoint("2D_checkpoint.h5", restoredWfn, restoredParams);
+
+    ASSERT_EQ(restored.step, checkpoint.step);
+    ASSERT_TRUE(restored.fourierSpace);
+    ASSERT_EQ(restored.numSnapshots, checkpoint.numSnapshots);
+    ASSERT_EQ(restored.rngState, checkpoint.rngState);
+    ASSERT_EQ(restored.numRecords, checkpoint.numRecords);
+    ASSERT_EQ(restoredParams.intStrength, params.intStrength);
+    ASSERT_EQ(restoredParams.trap, params.trap);
+    ASSERT_EQ(restoredParams.timeStep, params.timeStep);
+    ASSERT_EQ(restoredParams.currentTime, params.currentTime);
+    ASSERT_EQ(restoredWfn.fourierComponent(), wfn.fourierComponent());
+    ASSERT_EQ(restoredWfn.atomNumber(), wfn.atomNumber());
+    for (int i = 0; i < GRID_LENGTH * GRID_LENGTH; ++i)
+    {
+        ASSERT_NEAR(std::abs(restoredWfn.component()[i] - initialState[i]), 0,
+                    1e-9);
+    }
+}
+
+TEST_F(CheckpointTest, TestResumedStateRenormalises)
+{
+    Wavefunction2D wfn{grid};
+    complexVector_t initialState = state(1.0);
+    wfn.setComponent(initialState);
+
+    CheckpointState checkpoint{};
+    checkpoint.fourierSpace = false;
+    writeCheckpoint("2D_renormalise_checkpoint.h5", wfn, params, checkpoint);
+
+    Wavefunction2D restoredWfn{grid};
+    Parameters restoredParams{};
+    static_cast<void>(readCheckpoint("2D_renormalise_checkpoint.h5",
+                                     restoredWfn, restoredParams));
+    ASSERT_EQ(restoredWfn.atomNumber(), wfn.atomNumber());
+    for (int i = 0; i < GRID_LENGTH * GRID_LENGTH; ++i)
+    {
+        ASSERT_NEAR(std::abs(restoredWfn.fourierComponent()[i] -
+                             wfn.fourierComponent()[i]),
+                    0, 1e-9);
+    }
+
+    // The state is already normalised, so renormalising leaves it unchanged
+    renormaliseAtomNum(restoredWfn);
+    renormaliseAtomNum(wfn);
+    for (int i = 0; i < GRID_LENGTH * GRID_LENGTH; ++i)
+    {
+        ASSERT_NEAR(std::abs(restoredWfn.component()[i] - wfn.component()[i]),
+                    0, 1e-9);
+    }
+    ASSERT_GT(calculateAtomNum(restoredWfn), 0);
+}
+
+TEST_F(CheckpointTest, TestTriggeredBySignal)
+{
+    CheckpointTrigger trigger{std::chrono::hours(1)};
+    ASSERT_FALSE(trigger.due());
+
+    std::raise(SIGUSR1);
+    ASSERT_TRUE(trigger.due());
+    ASSERT_FALSE(trigger.due());
+    ASSERT_FALSE(trigger.stopRequested());
+
+    std::raise(SIGTERM);
+    ASSERT_TRUE(trigger.due());
+    ASSERT_TRUE(trigger.stopRequested());
+}
+
+TEST_F(CheckpointTest, TestTriggeredByInterval)
+{
+    CheckpointTrigger trigger{std::chrono::seconds(0)};
+    ASSERT_TRUE(trigger.due());
+}
+
+TEST_F(CheckpointTest, TestResumedDataManagerAppends)
+{
+    Wavefunction2D wfn{grid};
+    {
+        DataManager2D dm{"2D_resume_test_file.h5", params, grid};
+        for (int i = 0; i < 3; ++i)
+        {
+            complexVector_t saved = state(i);
+            wfn.setComponent(saved);
+            dm.saveWavefunctionData(wfn);
+        }
+    }
+
+    // Resume as if the last checkpoint was taken after two snapshots
+    DataOptions options{};
+    options.resumeSnapshots = 2;
+    {
+        DataManager2D dm{"2D_resume_test_file.h5", params, grid, options};
+        complexVector_t saved = state(10.0);
+        wfn.setComponent(saved);
+        dm.saveWavefunctionData(wfn);
+        ASSERT_EQ(dm.numSnapshots(), 3);
+    }
+
+    HighFive::File file{"2D_resume_test_file.h5", HighFive::File::ReadOnly};
+    auto wfnDataSet = file.getDataSet("wavefunction");
+    ASSERT_EQ(wfnDataSet.getDimensions()[0], 3);
+
+    std::vector<std::complex<double>> loadedWfn(GRID_LENGTH * GRID_LENGTH);
+    wfnDataSet.select({2, 0, 0}, {1, GRID_LENGTH, GRID_LENGTH})
+            .read(loadedWfn.data());
+    ASSERT_EQ(loadedWfn, state(10.0));
+}
+
+TEST_F(CheckpointTest, TestResumedTimeSeriesCutBack)
+{
+    std::map<std::string, std::size_t> numRecords;
+    {
+        DataManager2D dm{"2D_resume_series_test_file.h5", params, grid};
+        for (int i = 0; i < 3; ++i)
+        {
+            dm.recordScalar("atomNumber", i);
+            if (i == 1)
+            {
+                // Checkpoint after two records, before the event series
+                dm.flush();
+                numRecords = dm.numRecords();
+            }
+        }
+        dm.recordScalar("eventTime", 2.0);
+    }
+    ASSERT_EQ(numRecords, (std::map<std::string, std::size_t>{
+                                  {"/timeseries/atomNumber", 2}}));
+
+    DataOptions options{};
+    options.resumeSnapshots = 0;
+    options.resumeRecords = numRecords;
+    {
+        DataManager2D dm{"2D_resume_series_test_file.h5", params, grid,
+                         options};
+        ASSERT_EQ(dm.numRecords(), (std::map<std::string, std::size_t>{
+                                           {"/timeseries/atomNumber", 2},
+                                           {"/timeseries/eventTime", 0}}));
+        dm.recordScalar("atomNumber", 10.0);
+        ASSERT_EQ(dm.numRecords()["/timeseries/atomNumber"], 3);
+    }
+
+    HighFive::File file{"2D_resume_series_test_file.h5",
+                        HighFive::File::ReadOnly};
+    std::vector<double> atomNumber;
+    file.getDataSet("/timeseries/atomNumber").read(atomNumber);
+    ASSERT_EQ(atomNumber, (std::vector<double>{0.0, 1.0, 10.0}));
+    ASSERT_EQ(file.getDataSet("/timeseries/eventTime").getDimensions()[0], 0);
+}
+
+TEST_F(CheckpointTest, TestResumedRegionsCutBack)
+{
+    Wavefunction2D wfn{grid};
+    std::map<std::string, std::size_t> numRecords;
+    {
+        DataManager2D dm{"2D_resume_region_test_file.h5", params, grid};
+        dm.addRegion("core", {4, 4}, {2, 2});
+        dm.addProbes("centre", {{8, 8}});
+        for (int i = 0; i < 3; ++i)
+        {
+            complexVector_t saved = state(i);
+            wfn.setComponent(saved);
+            dm.saveRegionData(wfn);
+            if (i == 1)
+            {
+                // Checkpoint after two records
+                dm.flush();
+                numRecords = dm.numRecords();
+            }
+        }
+    }
+    ASSERT_EQ(numRecords, (std::map<std::string, std::size_t>{
+                                  {"/probes/centre", 2},
+                                  {"/regions/core", 2}}));
+
+    DataOptions options{};
+    options.resumeSnapshots = 0;
+    options.resumeRecords = numRecords;
+    {
+        DataManager2D dm{"2D_resume_region_test_file.h5", params, grid,
+                         options};
+        dm.addRegion("core", {4, 4}, {2, 2});
+        dm.addProbes("centre", {{8, 8}});
+        complexVector_t saved = state(10.0);
+        wfn.setComponent(saved);
+        dm.saveRegionData(wfn);
+        ASSERT_EQ(dm.numRecords()["/regions/core"], 3);
+    }
+
+    HighFive::File file{"2D_resume_region_test_file.h5",
+                        HighFive::File::ReadOnly};
+    ASSERT_EQ(file.getDataSet("/regions/core").getDimensions()[0], 3);
+    ASSERT_EQ(file.getDataSet("/probes/centre").getDimensions()[0], 3);
+    std::vector<std::complex<double>> probes(3);
+    file.getDataSet("/probes/centre").read(probes.data());
+    ASSERT_EQ(probes[1], state(1.0)[8 * GRID_LENGTH + 8]);
+    ASSERT_EQ(probes[2], state(10.0)[8 * GRID_LENGTH + 8]);
+}
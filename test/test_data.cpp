@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "data.h"
 #include "grid.h"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
 
 constexpr auto GRID_LENGTH = 32;
 constexpr auto GRID_SPACING = 0.5;
@@ -42,9 +45,10 @@ TEST_F(DataManager1DTest, TestWavefunctionSaved)
     wfn.setComponent(initialState);
     dm.saveWavefunctionData(wfn);
 
+    // Read the first snapshot of the (t, x) dataset
     auto wfnDataSet = dm.file.getDataSet("wavefunction");
-    auto loadedWfn = wfnDataSet.read<std::vector<std::complex<double>>>();
-    wfnDataSet.read(loadedWfn);
+    std::vector<std::complex<double>> loadedWfn(GRID_LENGTH);
+    wfnDataSet.select({0, 0}, {1, GRID_LENGTH}).read(loadedWfn.data());
 
     for (int i = 0; i < GRID_LENGTH; ++i)
     {
@@ -82,9 +86,11 @@ TEST_F(DataManager2DTest, TestWavefunctionSaved)
     wfn.setComponent(initialState);
     dm.saveWavefunctionData(wfn);
 
+    // Read the first snapshot of the (t, x, y) dataset
     auto wfnDataSet = dm.file.getDataSet("wavefunction");
-    auto loadedWfn = wfnDataSet.read<std::vector<std::complex<double>>>();
-    wfnDataSet.read(loadedWfn);
+    std::vector<std::complex<double>> loadedWfn(GRID_LENGTH * GRID_LENGTH);
+    wfnDataSet.select({0, 0, 0}, {1, GRID_LENGTH, GRID_LENGTH})
+            .read(loadedWfn.data());
 
     for (int i = 0; i < GRID_LENGTH; ++i)
     {
@@ -131,9 +137,12 @@ TEST_F(DataManager3DTest, TestWavefunctionSaved)
     wfn.setComponent(initialState);
     dm.saveWavefunctionData(wfn);
 
+    // Read the first snapshot of the (t, x, y, z) dataset
     auto wfnDataSet = dm.file.getDataSet("wavefunction");
-    auto loadedWfn = wfnDataSet.read<std::vector<std::complex<double>>>();
-    wfnDataSet.read(loadedWfn);
+    std::vector<std::complex<double>> loadedWfn(GRID_LENGTH * GRID_LENGTH *
+                                                GRID_LENGTH);
+    wfnDataSet.select({0, 0, 0, 0}, {1, GRID_LENGTH, GRID_LENGTH, GRID_LENGTH})
+            .read(loadedWfn.data());
 
     for (int i = 0; i < GRID_LENGTH; ++i)
     {
@@ -147,3 +156,504 @@ TEST_F(DataManager3DTest, TestWavefunctionSaved)
         }
     }
 }
+
+TEST(DataManagerTest, TestSnapshotDataSetTrimmed)
+{
+    std::tuple<unsigned int, unsigned int, unsigned int> points{
+            GRID_LENGTH, GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double, double> gridSpacing{GRID_SPACING, GRID_SPACING,
+                                                   GRID_SPACING};
+    Grid3D grid{points, gridSpacing};
+    Wavefunction3D wfn{grid};
+    complexVector_t initialState(GRID_LENGTH * GRID_LENGTH * GRID_LENGTH,
+                                 std::complex<double>{1.0, 0.0});
+    wfn.setComponent(initialState);
+
+    // Small chunks so each snapshot is split into tiles
+    DataOptions options{};
+    options.chunkBytes = 16 * 16 * 16 * sizeof(std::complex<double>);
+    {
+        DataManager3D dm{"3D_trimmed_test_file.h5", parameters(), grid,
+                         options};
+        auto dims = dm.file.getDataSet("wavefunction").getDimensions();
+        ASSERT_EQ(dims[0], parameters().numTimeSteps);
+
+        dm.saveWavefunctionData(wfn);
+        dm.saveWavefunctionData(wfn);
+    }
+
+    HighFive::File file{"3D_trimmed_test_file.h5", HighFive::File::ReadOnly};
+    std::vector<std::size_t> expected{2, GRID_LENGTH, GRID_LENGTH, GRID_LENGTH};
+    ASSERT_EQ(file.getDataSet("wavefunction").getDimensions(), expected);
+}
+
+TEST(SnapshotWriterTest, TestSnapshotsWrittenInOrder)
+{
+    std::vector<std::complex<double>> written{};
+    {
+        SnapshotWriter writer{2, [&written](const complexVector_t& snapshot)
+                              {
+                                  std::this_thread::sleep_for(
+                                          std::chrono::milliseconds(1));
+                                  written.push_back(snapshot[0]);
+                              }};
+        for (int i = 0; i < 20; ++i)
+        {
+            writer.push(complexVector_t(GRID_LENGTH, {1.0 * i, 0.0}));
+        }
+        writer.flush();
+        ASSERT_EQ(written.size(), 20);
+
+        writer.push(complexVector_t(GRID_LENGTH, {20.0, 0.0}));
+    }
+
+    // The destructor writes the pending snapshot
+    ASSERT_EQ(written.size(), 21);
+    for (int i = 0; i < written.size(); ++i)
+    {
+        ASSERT_EQ(written[i], std::complex<double>(1.0 * i, 0.0));
+    }
+}
+
+TEST(SnapshotWriterTest, TestWriteErrorRethrown)
+{
+    SnapshotWriter writer{1, [](const complexVector_t&)
+                          { throw std::runtime_error("write failed"); }};
+    writer.push(complexVector_t(GRID_LENGTH));
+
+    ASSERT_THROW(writer.flush(), std::runtime_error);
+}
+
+TEST(DataManagerTest, TestCompressedWavefunctionSaved)
+{
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    Wavefunction2D wfn{grid};
+    complexVector_t initialState(GRID_LENGTH * GRID_LENGTH);
+    for (int i = 0; i < initialState.size(); ++i)
+    {
+        initialState[i] = {std::exp(-0.01 * i), 0.1 * i};
+    }
+    wfn.setComponent(initialState);
+
+    // Chunks of 12 x 12 points do not divide the grid, written through the
+    // asynchronous writer
+    DataOptions options{};
+    options.chunkBytes = 12 * 12 * sizeof(std::complex<double>);
+    options.deflateLevel = 4;
+    options.writeBuffers = 2;
+    DataManager2D dm{"2D_compressed_test_file.h5", parameters(), grid,
+                     options};
+    dm.saveWavefunctionData(wfn);
+    dm.flush();
+
+    auto wfnDataSet = dm.file.getDataSet("wavefunction");
+    std::vector<std::complex<double>> loadedWfn(GRID_LENGTH * GRID_LENGTH);
+    wfnDataSet.select({0, 0, 0}, {1, GRID_LENGTH, GRID_LENGTH})
+            .read(loadedWfn.data());
+
+    for (int i = 0; i < loadedWfn.size(); ++i)
+    {
+        ASSERT_EQ(loadedWfn[i], wfn.component()[i]);
+    }
+}
+
+TEST(DataManagerTest, TestDeltaEncodedWavefunctionSaved)
+{
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    Wavefunction2D wfn{grid};
+    auto state = [](int frame)
+    {
+        complexVector_t state(GRID_LENGTH * GRID_LENGTH);
+        for (int i = 0; i < state.size(); ++i)
+        {
+            state[i] = {std::exp(-0.01 * i) * (1 + 1e-3 * frame), 0.1 * i};
+        }
+        return state;
+    };
+
+    // Keyframes at snapshots 0 and 3, compressed, lossless and lossy
+    for (int mantissaBits : {52, 20})
+    {
+        DataOptions options{};
+        options.keyframeInterval = 3;
+        options.deflateLevel = 4;
+        options.mantissaBits = mantissaBits;
+        DataManager2D dm{"2D_delta_test_file.h5", parameters(), grid,
+                         options};
+        for (int frame = 0; frame < 5; ++frame)
+        {
+            complexVector_t saved = state(frame);
+            wfn.setComponent(saved);
+            dm.saveWavefunctionData(wfn);
+        }
+        dm.flush();
+
+        auto wfnDataSet = dm.file.getDataSet("wavefunction");
+        for (int frame = 0; frame < 5; ++frame)
+        {
+            complexVector_t expected = state(frame);
+            complexVector_t decoded = readDeltaSnapshot(
+                    wfnDataSet, frame, 3, {0, 0}, {GRID_LENGTH, GRID_LENGTH});
+            for (int i = 0; i < decoded.size(); ++i)
+            {
+                if (mantissaBits == 52)
+                {
+                    ASSERT_EQ(decoded[i], expected[i]);
+                } else
+                {
+                    ASSERT_NEAR(decoded[i].real(), expected[i].real(),
+                                1e-6 * std::abs(expected[i].real()));
+                    ASSERT_NEAR(decoded[i].imag(), expected[i].imag(),
+                                1e-6 * std::abs(expected[i].imag()));
+                }
+            }
+        }
+
+        // Snapshots between keyframes are stored as deltas
+        complexVector_t stored(GRID_LENGTH * GRID_LENGTH);
+        wfnDataSet.select({1, 0, 0}, {1, GRID_LENGTH, GRID_LENGTH})
+                .read(stored.data());
+        ASSERT_NE(stored, state(1));
+    }
+}
+
+TEST(DataManagerTest, TestDerivedFieldsSaved)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Wavefunction1D wfn{grid};
+    complexVector_t initialState(GRID_LENGTH);
+    for (int i = 0; i < GRID_LENGTH; ++i)
+    {
+        initialState[i] = std::polar(0.1 * i, 0.05 * i);
+    }
+    wfn.setComponent(initialState);
+
+    DataOptions options{};
+    options.fields = {OutputField::wavefunctionFloat, OutputField::density,
+                      OutputField::phase};
+    DataManager1D dm{"1D_fields_test_file.h5", parameters(), grid, options};
+    dm.saveWavefunctionData(wfn);
+    dm.flush();
+
+    ASSERT_FALSE(dm.file.exist("wavefunction"));
+    std::vector<std::complex<float>> loadedWfn(GRID_LENGTH);
+    std::vector<float> density(GRID_LENGTH);
+    std::vector<float> phase(GRID_LENGTH);
+    dm.file.getDataSet("wavefunctionFloat")
+            .select({0, 0}, {1, GRID_LENGTH})
+            .read(loadedWfn.data());
+    dm.file.getDataSet("density")
+            .select({0, 0}, {1, GRID_LENGTH})
+            .read(density.data());
+    dm.file.getDataSet("phase")
+            .select({0, 0}, {1, GRID_LENGTH})
+            .read(phase.data());
+
+    for (int i = 0; i < GRID_LENGTH; ++i)
+    {
+        auto value = wfn.component()[i];
+        ASSERT_EQ(loadedWfn[i], std::complex<float>(value));
+        ASSERT_FLOAT_EQ(density[i], std::norm(value));
+        ASSERT_FLOAT_EQ(phase[i], std::arg(value));
+    }
+}
+
+TEST(DataManagerTest, TestDownsampledWavefunctionSaved)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Wavefunction1D wfn{grid};
+    complexVector_t initialState(GRID_LENGTH);
+    for (int i = 0; i < GRID_LENGTH; ++i)
+    {
+        initialState[i] = std::polar(1.0, 2 * PI * grid.xMesh()[i] /
+                                                  (GRID_LENGTH * GRID_SPACING));
+    }
+    wfn.setComponent(initialState);
+
+    DataOptions options{};
+    options.downsampling = 4;
+    DataManager1D dm{"1D_downsampled_test_file.h5", parameters(), grid,
+                     options};
+    dm.saveWavefunctionData(wfn);
+    dm.flush();
+
+    unsigned int xPoints{};
+    double xGridSpacing{};
+    dm.file.getDataSet("/grid/xPoints").read(xPoints);
+    dm.file.getDataSet("/grid/xGridSpacing").read(xGridSpacing);
+    ASSERT_EQ(xPoints, GRID_LENGTH / 4);
+    ASSERT_DOUBLE_EQ(xGridSpacing, 4 * GRID_SPACING);
+
+    complexVector_t loadedWfn(GRID_LENGTH / 4);
+    dm.file.getDataSet("wavefunction")
+            .select({0, 0}, {1, GRID_LENGTH / 4})
+            .read(loadedWfn.data());
+
+    // The state only occupies the lowest mode, so it survives downsampling
+    for (int i = 0; i < loadedWfn.size(); ++i)
+    {
+        ASSERT_NEAR(std::abs(loadedWfn[i] - initialState[4 * i]), 0.0, 1e-12);
+    }
+}
+
+TEST(DataManagerTest, TestRegionAndProbeDataSaved)
+{
+    constexpr auto NUM_RECORDS = 5;
+    Grid2D grid{{GRID_LENGTH, GRID_LENGTH}, {GRID_SPACING, GRID_SPACING}};
+    Wavefunction2D wfn{grid};
+
+    DataManager2D dm{"2D_region_test_file.h5", parameters(), grid};
+    dm.addRegion("core", {4, 8}, {3, 2});
+    dm.addProbes("centre", {{16, 16}, {0, 31}});
+
+    complexVector_t state(GRID_LENGTH * GRID_LENGTH);
+    for (int record = 0; record < NUM_RECORDS; ++record)
+    {
+        for (int i = 0; i < state.size(); ++i)
+        {
+            state[i] = {static_cast<double>(i), static_cast<double>(record)};
+        }
+        wfn.setComponent(state);
+        dm.saveRegionData(wfn);
+    }
+    dm.flush();
+
+    auto regionDims = dm.file.getDataSet("/regions/core").getDimensions();
+    auto probeDims = dm.file.getDataSet("/probes/centre").getDimensions();
+    ASSERT_EQ(regionDims, (std::vector<std::size_t>{NUM_RECORDS, 3, 2}));
+    ASSERT_EQ(probeDims, (std::vector<std::size_t>{NUM_RECORDS, 2}));
+
+    complexVector_t region(NUM_RECORDS * 3 * 2);
+    complexVector_t probes(NUM_RECORDS * 2);
+    dm.file.getDataSet("/regions/core").read(region.data());
+    dm.file.getDataSet("/probes/centre").read(probes.data());
+
+    for (int record = 0; record < NUM_RECORDS; ++record)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 2; ++j)
+            {
+                double index = (4 + i) * GRID_LENGTH + 8 + j;
+                ASSERT_EQ(region[(record * 3 + i) * 2 + j],
+                          std::complex<double>(index, record));
+            }
+        }
+        ASSERT_EQ(probes[record * 2],
+                  std::complex<double>(16 * GRID_LENGTH + 16, record));
+        ASSERT_EQ(probes[record * 2 + 1],
+                  std::complex<double>(31, record));
+    }
+}
+
+TEST(DataManagerTest, TestRegionOutsideGridThrows)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    DataManager1D dm{"1D_region_test_file.h5", parameters(), grid};
+
+    ASSERT_THROW(dm.addRegion("outside", {GRID_LENGTH - 1}, {2}),
+                 std::invalid_argument);
+    ASSERT_THROW(dm.addProbes("outside", {{GRID_LENGTH}}),
+                 std::invalid_argument);
+}
+
+TEST(DataManagerTest, TestProjectionsSaved)
+{
+    constexpr auto POINTS = 8;
+    Grid3D grid{{POINTS, POINTS, POINTS},
+                {GRID_SPACING, GRID_SPACING, GRID_SPACING}};
+    Wavefunction3D wfn{grid};
+    complexVector_t initialState(POINTS * POINTS * POINTS);
+    for (int i = 0; i < initialState.size(); ++i)
+    {
+        initialState[i] = std::polar(1.0 + 0.01 * i, 0.02 * i);
+    }
+    wfn.setComponent(initialState);
+
+    DataOptions options{};
+    options.fields = {};
+    DataManager3D dm{"3D_projection_test_file.h5", parameters(), grid, options};
+    dm.addColumnDensity(2);
+    dm.addMomentumDensity(0, 10.0);
+    dm.saveWavefunctionData(wfn);
+    dm.flush();
+
+    ASSERT_FALSE(dm.file.exist("wavefunction"));
+    ASSERT_EQ(dm.file.getDataSet("/projections/densityZ").getDimensions(),
+              (std::vector<std::size_t>{1, POINTS, POINTS}));
+    ASSERT_EQ(dm.file.getDataSet("/projections/momentumX").getDimensions(),
+              (std::vector<std::size_t>{1, POINTS, POINTS}));
+
+    std::vector<float> density(POINTS * POINTS);
+    std::vector<float> momentum(POINTS * POINTS);
+    std::vector<double> gridSpacing;
+    dm.file.getDataSet("/projections/densityZ").read(density.data());
+    dm.file.getDataSet("/projections/momentumX").read(momentum.data());
+    dm.file.getDataSet("/projections/momentumXGridSpacing").read(gridSpacing);
+
+    std::vector<double> expectedDensity = columnDensity(wfn, 2);
+    std::vector<double> expectedMomentum = columnMomentumDensity(wfn, 0);
+    for (int i = 0; i < density.size(); ++i)
+    {
+        ASSERT_FLOAT_EQ(density[i], expectedDensity[i]);
+        ASSERT_FLOAT_EQ(momentum[i], expectedMomentum[i]);
+    }
+
+    auto [xFourierSpacing, yFourierSpacing, zFourierSpacing] =
+            grid.fourierGridSpacing();
+    ASSERT_EQ(gridSpacing, (std::vector<double>{10.0 * yFourierSpacing,
+                                                10.0 * zFourierSpacing}));
+}
+
+TEST(DataManagerTest, TestAccumulatorDataSaved)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Wavefunction1D wfn{grid};
+    FieldAccumulator accumulator{grid, {AccumulatedField::density}};
+    DataManager1D dm{"1D_accumulator_test_file.h5", parameters(), grid};
+
+    complexVector_t state(GRID_LENGTH);
+    for (int sample = 1; sample <= 2; ++sample)
+    {
+        for (int i = 0; i < GRID_LENGTH; ++i)
+        {
+            state[i] = std::polar(static_cast<double>(sample * i), 0.1 * i);
+        }
+        wfn.setComponent(state);
+        accumulator.accumulate(wfn);
+        dm.saveAccumulatorData(accumulator);
+    }
+    dm.flush();
+
+    std::size_t count{};
+    std::vector<double> mean;
+    std::vector<double> variance;
+    dm.file.getDataSet("/accumulators/count").read(count);
+    dm.file.getDataSet("/accumulators/density/mean").read(mean);
+    dm.file.getDataSet("/accumulators/density/variance").read(variance);
+
+    ASSERT_EQ(count, 2);
+    ASSERT_EQ(mean, accumulator.mean(AccumulatedField::density));
+    ASSERT_EQ(variance, accumulator.variance(AccumulatedField::density));
+}
+
+TEST(DataManagerTest, TestTimeSeriesSaved)
+{
+    constexpr auto NUM_STEPS = 21;
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+
+    // Small chunks, so the series are written in several blocks
+    DataOptions options{};
+    options.chunkBytes = 64;
+    DataManager1D dm{"1D_timeseries_test_file.h5", parameters(), grid,
+                     options};
+    for (int step = 0; step < NUM_STEPS; ++step)
+    {
+        dm.recordScalar("atomNumber", 100.0 - step);
+        dm.recordSeries("energy", {1.0 * step, 2.0 * step, 3.0 * step});
+    }
+    ASSERT_THROW(dm.recordSeries("energy", {1.0}), std::invalid_argument);
+    dm.flush();
+
+    auto scalarDims = dm.file.getDataSet("/timeseries/atomNumber")
+                              .getDimensions();
+    auto seriesDims = dm.file.getDataSet("/timeseries/energy").getDimensions();
+    ASSERT_EQ(scalarDims, (std::vector<std::size_t>{NUM_STEPS}));
+    ASSERT_EQ(seriesDims, (std::vector<std::size_t>{NUM_STEPS, 3}));
+
+    std::vector<double> atomNumber(NUM_STEPS);
+    std::vector<double> energy(NUM_STEPS * 3);
+    dm.file.getDataSet("/timeseries/atomNumber").read(atomNumber.data());
+    dm.file.getDataSet("/timeseries/energy").read(energy.data());
+    for (int step = 0; step < NUM_STEPS; ++step)
+    {
+        ASSERT_EQ(atomNumber[step], 100.0 - step);
+        for (int i = 0; i < 3; ++i)
+        {
+            ASSERT_EQ(energy[step * 3 + i], (i + 1.0) * step);
+        }
+    }
+}
+
+TEST(SnapshotRingBufferTest, TestMostRecentSnapshotsKept)
+{
+    for (int deflateLevel : {0, 6})
+    {
+        SnapshotRingBuffer ringBuffer{3, deflateLevel};
+        for (int i = 0; i < 5; ++i)
+        {
+            complexVector_t snapshot(GRID_LENGTH, {1.0 * i, 0.5 * i});
+            ringBuffer.push(snapshot, 0.1 * i);
+        }
+        ASSERT_EQ(ringBuffer.size(), 3);
+
+        std::vector<double> times;
+        ringBuffer.drain([&times](const complexVector_t& snapshot, double time)
+                         {
+                             int i = static_cast<int>(times.size()) + 2;
+                             for (const auto& value : snapshot)
+                             {
+                                 ASSERT_EQ(value,
+                                           std::complex<double>(1.0 * i,
+                                                                0.5 * i));
+                             }
+                             times.push_back(time);
+                         });
+        ASSERT_EQ(times.size(), 3);
+        for (int i = 0; i < times.size(); ++i)
+        {
+            ASSERT_DOUBLE_EQ(times[i], 0.1 * (i + 2));
+        }
+        ASSERT_EQ(ringBuffer.size(), 0);
+    }
+}
+
+TEST(DataManagerTest, TestEventSnapshotsSaved)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Wavefunction1D wfn{grid};
+
+    DataOptions options{};
+    options.ringBufferSnapshots = 2;
+    options.postEventSnapshots = 1;
+    DataManager1D dm{"1D_event_test_file.h5", parameters(), grid, options};
+
+    // Snapshots without a recorded time would misalign the saved times
+    ASSERT_THROW(dm.saveWavefunctionData(wfn), std::logic_error);
+
+    complexVector_t state(GRID_LENGTH);
+    for (int step = 0; step < 8; ++step)
+    {
+        std::fill(state.begin(), state.end(), std::complex<double>{1.0 * step});
+        wfn.setComponent(state);
+        dm.bufferWavefunctionData(wfn, step);
+        if (step == 4)
+        {
+            dm.triggerEvent(step);
+        }
+    }
+    dm.flush();
+
+    // Steps 3 and 4 before the event, and step 5 after it
+    std::vector<double> snapshotTime;
+    std::vector<double> eventTime;
+    dm.file.getDataSet("/timeseries/snapshotTime").read(snapshotTime);
+    dm.file.getDataSet("/timeseries/eventTime").read(eventTime);
+    ASSERT_EQ(dm.numSnapshots(), 3);
+    ASSERT_EQ(snapshotTime, (std::vector<double>{3, 4, 5}));
+    ASSERT_EQ(eventTime, (std::vector<double>{4}));
+
+    complexVector_t loadedWfn(GRID_LENGTH);
+    for (int snapshot = 0; snapshot < 3; ++snapshot)
+    {
+        dm.file.getDataSet("wavefunction")
+                .select({static_cast<std::size_t>(snapshot), 0},
+                        {1, GRID_LENGTH})
+                .read(loadedWfn.data());
+        ASSERT_NEAR(loadedWfn[0].real(), snapshotTime[snapshot], 1e-12);
+    }
+}
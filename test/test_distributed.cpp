@@ -0,0 +1,153 @@
+#include "distributed.h"
+#include <gtest/gtest.h>
+
+// The y axis does not divide over 4 ranks, leaving one without Fourier modes
+constexpr auto X_POINTS = 8;
+constexpr auto Y_POINTS = 6;
+constexpr auto Z_POINTS = 4;
+constexpr auto GRID_SPACING = 0.5;
+
+class DistributedWavefunctionTest : public ::testing::Test
+{
+public:
+    std::tuple<unsigned int, unsigned int, unsigned int> points{
+            X_POINTS, Y_POINTS, Z_POINTS};
+    std::tuple<double, double, double> gridSpacing{GRID_SPACING, GRID_SPACING,
+                                                   GRID_SPACING};
+    DistributedGrid3D grid{MPI_COMM_WORLD, points, gridSpacing};
+
+    // Gaussian with a phase gradient, so that every axis carries momentum
+    static std::complex<double> state(double x, double y, double z)
+    {
+        return std::exp(-(x * x + y * y + z * z) / 4.0) *
+               std::exp(std::complex<double>{0, 0.7 * x - 0.3 * y + 0.5 * z});
+    }
+
+    complexVector_t localState()
+    {
+        complexVector_t local(grid.localPoints());
+        for (std::size_t i = 0; i < local.size(); ++i)
+        {
+            local[i] = state(grid.xMesh()[i], grid.yMesh()[i],
+                             grid.zMesh()[i]);
+        }
+        return local;
+    }
+};
+
+TEST_F(DistributedWavefunctionTest, TestSlabsCoverGrid)
+{
+    unsigned long localPoints[2] = {grid.localXPoints(), grid.localYPoints()};
+    unsigned long totalPoints[2]{};
+    MPI_Allreduce(localPoints, totalPoints, 2, MPI_UNSIGNED_LONG, MPI_SUM,
+                  MPI_COMM_WORLD);
+
+    ASSERT_EQ(totalPoints[0], X_POINTS);
+    ASSERT_EQ(totalPoints[1], Y_POINTS);
+    ASSERT_EQ(grid.wavenumber().size(),
+              grid.localYPoints() * X_POINTS * Z_POINTS);
+    ASSERT_GE(grid.localSize(), grid.localPoints());
+    ASSERT_GE(grid.localSize(), grid.wavenumber().size());
+}
+
+TEST_F(DistributedWavefunctionTest, TestFFTRoundTrip)
+{
+    DistributedWavefunction3D wfn{grid};
+    complexVector_t initialState = localState();
+    wfn.setComponent(initialState);
+    wfn.ifft();
+
+    for (std::size_t i = 0; i < initialState.size(); ++i)
+    {
+        ASSERT_NEAR(std::abs(wfn.component()[i] - initialState[i]), 0, 1e-12);
+    }
+}
+
+TEST_F(DistributedWavefunctionTest, TestEvolutionMatchesSerial)
+{
+    Parameters params{};
+    params.intStrength = 2.0;
+    params.timeStep = std::complex<double>{1e-2, 0};
+
+    // Serial evolution of the whole grid on every rank
+    Grid3D serialGrid{points, gridSpacing};
+    Wavefunction3D serialWfn{serialGrid};
+    Parameters serialParams = params;
+    complexVector_t serialState(X_POINTS * Y_POINTS * Z_POINTS);
+    for (std::size_t i = 0; i < serialState.size(); ++i)
+    {
+        double x = serialGrid.xMesh()[i];
+        double y = serialGrid.yMesh()[i];
+        double z = serialGrid.zMesh()[i];
+        serialState[i] = state(x, y, z);
+        serialParams.trap.push_back(0.5 * (x * x + y * y + z * z));
+    }
+    serialWfn.setComponent(serialState);
+
+    DistributedWavefunction3D wfn{grid};
+    complexVector_t initialState = localState();
+    wfn.setComponent(initialState);
+    for (std::size_t i = 0; i < grid.localPoints(); ++i)
+    {
+        double x = grid.xMesh()[i];
+        double y = grid.yMesh()[i];
+        double z = grid.zMesh()[i];
+        params.trap.push_back(0.5 * (x * x + y * y + z * z));
+    }
+
+    for (int step = 0; step < 3; ++step)
+    {
+        fourierStep(serialWfn, serialParams);
+        serialWfn.ifft();
+        interactionStep(serialWfn, serialParams);
+        serialWfn.fft();
+        fourierStep(serialWfn, serialParams);
+
+        fourierStep(wfn, params);
+        wfn.ifft();
+        interactionStep(wfn, params);
+        wfn.fft();
+        fourierStep(wfn, params);
+    }
+    serialWfn.ifft();
+    wfn.ifft();
+
+    std::size_t offset = grid.localXStart() * Y_POINTS * Z_POINTS;
+    for (std::size_t i = 0; i < grid.localPoints(); ++i)
+    {
+        ASSERT_NEAR(std::abs(wfn.component()[i] -
+                             serialWfn.component()[offset + i]),
+                    0, 1e-12);
+    }
+}
+
+TEST_F(DistributedWavefunctionTest, TestAtomNumberRenormalised)
+{
+    DistributedWavefunction3D wfn{grid};
+    complexVector_t initialState = localState();
+    wfn.setComponent(initialState);
+
+    double expected{};
+    auto [xPoints, yPoints, zPoints] = points;
+    for (int i = 0; i < xPoints; ++i)
+    {
+        for (int j = 0; j < yPoints; ++j)
+        {
+            for (int k = 0; k < zPoints; ++k)
+            {
+                expected += std::norm(state((i - xPoints / 2.) * GRID_SPACING,
+                                            (j - yPoints / 2.) * GRID_SPACING,
+                                            (k - zPoints / 2.) * GRID_SPACING));
+            }
+        }
+    }
+    expected *= GRID_SPACING * GRID_SPACING * GRID_SPACING;
+    ASSERT_NEAR(wfn.atomNumber(), expected, 1e-12);
+
+    for (std::size_t i = 0; i < grid.localPoints(); ++i)
+    {
+        wfn.component()[i] *= 2.0;
+    }
+    renormaliseAtomNum(wfn);
+    ASSERT_NEAR(calculateAtomNum(wfn), expected, 1e-12);
+}
@@ -0,0 +1,156 @@
+#include "ensemble.h"
+#include <gtest/gtest.h>
+
+constexpr auto GRID_LENGTH = 16;
+constexpr auto GRID_SPACING = 0.5;
+constexpr auto NUM_REALISATIONS = 5;
+
+// Gaussian displaced and phase-shifted differently in each realisation
+std::complex<double> realisationState(double x, double y, int realisation)
+{
+    double shift = 0.2 * realisation;
+    return std::exp(-((x - shift) * (x - shift) + y * y) / 4.0) *
+           std::exp(std::complex<double>{0, 0.3 * realisation * x});
+}
+
+TEST(Ensemble1DTest, TestEvolutionMatchesSeparateWavefunctions)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Parameters params{};
+    params.intStrength = 2.0;
+    params.timeStep = std::complex<double>{1e-2, 0};
+    for (auto x : grid.xMesh())
+    {
+        params.trap.push_back(0.5 * x * x);
+    }
+
+    EnsembleWavefunction1D ensemble{grid, NUM_REALISATIONS};
+    for (int m = 0; m < NUM_REALISATIONS; ++m)
+    {
+        complexVector_t state(GRID_LENGTH);
+        for (int i = 0; i < GRID_LENGTH; ++i)
+        {
+            state[i] = realisationState(grid.xMesh()[i], 0, m);
+        }
+        ensemble.setRealisation(m, state);
+    }
+    ensemble.fft();
+
+    for (int step = 0; step < 3; ++step)
+    {
+        fourierStep(ensemble, params);
+        ensemble.ifft();
+        interactionStep(ensemble, params);
+        ensemble.fft();
+        fourierStep(ensemble, params);
+    }
+    ensemble.ifft();
+
+    for (int m = 0; m < NUM_REALISATIONS; ++m)
+    {
+        Wavefunction1D wfn{grid};
+        complexVector_t state(GRID_LENGTH);
+        for (int i = 0; i < GRID_LENGTH; ++i)
+        {
+            state[i] = realisationState(grid.xMesh()[i], 0, m);
+        }
+        wfn.setComponent(state);
+        for (int step = 0; step < 3; ++step)
+        {
+            fourierStep(wfn, params);
+            wfn.ifft();
+            interactionStep(wfn, params);
+            wfn.fft();
+            fourierStep(wfn, params);
+        }
+        wfn.ifft();
+
+        complexVector_t evolved = ensemble.realisation(m);
+        for (int i = 0; i < GRID_LENGTH; ++i)
+        {
+            ASSERT_NEAR(std::abs(evolved[i] - wfn.component()[i]), 0, 1e-12);
+        }
+    }
+}
+
+TEST(Ensemble2DTest, TestObservablesCorrect)
+{
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    EnsembleWavefunction2D ensemble{grid, NUM_REALISATIONS};
+    for (int m = 0; m < NUM_REALISATIONS; ++m)
+    {
+        complexVector_t state(GRID_LENGTH * GRID_LENGTH);
+        for (int i = 0; i < state.size(); ++i)
+        {
+            state[i] = (1.0 + m) *
+                       realisationState(grid.xMesh()[i], grid.yMesh()[i], m);
+        }
+        ensemble.setRealisation(m, state);
+    }
+
+    // The batched transforms keep every realisation separate
+    ensemble.fft();
+    ensemble.ifft();
+    std::vector<double> meanDensity = ensemble.meanDensity();
+    std::vector<double> atomNumbers = ensemble.atomNumbers();
+    double meanAtomNumber = 0.0;
+    for (int m = 0; m < NUM_REALISATIONS; ++m)
+    {
+        std::vector<double> density = ensemble.density(m);
+        double atomNumber = 0.0;
+        for (int i = 0; i < density.size(); ++i)
+        {
+            double expected = std::norm(
+                    (1.0 + m) *
+                    realisationState(grid.xMesh()[i], grid.yMesh()[i], m));
+            ASSERT_NEAR(density[i], expected, 1e-12);
+            atomNumber += expected * GRID_SPACING * GRID_SPACING;
+        }
+        ASSERT_NEAR(atomNumbers[m], atomNumber, 1e-10);
+        meanAtomNumber += atomNumber / NUM_REALISATIONS;
+    }
+    ASSERT_NEAR(ensemble.meanAtomNumber(), meanAtomNumber, 1e-10);
+
+    for (int i = 0; i < meanDensity.size(); ++i)
+    {
+        double expected = 0.0;
+        for (int m = 0; m < NUM_REALISATIONS; ++m)
+        {
+            expected += ensemble.density(m)[i] / NUM_REALISATIONS;
+        }
+        ASSERT_NEAR(meanDensity[i], expected, 1e-12);
+    }
+}
+
+TEST(Ensemble2DTest, TestRealisationOutOfRangeThrows)
+{
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    EnsembleWavefunction2D ensemble{grid, NUM_REALISATIONS};
+
+    ASSERT_THROW(static_cast<void>(ensemble.realisation(NUM_REALISATIONS)),
+                 std::out_of_range);
+    ASSERT_THROW(ensemble.setRealisation(0, complexVector_t(3)),
+                 std::invalid_argument);
+}
+
+TEST(Ensemble2DTest, TestMismatchedTrapThrows)
+{
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    EnsembleWavefunction2D ensemble{grid, NUM_REALISATIONS};
+    Wavefunction2D wfn{grid};
+    Parameters params{};
+
+    // A trap the size of the whole batch would stride the realisations wrongly
+    params.trap.resize(GRID_LENGTH * GRID_LENGTH * NUM_REALISATIONS);
+    ASSERT_THROW(interactionStep(ensemble, params), std::invalid_argument);
+
+    params.trap.clear();
+    ASSERT_THROW(interactionStep(ensemble, params), std::invalid_argument);
+    ASSERT_THROW(interactionStep(wfn, params), std::invalid_argument);
+}
@@ -0,0 +1,161 @@
+#include "noise.h"
+#include <gtest/gtest.h>
+#include <omp.h>
+
+constexpr auto GRID_LENGTH = 32;
+constexpr auto GRID_SPACING = 0.5;
+constexpr std::uint64_t SEED = 1234;
+
+TEST(PhiloxTest, TestKnownAnswers)
+{
+    // Known answers of the Random123 reference implementation
+    philoxCounter_t zeros = philox4x32({0, 0, 0, 0}, {0, 0});
+    philoxCounter_t expectedZeros = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                     0x9b00dbd8};
+    ASSERT_EQ(zeros, expectedZeros);
+
+    philoxCounter_t ones = philox4x32(
+            {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+            {0xffffffff, 0xffffffff});
+    philoxCounter_t expectedOnes = {0x408f276d, 0x41c83b0e, 0xa20bc7c6,
+                                    0x6d5451fd};
+    ASSERT_EQ(ones, expectedOnes);
+
+    philoxCounter_t pi = philox4x32(
+            {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+            {0xa4093822, 0x299f31d0});
+    philoxCounter_t expectedPi = {0xd16cfe09, 0x94fdcceb, 0x5001e420,
+                                  0x24126ea1};
+    ASSERT_EQ(pi, expectedPi);
+}
+
+TEST(NoiseTest, TestIndependentOfThreadCount)
+{
+    complexVector_t serial(10000);
+    complexVector_t parallel(10000);
+
+    int numThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    addComplexGaussian(serial, 1.0, SEED, 3);
+    applyRandomPhase(serial, SEED, 4);
+    omp_set_num_threads(4);
+    addComplexGaussian(parallel, 1.0, SEED, 3);
+    applyRandomPhase(parallel, SEED, 4);
+    omp_set_num_threads(numThreads);
+
+    for (std::size_t i = 0; i < serial.size(); ++i)
+    {
+        ASSERT_EQ(serial[i], parallel[i]);
+    }
+}
+
+TEST(NoiseTest, TestGaussianMoments)
+{
+    constexpr int numSamples = 200000;
+    complexVector_t noise(numSamples);
+    addComplexGaussian(noise, 2.0, SEED, 0);
+
+    std::complex<double> mean{};
+    double variance{};
+    std::complex<double> pseudoVariance{};
+    for (const auto& value : noise)
+    {
+        mean += value / static_cast<double>(numSamples);
+        variance += std::norm(value) / numSamples;
+        pseudoVariance += value * value / static_cast<double>(numSamples);
+    }
+
+    // Statistical errors are of order 1 / sqrt(numSamples)
+    ASSERT_NEAR(std::abs(mean), 0, 0.02);
+    ASSERT_NEAR(variance, 4.0, 0.05);
+    ASSERT_NEAR(std::abs(pseudoVariance), 0, 0.05);
+}
+
+TEST(NoiseTest, TestEnsembleMatchesSingleRealisation)
+{
+    // Realisation 2 of an ensemble seeded from stream 5 is stream 7
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    EnsembleWavefunction1D ensemble{grid, 3};
+    addVacuumNoise(ensemble, SEED, 5);
+
+    Wavefunction1D wfn{grid};
+    addVacuumNoise(wfn, SEED, 7);
+
+    complexVector_t realisation = ensemble.realisation(2);
+    for (int i = 0; i < GRID_LENGTH; ++i)
+    {
+        ASSERT_EQ(realisation[i], wfn.component()[i]);
+    }
+}
+
+TEST(NoiseTest, TestVacuumNoiseHalfParticlePerMode)
+{
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    constexpr int numRealisations = 50;
+    EnsembleWavefunction2D ensemble{grid, numRealisations};
+    addVacuumNoise(ensemble, SEED);
+
+    // Half a particle in each of the modes of the grid
+    double expected = 0.5 * GRID_LENGTH * GRID_LENGTH;
+    ASSERT_NEAR(ensemble.meanAtomNumber(), expected, 0.02 * expected);
+
+    // White noise of density 1 / (2 dV) at each point
+    double volumeElement = GRID_SPACING * GRID_SPACING;
+    double meanDensity{};
+    for (double density : ensemble.meanDensity())
+    {
+        meanDensity += density / (GRID_LENGTH * GRID_LENGTH);
+    }
+    ASSERT_NEAR(meanDensity * volumeElement, 0.5, 0.01);
+}
+
+TEST(NoiseTest, TestThermalOccupation)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    constexpr int numRealisations = 2000;
+    EnsembleWavefunction1D ensemble{grid, numRealisations};
+    constexpr double temperature = 0.5;
+    constexpr double chemicalPotential = -0.25;
+    addThermalNoise(ensemble, temperature, chemicalPotential, SEED);
+    ensemble.fft();
+
+    // The occupation of mode k is |psi_k|^2 dx / N
+    for (int i = 0; i < GRID_LENGTH; ++i)
+    {
+        double occupation{};
+        for (int m = 0; m < numRealisations; ++m)
+        {
+            occupation +=
+                    std::norm(ensemble.fourierComponent()[i + m * GRID_LENGTH]) *
+                    GRID_SPACING / GRID_LENGTH / numRealisations;
+        }
+        double expected =
+                temperature /
+                (0.5 * grid.wavenumber()[i] - chemicalPotential);
+        ASSERT_NEAR(occupation, expected, 0.1 * expected);
+    }
+
+    ASSERT_THROW(addThermalNoise(ensemble, temperature, 0.1, SEED),
+                 std::invalid_argument);
+}
+
+TEST(NoiseTest, TestRandomPhaseKeepsDensity)
+{
+    std::tuple<unsigned int, unsigned int, unsigned int> points{8, 8, 8};
+    std::tuple<double, double, double> gridSpacing{GRID_SPACING, GRID_SPACING,
+                                                   GRID_SPACING};
+    Grid3D grid{points, gridSpacing};
+    Wavefunction3D wfn{grid};
+    complexVector_t state(8 * 8 * 8, std::complex<double>{0.6, 0.8});
+    wfn.setComponent(state);
+    applyRandomPhase(wfn, SEED);
+
+    // The phases are uniform, so the condensate mode is depleted
+    for (const auto& value : wfn.component())
+    {
+        ASSERT_NEAR(std::abs(value), 1.0, 1e-12);
+    }
+    ASSERT_LT(std::abs(wfn.fourierComponent()[0]), 0.2 * state.size());
+}
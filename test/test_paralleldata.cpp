@@ -0,0 +1,137 @@
+#include "paralleldata.h"
+#include "reader.h"
+#include <gtest/gtest.h>
+#include <mpi.h>
+
+constexpr auto X_POINTS = 10;
+constexpr auto YZ_POINTS = 4;
+constexpr auto GRID_SPACING = 0.5;
+
+class ParallelDataManagerTest : public ::testing::Test
+{
+public:
+    int rank{};
+    int numRanks{};
+    std::size_t localXStart{};
+    std::size_t localXPoints{};
+
+    static std::complex<double> value(int snapshot, std::size_t index)
+    {
+        return {1.0 * snapshot, 1.0 * index};
+    }
+
+    void SetUp() override
+    {
+        // Slabs as laid out by FFTW-MPI, with a smaller last slab
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+        std::size_t block = (X_POINTS + numRanks - 1) / numRanks;
+        localXStart = std::min<std::size_t>(rank * block, X_POINTS);
+        localXPoints = std::min<std::size_t>(block, X_POINTS - localXStart);
+    }
+};
+
+TEST_F(ParallelDataManagerTest, TestSlabsWrittenCollectively)
+{
+    Parameters params{};
+    params.intStrength = 1.5;
+    params.numTimeSteps = 2;
+    params.timeStep = std::complex<double>{1e-2, 0};
+
+    // Small chunks split the slabs, and three snapshots outgrow the capacity
+    DataOptions options{};
+    options.chunkBytes = 2 * YZ_POINTS * YZ_POINTS * 16;
+    constexpr int numSnapshots = 3;
+    {
+        ParallelDataManager3D dm{"3D_parallel_test_file.h5",
+                                 MPI_COMM_WORLD,
+                                 params,
+                                 {X_POINTS, YZ_POINTS, YZ_POINTS},
+                                 {GRID_SPACING, GRID_SPACING, GRID_SPACING},
+                                 localXStart,
+                                 localXPoints,
+                                 options};
+        complexVector_t slab(localXPoints * YZ_POINTS * YZ_POINTS);
+        for (int snapshot = 0; snapshot < numSnapshots; ++snapshot)
+        {
+            for (std::size_t i = 0; i < slab.size(); ++i)
+            {
+                slab[i] = value(snapshot,
+                                localXStart * YZ_POINTS * YZ_POINTS + i);
+            }
+            dm.saveWavefunctionData(slab);
+        }
+        ASSERT_EQ(dm.numSnapshots(), numSnapshots);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    if (rank == 0)
+    {
+        DataReader reader{"3D_parallel_test_file.h5"};
+        auto [xPoints, yPoints, zPoints] = reader.grid3D().shape();
+        ASSERT_EQ(xPoints, X_POINTS);
+        ASSERT_EQ(yPoints, YZ_POINTS);
+        ASSERT_EQ(zPoints, YZ_POINTS);
+        ASSERT_EQ(reader.numSnapshots(), numSnapshots);
+        for (int snapshot = 0; snapshot < numSnapshots; ++snapshot)
+        {
+            auto saved = reader.readSnapshot<std::complex<double>>(
+                    "wavefunction", snapshot);
+            for (std::size_t i = 0; i < saved.size(); ++i)
+            {
+                ASSERT_EQ(saved[i], value(snapshot, i));
+            }
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_F(ParallelDataManagerTest, TestDistributedWavefunctionSaved)
+{
+    DistributedGrid3D grid{MPI_COMM_WORLD,
+                           {X_POINTS, YZ_POINTS, YZ_POINTS},
+                           {GRID_SPACING, GRID_SPACING, GRID_SPACING}};
+    DistributedWavefunction3D wfn{grid};
+    complexVector_t slab(grid.localPoints());
+    for (std::size_t i = 0; i < slab.size(); ++i)
+    {
+        slab[i] = value(1, grid.localXStart() * YZ_POINTS * YZ_POINTS + i);
+    }
+    wfn.setComponent(slab);
+
+    Parameters params{};
+    params.numTimeSteps = 1;
+    {
+        ParallelDataManager3D dm{"3D_distributed_test_file.h5", params, grid};
+        dm.saveWavefunctionData(wfn);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    if (rank == 0)
+    {
+        DataReader reader{"3D_distributed_test_file.h5"};
+        auto saved =
+                reader.readSnapshot<std::complex<double>>("wavefunction", 0);
+        for (std::size_t i = 0; i < saved.size(); ++i)
+        {
+            ASSERT_NEAR(std::abs(saved[i] - value(1, i)), 0, 1e-10);
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_F(ParallelDataManagerTest, TestSlabOutsideGridThrowsOnEveryRank)
+{
+    // Only the last rank is given a slab past the grid
+    std::size_t lastXPoints =
+            rank == numRanks - 1 ? X_POINTS - localXStart + 1 : localXPoints;
+    ASSERT_THROW(ParallelDataManager3D("3D_parallel_invalid_test_file.h5",
+                                       MPI_COMM_WORLD,
+                                       Parameters{},
+                                       {X_POINTS, YZ_POINTS, YZ_POINTS},
+                                       {GRID_SPACING, GRID_SPACING,
+                                        GRID_SPACING},
+                                       localXStart,
+                                       lastXPoints),
+                 std::invalid_argument);
+}
@@ -0,0 +1,127 @@
+#include "potential.h"
+#include <cmath>
+#include <gtest/gtest.h>
+
+constexpr auto GRID_POINTS = 32;
+constexpr auto GRID_SPACING = 0.5;
+
+class PotentialTest : public ::testing::Test
+{
+public:
+    std::array<unsigned int, 3> shape{GRID_POINTS, GRID_POINTS, 1};
+    std::array<double, 3> gridSpacing{GRID_SPACING, GRID_SPACING, 1.0};
+    Potential potential{};
+};
+
+TEST_F(PotentialTest, TestSeparableAmplitudeEvaluatedAtTime)
+{
+    std::vector<double> profile(GRID_POINTS, 2.0);
+    potential.addSeparable(Axis::y, profile, [](double t) { return 3 * t; });
+    PotentialTerms terms = potential.evaluate(shape, gridSpacing, 0.5);
+
+    ASSERT_EQ(terms.staticPart, nullptr);
+    for (int i = 0; i < GRID_POINTS; ++i)
+    {
+        ASSERT_EQ(terms.axis[0][i], 0.0);
+        ASSERT_EQ(terms.axis[1][i], 3.0);
+    }
+}
+
+TEST_F(PotentialTest, TestStirrerEvaluatedInsideBoundingBox)
+{
+    GaussianStirrer stirrer{};
+    stirrer.amplitude = [](double) { return 2.0; };
+    stirrer.position = [](double t) {
+        return std::array<double, 3>{t, 0.0, 0.0};
+    };
+    stirrer.width = 1.0;
+    stirrer.cutoff = 2.0;
+    potential.addStirrer(stirrer);
+    PotentialTerms terms = potential.evaluate(shape, gridSpacing, 1.0);
+
+    // Centre at x = 1.0, which is grid index 18
+    ASSERT_EQ(terms.stirrers.size(), 1);
+    const StirrerTerm& term = terms.stirrers[0];
+    ASSERT_EQ(term.begin[0], 14);
+    ASSERT_EQ(term.end[0], 23);
+    ASSERT_EQ(term.begin[1], 12);
+    ASSERT_EQ(term.end[1], 21);
+    ASSERT_DOUBLE_EQ(term.value(18, 16, 0), 2.0);
+    ASSERT_DOUBLE_EQ(term.value(20, 16, 0), 2.0 * std::exp(-0.5));
+    ASSERT_EQ(term.value(13, 16, 0), 0.0);
+}
+
+TEST_F(PotentialTest, TestStirrerOutsideGridSkipped)
+{
+    GaussianStirrer stirrer{};
+    stirrer.amplitude = [](double) { return 1.0; };
+    stirrer.position = [](double) {
+        return std::array<double, 3>{100.0, 0.0, 0.0};
+    };
+    potential.addStirrer(stirrer);
+
+    ASSERT_TRUE(potential.evaluate(shape, gridSpacing, 0.0).stirrers.empty());
+}
+
+TEST_F(PotentialTest, TestMismatchedProfileThrows)
+{
+    potential.addSeparable(Axis::x, std::vector<double>(GRID_POINTS / 2, 1.0));
+    ASSERT_THROW(static_cast<void>(potential.evaluate(shape, gridSpacing, 0.0)),
+                 std::invalid_argument);
+}
+
+TEST(SeparableTrapTest, TestHarmonicTrapStoredPerAxis)
+{
+    Grid3D grid{{GRID_POINTS, GRID_POINTS / 2, 4},
+                {GRID_SPACING, GRID_SPACING, GRID_SPACING}};
+    SeparableTrap trap = harmonicTrap(grid, {1.0, 2.0, 3.0});
+
+    ASSERT_EQ(trap.axis[0].size(), GRID_POINTS);
+    ASSERT_EQ(trap.axis[1].size(), GRID_POINTS / 2);
+    ASSERT_EQ(trap.axis[2].size(), 4);
+    ASSERT_DOUBLE_EQ(trap.axis[0][GRID_POINTS / 2 + 2], 0.5);
+    ASSERT_DOUBLE_EQ(trap.axis[1][GRID_POINTS / 4 + 2], 2.0);
+    ASSERT_DOUBLE_EQ(trap.axis[2][0], 4.5);
+}
+
+TEST(SeparableTrapTest, TestPropagatorMatchesTrap)
+{
+    Grid2D grid{{GRID_POINTS, GRID_POINTS}, {GRID_SPACING, GRID_SPACING}};
+    SeparableTrap trap = harmonicTrap(grid, {1.0, 1.0});
+    std::complex<double> timeStep{1e-2, 0.0};
+    TrapPropagator propagator{trap, grid, timeStep};
+
+    ASSERT_EQ(propagator.timeStep(), timeStep);
+    ASSERT_EQ(propagator.axis(Axis::z).size(), 1);
+    for (int i = 0; i < GRID_POINTS; ++i)
+    {
+        auto expected = std::exp(std::complex<double>{0, -1} * timeStep *
+                                 trap.axis[0][i]);
+        ASSERT_NEAR(std::abs(propagator.axis(Axis::x)[i] - expected), 0.0,
+                    1e-15);
+    }
+}
+
+TEST(SeparableTrapTest, TestEmptyAxisPropagatorSpansGrid)
+{
+    Grid2D grid{{GRID_POINTS, GRID_POINTS / 2}, {GRID_SPACING, GRID_SPACING}};
+    SeparableTrap trap{};
+    trap.axis[0] = std::vector<double>(GRID_POINTS, 1.0);
+    TrapPropagator propagator{trap, grid, {1e-2, 0.0}};
+
+    ASSERT_EQ(propagator.axis(Axis::y).size(), GRID_POINTS / 2);
+    for (const auto& factor : propagator.axis(Axis::y))
+    {
+        ASSERT_EQ(factor, std::complex<double>{1.0});
+    }
+}
+
+TEST(SeparableTrapTest, TestMismatchedProfileThrows)
+{
+    Grid2D grid{{GRID_POINTS, GRID_POINTS}, {GRID_SPACING, GRID_SPACING}};
+    SeparableTrap trap{};
+    trap.axis[1] = std::vector<double>(GRID_POINTS / 2, 1.0);
+
+    ASSERT_THROW((TrapPropagator{trap, grid, {1e-2, 0.0}}),
+                 std::invalid_argument);
+}
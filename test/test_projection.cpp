@@ -0,0 +1,109 @@
+#include "projection.h"
+#include <gtest/gtest.h>
+
+constexpr auto X_POINTS = 16;
+constexpr auto Y_POINTS = 8;
+constexpr auto Z_POINTS = 12;
+constexpr auto X_SPACING = 0.5;
+constexpr auto Y_SPACING = 1.0;
+constexpr auto Z_SPACING = 0.75;
+
+class ProjectionTest : public ::testing::Test
+{
+public:
+    Grid3D grid{{X_POINTS, Y_POINTS, Z_POINTS},
+                {X_SPACING, Y_SPACING, Z_SPACING}};
+    Wavefunction3D wfn{grid};
+
+    void SetUp() override
+    {
+        complexVector_t initialState(X_POINTS * Y_POINTS * Z_POINTS);
+        for (int i = 0; i < initialState.size(); ++i)
+        {
+            double x = grid.xMesh()[i];
+            double y = grid.yMesh()[i];
+            double z = grid.zMesh()[i];
+            initialState[i] = std::polar(std::exp(-x * x - 0.2 * y * y -
+                                                  0.5 * z * z),
+                                         0.3 * x + z);
+        }
+        wfn.setComponent(initialState);
+    }
+};
+
+TEST_F(ProjectionTest, TestColumnDensityIntegratesEachAxis)
+{
+    std::array<double, 3> spacing{X_SPACING, Y_SPACING, Z_SPACING};
+    for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+        std::vector<double> projection = columnDensity(wfn, axis);
+        std::vector<double> expected(projection.size(), 0.0);
+        for (int i = 0; i < X_POINTS; ++i)
+        {
+            for (int j = 0; j < Y_POINTS; ++j)
+            {
+                for (int k = 0; k < Z_POINTS; ++k)
+                {
+                    auto index = k + Z_POINTS * (j + i * Y_POINTS);
+                    int pixel = axis == 0   ? k + j * Z_POINTS
+                                : axis == 1 ? k + i * Z_POINTS
+                                            : j + i * Y_POINTS;
+                    expected[pixel] +=
+                            std::norm(wfn.component()[index]) * spacing[axis];
+                }
+            }
+        }
+
+        for (int i = 0; i < projection.size(); ++i)
+        {
+            ASSERT_NEAR(projection[i], expected[i], 1e-12);
+        }
+    }
+}
+
+TEST_F(ProjectionTest, TestMomentumDensityPreservesAtomNumber)
+{
+    double atomNumber = 0;
+    for (const auto& value : wfn.component())
+    {
+        atomNumber += std::norm(value) * X_SPACING * Y_SPACING * Z_SPACING;
+    }
+
+    auto [xFourierSpacing, yFourierSpacing, zFourierSpacing] =
+            grid.fourierGridSpacing();
+    std::vector<double> projection = columnMomentumDensity(wfn, 2);
+    ASSERT_EQ(projection.size(), X_POINTS * Y_POINTS);
+
+    double momentumAtomNumber = 0;
+    for (const auto& value : projection)
+    {
+        momentumAtomNumber += value * xFourierSpacing * yFourierSpacing;
+    }
+    ASSERT_NEAR(momentumAtomNumber, atomNumber, 1e-10);
+}
+
+TEST_F(ProjectionTest, TestMomentumDensityCentredOnMeanMomentum)
+{
+    // A plane wave of momentum (2 dkx, -dky, 0) lands two pixels right of the
+    // centre along x and one pixel below it along y
+    auto [xFourierSpacing, yFourierSpacing, zFourierSpacing] =
+            grid.fourierGridSpacing();
+    complexVector_t planeWave(X_POINTS * Y_POINTS * Z_POINTS);
+    for (int i = 0; i < planeWave.size(); ++i)
+    {
+        planeWave[i] = std::polar(1.0, 2 * xFourierSpacing * grid.xMesh()[i] -
+                                               yFourierSpacing *
+                                                       grid.yMesh()[i]);
+    }
+    wfn.setComponent(planeWave);
+
+    std::vector<double> projection = columnMomentumDensity(wfn, 2);
+    auto peak = std::max_element(projection.begin(), projection.end()) -
+                projection.begin();
+    ASSERT_EQ(peak, (Y_POINTS / 2 - 1) + (X_POINTS / 2 + 2) * Y_POINTS);
+}
+
+TEST_F(ProjectionTest, TestInvalidAxisThrows)
+{
+    ASSERT_THROW(columnDensity(wfn, 3), std::invalid_argument);
+}
@@ -0,0 +1,90 @@
+#include "evolution.h"
+#include "projector.h"
+#include <gtest/gtest.h>
+
+constexpr auto X_POINTS = 16;
+constexpr auto Y_POINTS = 12;
+constexpr auto Z_POINTS = 10;
+constexpr auto GRID_SPACING = 0.5;
+constexpr auto CUTOFF = 3.5;
+
+// Fourier space vector with every mode filled
+complexVector_t filledModes(std::size_t size)
+{
+    complexVector_t modes(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        modes[i] = {1.0 + i, -0.5 * i};
+    }
+    return modes;
+}
+
+TEST(ProjectorTest, TestRowsMatchCutoff)
+{
+    std::tuple<unsigned int, unsigned int, unsigned int> points{
+            X_POINTS, Y_POINTS, Z_POINTS};
+    std::tuple<double, double, double> gridSpacing{GRID_SPACING, GRID_SPACING,
+                                                   GRID_SPACING};
+    Grid3D grid{points, gridSpacing};
+    Projector projector{grid, CUTOFF};
+    ASSERT_EQ(projector.numRows(), X_POINTS * Y_POINTS);
+    ASSERT_EQ(projector.rowLength(), Z_POINTS);
+
+    complexVector_t modes = filledModes(grid.wavenumber().size());
+    complexVector_t projected = modes;
+    projector.apply(projected);
+
+    std::size_t numModes = 0;
+    for (std::size_t i = 0; i < modes.size(); ++i)
+    {
+        if (grid.wavenumber()[i] < CUTOFF * CUTOFF)
+        {
+            ASSERT_EQ(projected[i], modes[i]);
+            ++numModes;
+        }
+        else
+        {
+            ASSERT_EQ(projected[i], std::complex<double>{});
+        }
+    }
+    ASSERT_EQ(projector.numModes(), numModes);
+    ASSERT_GT(numModes, 0);
+    ASSERT_LT(numModes, modes.size());
+}
+
+TEST(ProjectorTest, TestProjectedStepMatchesStepAndProjection)
+{
+    std::tuple<unsigned int, unsigned int> points{X_POINTS, Y_POINTS};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    Projector projector{grid, CUTOFF};
+    Parameters params{};
+    params.timeStep = std::complex<double>{1e-2, 0};
+
+    Wavefunction2D wfn{grid};
+    Wavefunction2D projectedWfn{grid};
+    wfn.fourierComponent() = filledModes(X_POINTS * Y_POINTS);
+    projectedWfn.fourierComponent() = wfn.fourierComponent();
+
+    fourierStep(wfn, params);
+    projector.apply(wfn.fourierComponent());
+    fourierStep(projectedWfn, params, projector);
+
+    for (int i = 0; i < X_POINTS * Y_POINTS; ++i)
+    {
+        ASSERT_EQ(projectedWfn.fourierComponent()[i], wfn.fourierComponent()[i]);
+    }
+}
+
+TEST(ProjectorTest, TestProjectorOfAnotherGridThrows)
+{
+    Grid1D grid{X_POINTS, GRID_SPACING};
+    Grid1D otherGrid{Y_POINTS, GRID_SPACING};
+    Projector projector{otherGrid, CUTOFF};
+    Wavefunction1D wfn{grid};
+    Parameters params{};
+
+    ASSERT_THROW(fourierStep(wfn, params, projector), std::invalid_argument);
+    ASSERT_THROW(projector.apply(wfn.fourierComponent()),
+                 std::invalid_argument);
+}
@@ -0,0 +1,200 @@
+#include "reader.h"
+#include <gtest/gtest.h>
+
+constexpr auto GRID_LENGTH = 8;
+constexpr auto GRID_SPACING = 0.5;
+constexpr auto NUM_SNAPSHOTS = 4;
+
+class DataReaderTest : public ::testing::Test
+{
+public:
+    std::tuple<unsigned int, unsigned int, unsigned int> points{
+            GRID_LENGTH, GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double, double> gridSpacing{GRID_SPACING, GRID_SPACING,
+                                                   GRID_SPACING};
+    Grid3D grid{points, gridSpacing};
+    Parameters params = parameters();
+
+    static Parameters parameters()
+    {
+        Parameters params{};
+        params.intStrength = 1.5;
+        params.numTimeSteps = 40;
+        params.timeStep = std::complex<double>{1e-2, 0};
+        return params;
+    }
+
+    static complexVector_t state(double value)
+    {
+        complexVector_t state(GRID_LENGTH * GRID_LENGTH * GRID_LENGTH);
+        for (int i = 0; i < state.size(); ++i)
+        {
+            state[i] = {value, 1.0 * i};
+        }
+        return state;
+    }
+
+    void SetUp() override
+    {
+        // One snapshot every 10 steps
+        DataOptions options{};
+        options.saveInterval = 10;
+        options.fields = {OutputField::wavefunction, OutputField::density};
+        DataManager3D dm{"3D_reader_test_file.h5", params, grid, options};
+        Wavefunction3D wfn{grid};
+        for (int i = 0; i < NUM_SNAPSHOTS; ++i)
+        {
+            complexVector_t saved = state(i);
+            wfn.setComponent(saved);
+            dm.saveWavefunctionData(wfn);
+        }
+    }
+};
+
+TEST_F(DataReaderTest, TestParametersAndGridRead)
+{
+    DataReader reader{"3D_reader_test_file.h5"};
+    Parameters readParams = reader.parameters();
+    ASSERT_EQ(readParams.intStrength, params.intStrength);
+    ASSERT_EQ(readParams.numTimeSteps, params.numTimeSteps);
+    ASSERT_EQ(readParams.timeStep, params.timeStep);
+
+    Grid3D readGrid = reader.grid3D();
+    ASSERT_EQ(readGrid.shape(), grid.shape());
+    ASSERT_EQ(readGrid.gridSpacing(), grid.gridSpacing());
+    ASSERT_EQ(reader.numSnapshots(), NUM_SNAPSHOTS);
+}
+
+TEST_F(DataReaderTest, TestSnapshotFoundByTime)
+{
+    DataReader reader{"3D_reader_test_file.h5"};
+    ASSERT_DOUBLE_EQ(reader.time(2), 0.2);
+    ASSERT_EQ(reader.snapshotIndex(0.21), 2);
+    ASSERT_EQ(reader.snapshotIndex(10.0), NUM_SNAPSHOTS - 1);
+}
+
+TEST_F(DataReaderTest, TestSavedCountReadDuringRun)
+{
+    // The run is still open, so its dataset holds the preallocated extent
+    DataManager3D dm{"3D_reader_live_test_file.h5", params, grid};
+    Wavefunction3D wfn{grid};
+    complexVector_t saved = state(1.0);
+    wfn.setComponent(saved);
+    dm.saveWavefunctionData(wfn);
+    dm.saveWavefunctionData(wfn);
+    dm.flush();
+
+    ASSERT_GT(dm.file.getDataSet("wavefunction").getDimensions()[0], 2);
+    DataReader reader{"3D_reader_live_test_file.h5"};
+    ASSERT_EQ(reader.numSnapshots(), 2);
+    ASSERT_EQ(reader.snapshotIndex(10.0), 1);
+}
+
+TEST_F(DataReaderTest, TestSnapshotReadIntoWavefunction)
+{
+    DataReader reader{"3D_reader_test_file.h5"};
+    Wavefunction3D wfn{grid};
+    reader.readSnapshot(2, wfn);
+
+    // The 3D DataManager saves the inverse transform of the Fourier state
+    Wavefunction3D expected{grid};
+    complexVector_t saved = state(2);
+    expected.setComponent(saved);
+    expected.ifft();
+    for (int i = 0; i < wfn.component().size(); ++i)
+    {
+        ASSERT_NEAR(std::abs(wfn.component()[i] - expected.component()[i]), 0,
+                    1e-12);
+    }
+}
+
+TEST_F(DataReaderTest, TestPlaneRead)
+{
+    DataReader reader{"3D_reader_test_file.h5"};
+    auto snapshot = reader.readSnapshot<std::complex<double>>("wavefunction", 1);
+    auto plane = reader.readPlane<std::complex<double>>("wavefunction", 1, 1, 3);
+    auto density = reader.readPlane<float>("density", 1, 1, 3);
+
+    ASSERT_EQ(plane.size(), GRID_LENGTH * GRID_LENGTH);
+    for (int i = 0; i < GRID_LENGTH; ++i)
+    {
+        for (int k = 0; k < GRID_LENGTH; ++k)
+        {
+            auto value = snapshot[k + GRID_LENGTH * (3 + i * GRID_LENGTH)];
+            ASSERT_EQ(plane[k + i * GRID_LENGTH], value);
+            ASSERT_FLOAT_EQ(density[k + i * GRID_LENGTH], std::norm(value));
+        }
+    }
+}
+
+TEST(DataReaderDeltaTest, TestDeltaEncodedSnapshotsRead)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    DataOptions options{};
+    options.keyframeInterval = 2;
+    {
+        DataManager1D dm{"1D_delta_reader_test_file.h5",
+                         DataReaderTest::parameters(), grid, options};
+        Wavefunction1D wfn{grid};
+        for (int i = 0; i < NUM_SNAPSHOTS; ++i)
+        {
+            complexVector_t saved(GRID_LENGTH, {1.0 + i, 0.5 * i});
+            wfn.setComponent(saved);
+            wfn.fft();
+            dm.saveWavefunctionData(wfn);
+        }
+    }
+
+    DataReader reader{"1D_delta_reader_test_file.h5"};
+    auto region = reader.readRegion<std::complex<double>>("wavefunction", 3,
+                                                          {2}, {4});
+    ASSERT_EQ(region.size(), 4);
+    for (const auto& value : region)
+    {
+        ASSERT_NEAR(std::abs(value - std::complex<double>{4.0, 1.5}), 0,
+                    1e-12);
+    }
+
+    Wavefunction1D wfn{grid};
+    reader.readSnapshot(1, wfn);
+    for (const auto& value : wfn.component())
+    {
+        ASSERT_NEAR(std::abs(value - std::complex<double>{2.0, 0.5}), 0,
+                    1e-12);
+    }
+}
+
+TEST(DataReaderEventTest, TestEventSnapshotTimesRead)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    DataOptions options{};
+    options.saveInterval = 10;
+    options.ringBufferSnapshots = 2;
+    options.postEventSnapshots = 1;
+    {
+        DataManager1D dm{"1D_event_reader_test_file.h5",
+                         DataReaderTest::parameters(), grid, options};
+        Wavefunction1D wfn{grid};
+        complexVector_t saved(GRID_LENGTH, 1.0);
+        wfn.setComponent(saved);
+        for (int step = 0; step < 8; ++step)
+        {
+            dm.bufferWavefunctionData(wfn, 0.1 * step);
+            if (step == 4)
+            {
+                dm.triggerEvent(0.4);
+            }
+        }
+    }
+
+    // Snapshots of steps 3, 4 and 5, not one every saveInterval from zero
+    DataReader reader{"1D_event_reader_test_file.h5"};
+    ASSERT_EQ(reader.numSnapshots(), 3);
+    ASSERT_DOUBLE_EQ(reader.time(0), 0.3);
+    ASSERT_DOUBLE_EQ(reader.time(2), 0.5);
+    ASSERT_THROW(static_cast<void>(reader.time(3)), std::out_of_range);
+    ASSERT_EQ(reader.snapshotIndex(0.0), 0);
+    ASSERT_EQ(reader.snapshotIndex(0.42), 1);
+    ASSERT_EQ(reader.snapshotIndex(0.48), 2);
+    ASSERT_EQ(reader.snapshotIndex(10.0), 2);
+}
@@ -0,0 +1,105 @@
+#include "spectral.h"
+#include <gtest/gtest.h>
+
+constexpr auto COARSE_POINTS = 16;
+constexpr auto FINE_POINTS = 32;
+constexpr auto GRID_LENGTH = 8.0;
+
+std::complex<double> planeWave(double x, double y, double z)
+{
+    return std::exp(2 * PI * std::complex<double>{0, 1} *
+                    (3 * x + 2 * y - z) / GRID_LENGTH);
+}
+
+TEST(ResampleFourierTest, UpsamplingPreservesBandLimitedState)
+{
+    Grid1D coarseGrid{COARSE_POINTS, GRID_LENGTH / COARSE_POINTS};
+    Grid1D fineGrid{FINE_POINTS, GRID_LENGTH / FINE_POINTS};
+    Wavefunction1D coarse{coarseGrid};
+    Wavefunction1D fine{fineGrid};
+
+    complexVector_t initialState(COARSE_POINTS);
+    for (int i = 0; i < COARSE_POINTS; ++i)
+    {
+        initialState[i] = planeWave(coarseGrid.xMesh()[i], 0, 0);
+    }
+    coarse.setComponent(initialState);
+
+    resampleFourier(coarse.fourierComponent(), COARSE_POINTS,
+                    fine.fourierComponent(), FINE_POINTS);
+    fine.ifft();
+
+    for (int i = 0; i < FINE_POINTS; ++i)
+    {
+        auto expected = planeWave(fineGrid.xMesh()[i], 0, 0);
+        ASSERT_NEAR(std::abs(fine.component()[i] - expected), 0.0, 1e-12);
+    }
+}
+
+TEST(ResampleFourierTest, AnisotropicDownsamplingPreservesBandLimitedState)
+{
+    std::tuple<unsigned int, unsigned int, unsigned int> finePoints{
+            FINE_POINTS, COARSE_POINTS, FINE_POINTS};
+    std::tuple<unsigned int, unsigned int, unsigned int> coarsePoints{
+            COARSE_POINTS, COARSE_POINTS, FINE_POINTS / 4};
+    Grid3D fineGrid{finePoints,
+                    {GRID_LENGTH / FINE_POINTS, GRID_LENGTH / COARSE_POINTS,
+                     GRID_LENGTH / FINE_POINTS}};
+    Grid3D coarseGrid{coarsePoints,
+                      {GRID_LENGTH / COARSE_POINTS, GRID_LENGTH / COARSE_POINTS,
+                       4 * GRID_LENGTH / FINE_POINTS}};
+    Wavefunction3D fine{fineGrid};
+    Wavefunction3D coarse{coarseGrid};
+
+    complexVector_t initialState(FINE_POINTS * COARSE_POINTS * FINE_POINTS);
+    for (int i = 0; i < initialState.size(); ++i)
+    {
+        initialState[i] = planeWave(fineGrid.xMesh()[i], fineGrid.yMesh()[i],
+                                    fineGrid.zMesh()[i]);
+    }
+    fine.setComponent(initialState);
+
+    resampleFourier(fine.fourierComponent(), finePoints,
+                    coarse.fourierComponent(), coarsePoints);
+    coarse.ifft();
+
+    for (int i = 0; i < coarse.component().size(); ++i)
+    {
+        auto expected = planeWave(coarseGrid.xMesh()[i], coarseGrid.yMesh()[i],
+                                  coarseGrid.zMesh()[i]);
+        ASSERT_NEAR(std::abs(coarse.component()[i] - expected), 0.0, 1e-12);
+    }
+}
+
+TEST(SpectralDownsamplerTest, DownsamplingKeepsBandLimitedState)
+{
+    Grid2D fineGrid{{FINE_POINTS, FINE_POINTS},
+                    {GRID_LENGTH / FINE_POINTS, GRID_LENGTH / FINE_POINTS}};
+    Wavefunction2D fine{fineGrid};
+
+    complexVector_t initialState(FINE_POINTS * FINE_POINTS);
+    for (int i = 0; i < initialState.size(); ++i)
+    {
+        initialState[i] = planeWave(fineGrid.xMesh()[i], fineGrid.yMesh()[i],
+                                    0);
+    }
+    fine.setComponent(initialState);
+
+    SpectralDownsampler2D downsampler{fineGrid, FINE_POINTS / COARSE_POINTS};
+    Grid2D coarseGrid = downsampler.grid();
+    auto [xPoints, yPoints] = coarseGrid.shape();
+    auto [xGridSpacing, yGridSpacing] = coarseGrid.gridSpacing();
+    ASSERT_EQ(xPoints, COARSE_POINTS);
+    ASSERT_EQ(yPoints, COARSE_POINTS);
+    ASSERT_DOUBLE_EQ(xGridSpacing, GRID_LENGTH / COARSE_POINTS);
+    ASSERT_DOUBLE_EQ(yGridSpacing, GRID_LENGTH / COARSE_POINTS);
+
+    const complexVector_t& coarse = downsampler.downsample(fine, false);
+    ASSERT_EQ(coarse.size(), COARSE_POINTS * COARSE_POINTS);
+    for (int i = 0; i < coarse.size(); ++i)
+    {
+        auto expected = planeWave(coarseGrid.xMesh()[i], coarseGrid.yMesh()[i],
+                                  0);
+        ASSERT_NEAR(std::abs(coarse[i] - expected), 0.0, 1e-12);
+    }
+}
@@ -0,0 +1,222 @@
+#include "stochastic.h"
+#include <gtest/gtest.h>
+
+constexpr auto GRID_LENGTH = 16;
+constexpr auto GRID_SPACING = 0.5;
+
+std::complex<double> gaussianState(double x)
+{
+    return std::exp(-x * x / 4.0) * std::exp(std::complex<double>{0, 0.5 * x});
+}
+
+TEST(StochasticTest, TestUndampedStepMatchesGPE)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Parameters params{};
+    params.intStrength = 2.0;
+    params.timeStep = std::complex<double>{1e-2, 0};
+    complexVector_t state(GRID_LENGTH);
+    for (int i = 0; i < GRID_LENGTH; ++i)
+    {
+        double x = grid.xMesh()[i];
+        state[i] = gaussianState(x);
+        params.trap.push_back(0.5 * x * x);
+    }
+
+    Wavefunction1D gpe{grid};
+    gpe.setComponent(state);
+    Wavefunction1D spgpe{grid};
+    spgpe.setComponent(state);
+    Reservoir reservoir{};
+
+    for (std::uint64_t step = 0; step < 3; ++step)
+    {
+        fourierStep(gpe, params);
+        gpe.ifft();
+        interactionStep(gpe, params);
+        gpe.fft();
+        fourierStep(gpe, params);
+
+        fourierStep(spgpe, params, reservoir);
+        spgpe.ifft();
+        interactionStep(spgpe, params, reservoir, step);
+        spgpe.fft();
+        fourierStep(spgpe, params, reservoir);
+    }
+    gpe.ifft();
+    spgpe.ifft();
+
+    for (int i = 0; i < GRID_LENGTH; ++i)
+    {
+        ASSERT_NEAR(std::abs(spgpe.component()[i] - gpe.component()[i]), 0,
+                    1e-12);
+    }
+}
+
+TEST(StochasticTest, TestDampingRelaxesToChemicalPotential)
+{
+    // A uniform condensate in the damped GPE relaxes to g n = mu
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Parameters params{};
+    params.intStrength = 1.0;
+    params.timeStep = std::complex<double>{1e-2, 0};
+    params.trap = std::vector<double>(GRID_LENGTH, 0.0);
+    complexVector_t state(GRID_LENGTH, 0.5);
+
+    Wavefunction1D wfn{grid};
+    wfn.setComponent(state);
+    Reservoir reservoir{};
+    reservoir.damping = 0.5;
+    reservoir.chemicalPotential = 2.0;
+
+    for (std::uint64_t step = 0; step < 2000; ++step)
+    {
+        fourierStep(wfn, params, reservoir);
+        wfn.ifft();
+        interactionStep(wfn, params, reservoir, step);
+        wfn.fft();
+        fourierStep(wfn, params, reservoir);
+    }
+    wfn.ifft();
+
+    for (const auto& value : wfn.component())
+    {
+        ASSERT_NEAR(params.intStrength * std::norm(value),
+                    reservoir.chemicalPotential, 1e-6);
+    }
+}
+
+TEST(StochasticTest, TestProjectorRemovesHighModes)
+{
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    Parameters params{};
+    params.timeStep = std::complex<double>{1e-2, 0};
+    params.trap = std::vector<double>(GRID_LENGTH * GRID_LENGTH, 0.0);
+
+    Wavefunction2D wfn{grid};
+    Reservoir reservoir{};
+    reservoir.damping = 0.1;
+    reservoir.temperature = 1.0;
+    reservoir.chemicalPotential = -1.0;
+    reservoir.seed = 42;
+    Projector projector{grid, 3.0};
+
+    fourierStep(wfn, params, reservoir, projector);
+    wfn.ifft();
+    interactionStep(wfn, params, reservoir, 0);
+    wfn.fft();
+    fourierStep(wfn, params, reservoir, projector);
+
+    int numProjected = 0;
+    for (int i = 0; i < GRID_LENGTH * GRID_LENGTH; ++i)
+    {
+        if (grid.wavenumber()[i] >= projector.cutoff() * projector.cutoff())
+        {
+            ASSERT_EQ(wfn.fourierComponent()[i], std::complex<double>{});
+        }
+        else
+        {
+            ASSERT_NE(wfn.fourierComponent()[i], std::complex<double>{});
+            ++numProjected;
+        }
+    }
+    ASSERT_GT(numProjected, 0);
+}
+
+TEST(StochasticTest, TestEnsembleMatchesSingleRealisation)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Parameters params{};
+    params.intStrength = 1.0;
+    params.timeStep = std::complex<double>{1e-2, 0};
+    params.trap = std::vector<double>(GRID_LENGTH, 0.0);
+    Reservoir reservoir{};
+    reservoir.damping = 0.1;
+    reservoir.temperature = 2.0;
+    reservoir.seed = 7;
+    reservoir.stream = 10;
+
+    // Realisation 1 of the ensemble evolves with the noise of stream 11
+    EnsembleWavefunction1D ensemble{grid, 2};
+    Wavefunction1D wfn{grid};
+    Reservoir single = reservoir;
+    single.stream = 11;
+    for (std::uint64_t step = 0; step < 3; ++step)
+    {
+        fourierStep(ensemble, params, reservoir);
+        ensemble.ifft();
+        interactionStep(ensemble, params, reservoir, step);
+        ensemble.fft();
+        fourierStep(ensemble, params, reservoir);
+
+        fourierStep(wfn, params, single);
+        wfn.ifft();
+        interactionStep(wfn, params, single, step);
+        wfn.fft();
+        fourierStep(wfn, params, single);
+    }
+    ensemble.ifft();
+    wfn.ifft();
+
+    complexVector_t realisation = ensemble.realisation(1);
+    for (int i = 0; i < GRID_LENGTH; ++i)
+    {
+        ASSERT_NEAR(std::abs(realisation[i] - wfn.component()[i]), 0, 1e-14);
+    }
+}
+
+TEST(StochasticTest, TestIdealGasThermalises)
+{
+    // Without interactions, every projected mode relaxes to the classical
+    // occupation T / (k^2 / 2 - mu)
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Parameters params{};
+    params.timeStep = std::complex<double>{2e-2, 0};
+    params.trap = std::vector<double>(GRID_LENGTH, 0.0);
+    Reservoir reservoir{};
+    reservoir.damping = 0.5;
+    reservoir.temperature = 1.0;
+    reservoir.chemicalPotential = -0.5;
+    reservoir.seed = 2024;
+    Projector projector{grid, 2.0};
+
+    constexpr int numRealisations = 400;
+    EnsembleWavefunction1D ensemble{grid, numRealisations};
+    for (std::uint64_t step = 0; step < 1000; ++step)
+    {
+        fourierStep(ensemble, params, reservoir, projector);
+        ensemble.ifft();
+        interactionStep(ensemble, params, reservoir, step);
+        ensemble.fft();
+        fourierStep(ensemble, params, reservoir, projector);
+    }
+    ensemble.ifft();
+
+    double expected{};
+    for (double wavenumber : grid.wavenumber())
+    {
+        if (wavenumber < projector.cutoff() * projector.cutoff())
+        {
+            expected += reservoir.temperature /
+                        (0.5 * wavenumber - reservoir.chemicalPotential);
+        }
+    }
+    ASSERT_NEAR(ensemble.meanAtomNumber(), expected, 0.06 * expected);
+}
+
+TEST(StochasticTest, TestMismatchedTrapThrows)
+{
+    Grid1D grid{GRID_LENGTH, GRID_SPACING};
+    Wavefunction1D wfn{grid};
+    EnsembleWavefunction1D ensemble{grid, 2};
+    Parameters params{};
+    params.trap.resize(GRID_LENGTH / 2);
+    Reservoir reservoir{};
+
+    ASSERT_THROW(interactionStep(wfn, params, reservoir, 0),
+                 std::invalid_argument);
+    ASSERT_THROW(interactionStep(ensemble, params, reservoir, 0),
+                 std::invalid_argument);
+}
@@ -0,0 +1,132 @@
+#include "reader.h"
+#include "stream.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+constexpr auto GRID_LENGTH = 16;
+constexpr auto GRID_SPACING = 0.5;
+
+class RawDataManagerTest : public ::testing::Test
+{
+public:
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    Parameters params = parameters();
+
+    static Parameters parameters()
+    {
+        Parameters params{};
+        params.intStrength = 1.0;
+        params.numTimeSteps = 2;
+        params.timeStep = std::complex<double>{1e-2, 0};
+        return params;
+    }
+
+    static complexVector_t state(double value)
+    {
+        complexVector_t state(GRID_LENGTH * GRID_LENGTH);
+        for (int i = 0; i < state.size(); ++i)
+        {
+            state[i] = {value, 0.01 * i};
+        }
+        return state;
+    }
+
+    // Saves more snapshots than were preallocated, forcing the file to grow
+    void saveSnapshots(const std::string& filename, int numSnapshots)
+    {
+        RawDataManager2D dm{filename, params, grid};
+        Wavefunction2D wfn{grid};
+        for (int i = 0; i < numSnapshots; ++i)
+        {
+            complexVector_t saved = state(i);
+            wfn.setComponent(saved);
+            dm.saveWavefunctionData(wfn, 0.1 * i);
+        }
+        ASSERT_EQ(dm.numSnapshots(), numSnapshots);
+    }
+};
+
+TEST_F(RawDataManagerTest, TestIndexWritten)
+{
+    saveSnapshots("2D_raw_test_file.raw", 5);
+
+    RawSnapshotIndex index = readRawSnapshotIndex("2D_raw_test_file.raw");
+    std::vector<std::size_t> expectedShape{GRID_LENGTH, GRID_LENGTH};
+    ASSERT_EQ(index.shape, expectedShape);
+    ASSERT_EQ(index.gridSpacing[1], GRID_SPACING);
+    ASSERT_EQ(index.timeStep, params.timeStep);
+    ASSERT_EQ(index.snapshotBytes,
+              GRID_LENGTH * GRID_LENGTH * sizeof(std::complex<double>));
+    ASSERT_EQ(index.stride % sysconf(_SC_PAGESIZE), 0);
+    ASSERT_EQ(index.offsets.size(), 5);
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_EQ(index.offsets[i], i * index.stride);
+        ASSERT_DOUBLE_EQ(index.times[i], 0.1 * i);
+    }
+}
+
+TEST_F(RawDataManagerTest, TestSnapshotsSaved)
+{
+    saveSnapshots("2D_raw_test_file.raw", 5);
+    RawSnapshotIndex index = readRawSnapshotIndex("2D_raw_test_file.raw");
+
+    std::ifstream in{"2D_raw_test_file.raw", std::ios::binary};
+    complexVector_t loaded(GRID_LENGTH * GRID_LENGTH);
+    for (int i = 0; i < 5; ++i)
+    {
+        in.seekg(index.offsets[i]);
+        in.read(reinterpret_cast<char*>(loaded.data()), index.snapshotBytes);
+        ASSERT_EQ(loaded, state(i));
+    }
+}
+
+TEST_F(RawDataManagerTest, TestConvertedToHDF5)
+{
+    saveSnapshots("2D_raw_test_file.raw", 3);
+    convertRawToHDF5("2D_raw_test_file.raw", "2D_converted_test_file.h5");
+
+    HighFive::File file{"2D_converted_test_file.h5",
+                        HighFive::File::ReadOnly};
+    ASSERT_TRUE(file.exist("parameters/intStrength"));
+    ASSERT_TRUE(file.exist("grid/yGridSpacing"));
+    auto wfnDataSet = file.getDataSet("wavefunction");
+    std::vector<std::size_t> expectedDims{3, GRID_LENGTH, GRID_LENGTH};
+    ASSERT_EQ(wfnDataSet.getDimensions(), expectedDims);
+
+    std::vector<std::complex<double>> loaded(GRID_LENGTH * GRID_LENGTH);
+    wfnDataSet.select({2, 0, 0}, {1, GRID_LENGTH, GRID_LENGTH})
+            .read(loaded.data());
+    ASSERT_EQ(loaded, state(2));
+
+    std::vector<double> snapshotTime;
+    file.getDataSet("/timeseries/snapshotTime").read(snapshotTime);
+    ASSERT_EQ(snapshotTime.size(), 3);
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_DOUBLE_EQ(snapshotTime[i], 0.1 * i);
+    }
+}
+
+TEST_F(RawDataManagerTest, TestDeltaEncodedConversionRead)
+{
+    saveSnapshots("2D_raw_delta_test_file.raw", 5);
+    DataOptions options{};
+    options.keyframeInterval = 2;
+    convertRawToHDF5("2D_raw_delta_test_file.raw",
+                     "2D_converted_delta_test_file.h5", options);
+
+    // The snapshots are decoded from their XOR deltas, not read as stored
+    DataReader reader{"2D_converted_delta_test_file.h5"};
+    ASSERT_EQ(reader.numSnapshots(), 5);
+    ASSERT_DOUBLE_EQ(reader.time(3), 0.3);
+    Wavefunction2D wfn{grid};
+    for (int i = 0; i < 5; ++i)
+    {
+        reader.readSnapshot(i, wfn);
+        ASSERT_EQ(wfn.component(), state(i));
+    }
+}
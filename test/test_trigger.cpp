@@ -0,0 +1,36 @@
+#include "trigger.h"
+#include <gtest/gtest.h>
+
+TEST(ThresholdTriggerTest, TestFiresOnCrossingInEitherDirection)
+{
+    ThresholdTrigger trigger{1.0};
+
+    ASSERT_FALSE(trigger.update(2.0));
+    ASSERT_FALSE(trigger.update(1.5));
+    ASSERT_TRUE(trigger.update(0.5));
+    ASSERT_FALSE(trigger.update(0.2));
+    ASSERT_TRUE(trigger.update(1.0));
+}
+
+TEST(ThresholdTriggerTest, TestFiresOnlyInGivenDirection)
+{
+    ThresholdTrigger rising{1.0, Crossing::rising};
+    ThresholdTrigger falling{1.0, Crossing::falling};
+
+    ASSERT_FALSE(rising.update(0.5));
+    ASSERT_FALSE(falling.update(0.5));
+    ASSERT_TRUE(rising.update(1.5));
+    ASSERT_FALSE(falling.update(1.5));
+    ASSERT_FALSE(rising.update(0.5));
+    ASSERT_TRUE(falling.update(0.5));
+}
+
+TEST(ChangeTriggerTest, TestFiresWhenValueChanges)
+{
+    ChangeTrigger trigger;
+
+    ASSERT_FALSE(trigger.update(4));
+    ASSERT_FALSE(trigger.update(4));
+    ASSERT_TRUE(trigger.update(2));
+    ASSERT_FALSE(trigger.update(2));
+}
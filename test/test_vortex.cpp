@@ -0,0 +1,223 @@
+#include "vortex.h"
+#include <gtest/gtest.h>
+
+constexpr auto GRID_LENGTH = 32;
+constexpr auto GRID_SPACING = 0.5;
+
+// Winding number of the phase around the rectangle of grid points
+// [iMin, iMax] x [jMin, jMax] of a vector of rows of length rowLength,
+// traversed anticlockwise in the (x, y) plane
+int windingNumber(const complexVector_t& component, int rowLength, int iMin,
+                  int iMax, int jMin, int jMax)
+{
+    std::vector<std::pair<int, int>> loop;
+    for (int i = iMin; i < iMax; ++i)
+    {
+        loop.emplace_back(i, jMin);
+    }
+    for (int j = jMin; j < jMax; ++j)
+    {
+        loop.emplace_back(iMax, j);
+    }
+    for (int i = iMax; i > iMin; --i)
+    {
+        loop.emplace_back(i, jMax);
+    }
+    for (int j = jMax; j > jMin; --j)
+    {
+        loop.emplace_back(iMin, j);
+    }
+
+    double winding = 0.0;
+    for (std::size_t n = 0; n < loop.size(); ++n)
+    {
+        auto [i, j] = loop[n];
+        auto [iNext, jNext] = loop[(n + 1) % loop.size()];
+        winding += std::arg(component[jNext + rowLength * iNext] /
+                            component[j + rowLength * i]);
+    }
+    return static_cast<int>(std::lround(winding / (2 * PI)));
+}
+
+class VortexTest : public ::testing::Test
+{
+public:
+    std::tuple<unsigned int, unsigned int> points{GRID_LENGTH, GRID_LENGTH};
+    std::tuple<double, double> gridSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D grid{points, gridSpacing};
+    Wavefunction2D wfn{grid};
+
+    void SetUp() override
+    {
+        complexVector_t uniform(GRID_LENGTH * GRID_LENGTH, 1.0);
+        wfn.setComponent(uniform);
+    }
+};
+
+TEST_F(VortexTest, TestDipoleWindings)
+{
+    // Cores between grid points, at grid indices (10.5, 12.5) and (20.5, 18.5)
+    std::vector<Vortex> vortices{{-2.75, -1.75, 1}, {2.25, 1.25, -1}};
+    imprintVortices(wfn, vortices);
+
+    ASSERT_EQ(windingNumber(wfn.component(), GRID_LENGTH, 10, 11, 12, 13), 1);
+    ASSERT_EQ(windingNumber(wfn.component(), GRID_LENGTH, 20, 21, 18, 19), -1);
+    ASSERT_EQ(windingNumber(wfn.component(), GRID_LENGTH, 4, 8, 4, 8), 0);
+    ASSERT_EQ(windingNumber(wfn.component(), GRID_LENGTH, 5, 25, 5, 25), 0);
+    for (const auto& value : wfn.component())
+    {
+        ASSERT_NEAR(std::abs(value), 1.0, 1e-12);
+    }
+}
+
+TEST_F(VortexTest, TestPhaseContinuousAcrossBoundaries)
+{
+    std::vector<Vortex> vortices = randomVortices(grid, 6, 3.0, 11);
+    imprintVortices(wfn, vortices);
+
+    // Steps across the boundaries are as small as steps inside the box
+    for (int n = 0; n < GRID_LENGTH; ++n)
+    {
+        auto& component = wfn.component();
+        double xStep = std::arg(component[n + GRID_LENGTH * (GRID_LENGTH - 1)] /
+                                component[n]);
+        double yStep = std::arg(component[GRID_LENGTH - 1 + GRID_LENGTH * n] /
+                                component[GRID_LENGTH * n]);
+        ASSERT_LT(std::abs(xStep), 1.0);
+        ASSERT_LT(std::abs(yStep), 1.0);
+    }
+}
+
+TEST_F(VortexTest, TestBlocksOfVorticesCompose)
+{
+    // More vortices than fit in one block of image tables
+    std::vector<Vortex> vortices = randomVortices(grid, 150, 0.3, 5);
+    imprintVortices(wfn, vortices);
+
+    Wavefunction2D separateWfn{grid};
+    complexVector_t uniform(GRID_LENGTH * GRID_LENGTH, 1.0);
+    separateWfn.setComponent(uniform);
+    for (std::size_t first = 0; first < vortices.size(); first += 2)
+    {
+        imprintVortices(separateWfn, {vortices[first], vortices[first + 1]});
+    }
+
+    for (int i = 0; i < GRID_LENGTH * GRID_LENGTH; ++i)
+    {
+        ASSERT_NEAR(std::abs(wfn.component()[i] - separateWfn.component()[i]),
+                    0, 1e-9);
+    }
+}
+
+TEST_F(VortexTest, TestRandomVorticesSeparated)
+{
+    constexpr double minSeparation = 1.5;
+    std::vector<Vortex> vortices = randomVortices(grid, 40, minSeparation, 3);
+    ASSERT_EQ(vortices.size(), 40);
+
+    int totalCharge = 0;
+    double length = GRID_LENGTH * GRID_SPACING;
+    for (std::size_t n = 0; n < vortices.size(); ++n)
+    {
+        totalCharge += vortices[n].charge;
+        ASSERT_GE(vortices[n].x, -0.5 * length);
+        ASSERT_LT(vortices[n].x, 0.5 * length);
+        for (std::size_t m = 0; m < n; ++m)
+        {
+            double dx = std::abs(vortices[n].x - vortices[m].x);
+            double dy = std::abs(vortices[n].y - vortices[m].y);
+            dx = std::min(dx, length - dx);
+            dy = std::min(dy, length - dy);
+            ASSERT_GE(std::hypot(dx, dy), minSeparation);
+        }
+    }
+    ASSERT_EQ(totalCharge, 0);
+
+    // The sampling is reproducible for a given seed
+    std::vector<Vortex> repeated = randomVortices(grid, 40, minSeparation, 3);
+    for (std::size_t n = 0; n < vortices.size(); ++n)
+    {
+        ASSERT_EQ(repeated[n].x, vortices[n].x);
+        ASSERT_EQ(repeated[n].y, vortices[n].y);
+    }
+}
+
+TEST_F(VortexTest, TestInvalidVorticesThrow)
+{
+    ASSERT_THROW(static_cast<void>(randomVortices(grid, 3, 1.0, 0)),
+                 std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(randomVortices(grid, 1000, 4.0, 0, 10000)),
+                 std::runtime_error);
+    ASSERT_THROW(imprintVortices(wfn, {{0.0, 0.0, 1}}), std::invalid_argument);
+}
+
+TEST(Vortex3DTest, TestLinesMatchPlanarPhase)
+{
+    constexpr int zPoints = 4;
+    std::tuple<unsigned int, unsigned int> planePoints{GRID_LENGTH,
+                                                       GRID_LENGTH};
+    std::tuple<double, double> planeSpacing{GRID_SPACING, GRID_SPACING};
+    Grid2D planeGrid{planePoints, planeSpacing};
+    Wavefunction2D planeWfn{planeGrid};
+    complexVector_t planeState(GRID_LENGTH * GRID_LENGTH, 1.0);
+    planeWfn.setComponent(planeState);
+
+    std::tuple<unsigned int, unsigned int, unsigned int> points{
+            GRID_LENGTH, GRID_LENGTH, zPoints};
+    std::tuple<double, double, double> gridSpacing{GRID_SPACING, GRID_SPACING,
+                                                   GRID_SPACING};
+    Grid3D grid{points, gridSpacing};
+    Wavefunction3D wfn{grid};
+    complexVector_t state(GRID_LENGTH * GRID_LENGTH * zPoints, 1.0);
+    wfn.setComponent(state);
+
+    std::vector<Vortex> vortices = randomVortices(grid, 4, 2.0, 8);
+    imprintVortices(planeWfn, vortices);
+    imprintVortices(wfn, vortices);
+
+    for (int n = 0; n < GRID_LENGTH * GRID_LENGTH; ++n)
+    {
+        for (int k = 0; k < zPoints; ++k)
+        {
+            ASSERT_EQ(wfn.component()[k + zPoints * n],
+                      planeWfn.component()[n]);
+        }
+    }
+}
+
+TEST(Vortex3DTest, TestRingWinding)
+{
+    constexpr int points1D = 16;
+    std::tuple<unsigned int, unsigned int, unsigned int> points{
+            points1D, points1D, points1D};
+    std::tuple<double, double, double> gridSpacing{GRID_SPACING, GRID_SPACING,
+                                                   GRID_SPACING};
+    Grid3D grid{points, gridSpacing};
+    Wavefunction3D wfn{grid};
+    complexVector_t state(points1D * points1D * points1D, 1.0);
+    wfn.setComponent(state);
+
+    // Ring of radius 2 centred between grid points, so its core in the
+    // (x, z) plane through y = 0.25 lies between points
+    VortexRing ring{0.25, 0.25, 0.25, 2.0, 1};
+    imprintVortexRings(wfn, {ring});
+
+    // The plane j = 8 holds y = 0, close to the centre, and its (x, z) points
+    // are rows of length points1D along z
+    complexVector_t plane(points1D * points1D);
+    for (int i = 0; i < points1D; ++i)
+    {
+        for (int k = 0; k < points1D; ++k)
+        {
+            plane[k + points1D * i] =
+                    wfn.component()[k + points1D * (8 + points1D * i)];
+        }
+    }
+
+    // The core crosses the plane near x = 2.25 and x = -1.75, i.e. between
+    // points 12 and 13, and between points 4 and 5, at z = 0.25. On the
+    // positive x side the (x, z) plane is the (rho, z) half plane.
+    ASSERT_EQ(windingNumber(plane, points1D, 12, 13, 8, 9), 1);
+    ASSERT_EQ(windingNumber(plane, points1D, 4, 5, 8, 9), -1);
+    ASSERT_EQ(windingNumber(plane, points1D, 1, 3, 1, 3), 0);
+}